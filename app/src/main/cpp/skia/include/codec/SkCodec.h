@@ -30,6 +30,7 @@
 #include <vector>
 
 class SkData;
+class SkExecutor;
 class SkFrameHolder;
 class SkImage;
 class SkPngChunkReader;
@@ -334,6 +335,7 @@ public:
             , fSubset(nullptr)
             , fFrameIndex(0)
             , fPriorFrame(kNoFrame)
+            , fExecutor(nullptr)
         {}
 
         ZeroInitialized            fZeroInitialized;
@@ -377,6 +379,15 @@ public:
          *  If set to kNoFrame, the codec will decode any necessary required frame(s) first.
          */
         int                        fPriorFrame;
+
+        /**
+         *  If not NULL, codecs that can split a decode into independent pieces may run
+         *  those pieces on this executor. getPixels() still blocks until the whole image
+         *  has been decoded, and the result is identical to a serial decode.
+         *
+         *  Currently only used by JPEG images that contain restart markers.
+         */
+        SkExecutor*                fExecutor;
     };
 
     /**
@@ -999,7 +1010,7 @@ private:
         kPalette_XformTime,
         kDecodeRow_XformTime,
     };
-    XformTime                          fXformTime;
+    XformTime                          fXformTime = kNo_XformTime;
     XformFormat                        fDstXformFormat; // Based on fDstInfo.
     skcms_ICCProfile                   fDstProfileStorage;
     // This tracks either fDstProfileStorage or the ICC profile in fEncodedInfo.
@@ -1008,6 +1019,9 @@ private:
     // transformation.
     const skcms_ICCProfile*            fDstProfile = &fDstProfileStorage;
     skcms_AlphaFormat                  fDstXformAlphaFormat;
+    // Compiled from the fields above whenever they change, so that applyColorXform() doesn't
+    // plan the transform again for every row.
+    std::shared_ptr<const skcms_CompiledTransform> fColorXform;
 
     // Only meaningful during scanline decodes.
     int fCurrScanline = -1;
@@ -1019,6 +1033,7 @@ private:
     bool fUsingCallbackForHandleFrameIndex = false;
 
     bool initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Alpha, bool srcIsOpaque);
+    void compileColorXform();
 
     /**
      *  Return whether these dimensions are supported as a scale.
@@ -16,6 +16,7 @@
 #include <memory>
 
 class SkData;
+class SkExecutor;
 class SkImageGenerator;
 class SkOpenTypeSVGDecoder;
 class SkTraceMemoryDump;
@@ -126,6 +127,56 @@ public:
     static size_t GetResourceCacheSingleAllocationByteLimit();
     static size_t SetResourceCacheSingleAllocationByteLimit(size_t newLimit);
 
+    /**
+     *  When an image filter applied while drawing would need more than this many bytes for its
+     *  intermediate images, it is evaluated in tiles that each stay within this budget. Only the
+     *  filter's final output is allocated at full size. Filters whose output fills the layer, or
+     *  that read far outside the area they produce, are always evaluated in a single pass.
+     *
+     *  Zero is the default value, meaning image filters are evaluated in a single pass.
+     *  Set returns the previous budget.
+     */
+    static size_t GetImageFilterTileBudget();
+    static size_t SetImageFilterTileBudget(size_t bytes);
+
+    /**
+     *  If set, large blurs in image filters applied by the CPU backend are split into bands of
+     *  rows and strips of columns that run on this executor, and when an image filter is split
+     *  into tiles to fit the tile budget, several tiles are filtered on it at once. Large mipmap
+     *  levels of raster images are also generated on it in bands of rows. The output is the same
+     *  as without it.
+     *
+     *  Null is the default, meaning this work runs on the drawing thread. The executor must
+     *  outlive any drawing that uses it. Mipmaps in the resource cache that were created while it
+     *  was set keep generating levels on it, so call PurgeResourceCache() before destroying it.
+     *  Set returns the previous executor.
+     */
+    static SkExecutor* GetImageFilterExecutor();
+    static SkExecutor* SetImageFilterExecutor(SkExecutor*);
+
+    /**
+     *  If true, image filter blurs applied by the CPU backend whose sigmas are both above 20 are
+     *  computed at a reduced resolution and upsampled. This is several times faster, but the
+     *  result is an approximation: it can differ from the exact blur by a few units per 8-bit
+     *  channel.
+     *
+     *  False is the default. Set returns the previous value.
+     */
+    static bool GetImageFilterApproximateLargeBlurs();
+    static bool SetImageFilterApproximateLargeBlurs(bool);
+
+    /**
+     *  If true, the image filter cache identifies results by the parameters of the filter graph
+     *  that produced them rather than by the filter objects, so filters that are rebuilt every
+     *  frame with the same parameters reuse each other's results. Images, pictures and typefaces
+     *  in the graph are still compared by identity.
+     *
+     *  False is the default. Changing it purges the image filter cache. Set returns the previous
+     *  value.
+     */
+    static bool GetImageFilterCacheContentKeyed();
+    static bool SetImageFilterCacheContentKeyed(bool);
+
     /**
      *  Dumps memory usage of caches using the SkTraceMemoryDump interface. See SkTraceMemoryDump
      *  for usage of this method.
@@ -87,6 +87,15 @@ public:
         return this->getPixels(pm.info(), pm.writable_addr(), pm.rowBytes());
     }
 
+    /**
+     *  Return a size that approximately supports the desired scale factor, i.e. dimensions that
+     *  getPixels() can decode to directly. Generators that cannot scale return the dimensions of
+     *  getInfo().
+     */
+    SkISize getScaledDimensions(float desiredScale) const {
+        return this->onGetScaledDimensions(desiredScale);
+    }
+
     /**
      *  If decoding to YUV is supported, this returns true. Otherwise, this
      *  returns false and the caller will ignore output parameter yuvaPixmapInfo.
@@ -121,6 +130,7 @@ protected:
     virtual sk_sp<SkData> onRefEncodedData() { return nullptr; }
     struct Options {};
     virtual bool onGetPixels(const SkImageInfo&, void*, size_t, const Options&) { return false; }
+    virtual SkISize onGetScaledDimensions(float) const { return fInfo.dimensions(); }
     virtual bool onIsValid(SkRecorder*) const { return true; }
     virtual bool onIsProtected() const { return false; }
     virtual bool onQueryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes&,
@@ -178,6 +178,28 @@ struct Metadata {
     */
     SkExecutor* fExecutor = nullptr;
 
+    /** If true and fExecutor is set, each page is recorded as it is drawn
+        and rendered to PDF on the executor while the caller draws the
+        following pages. Pages are still written to the stream in order, and
+        their objects are numbered independently of how the work was
+        scheduled. Ignored for tagged PDFs (see fStructureElementTreeRoot),
+        whose pages are always rendered on the calling thread.
+
+        Experimental.
+    */
+    bool fConcurrentPageRendering = false;
+
+    /** If greater than zero, the fonts used so far are subset and written
+        out after every fFontSubsetCheckpointPages pages, instead of all at
+        once when the document is closed. Glyphs drawn after a checkpoint go
+        into new subsets, so this trades some file size for less work and
+        memory at close. Subsets with the same glyphs share one embedded font
+        program.
+
+        Experimental.
+    */
+    int fFontSubsetCheckpointPages = 0;
+
     /** PDF streams may be compressed to save space.
         Use this to specify the desired compression vs time tradeoff.
     */
@@ -189,6 +211,19 @@ struct Metadata {
         HighButSlow = 9,
     } fCompressionLevel = CompressionLevel::Default;
 
+    /** How compressed streams are deflated. kZlib_Deflater streams the data
+        through zlib and is the reference. kParallel_Deflater holds each stream
+        in memory and splits it into chunks that are compressed on fExecutor,
+        if set; the output is slightly larger but does not depend on the
+        executor.
+
+        Experimental.
+    */
+    enum Deflater {
+        kZlib_Deflater,
+        kParallel_Deflater,
+    } fDeflater = kZlib_Deflater;
+
     /** Preferred Subsetter. */
     enum Subsetter {
         kHarfbuzz_Subsetter,
@@ -185,6 +185,40 @@ public:
         return MakeForBlender(std::move(sksl), Options{});
     }
 
+    // Successful calls to the Make functions above are cached in memory, keyed on the SkSL, the
+    // effect type and the options. Repeated calls with the same arguments return the same effect
+    // without re-parsing the SkSL. Sets the maximum number of cached effects (the default is 128;
+    // zero disables the cache) and returns the previous limit. Effects that Skia creates while
+    // deserializing are cached separately and are not affected.
+    static int SetCacheLimit(int count);
+
+    /**
+     * Persistent storage for compiled effects. When installed, the CPU backend's compiled program
+     * for an effect is looked up here before it is compiled, and stored here after it has been
+     * compiled, so that subsequent processes can skip compilation. Stored data embeds the
+     * effect's source, a format version and the Skia milestone, and entries for other source or
+     * from a different version are ignored.
+     *
+     * The cache may be called from any thread.
+     */
+    class SK_API ProgramCache {
+    public:
+        virtual ~ProgramCache() = default;
+
+        // Returns the data previously stored for key, or nullptr.
+        virtual sk_sp<SkData> load(const SkData& key) = 0;
+        virtual void store(const SkData& key, const SkData& data) = 0;
+    };
+
+    // Installs the process-wide program cache, or removes it when passed nullptr. The cache is
+    // not owned, and must outlive every effect that is drawn while it is installed.
+    static void SetProgramCache(ProgramCache*);
+
+    // Returns a ProgramCache that stores each entry as a file in the given (existing) directory.
+    // Entries are written to a temporary file that is then renamed into place, so a reader never
+    // sees a partial entry.
+    static std::unique_ptr<ProgramCache> MakeDirectoryProgramCache(const char* directory);
+
     // Object that allows passing a SkShader, SkColorFilter or SkBlender as a child
     class SK_API ChildPtr {
     public:
@@ -295,6 +329,9 @@ private:
     sk_sp<SkRuntimeEffect> makeUnoptimizedClone();
 
     static Result MakeFromSource(SkString sksl, const Options& options, SkSL::ProgramKind kind);
+    static Result MakeFromSourceUncached(const SkString& sksl,
+                                         const Options& options,
+                                         SkSL::ProgramKind kind);
 
     static Result MakeInternal(std::unique_ptr<SkSL::Program> program,
                                const Options& options,
@@ -310,6 +347,7 @@ private:
     bool isAlphaUnchanged()   const { return (fFlags & kAlphaUnchanged_Flag);     }
 
     const SkSL::RP::Program* getRPProgram(SkSL::DebugTracePriv* debugTrace) const;
+    sk_sp<SkData> makeProgramCacheKey() const;
 
     friend class GrSkSLFP;              // usesColorTransform
     friend class SkRuntimeShader;       // fBaseProgram, fMain, fSampleUsages, getRPProgram()
@@ -15,6 +15,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 
 class SK_API SkEncoder : SkNoncopyable {
 public:
@@ -43,6 +44,39 @@ public:
      */
     bool encodeRows(int numRows);
 
+    /**
+     *  Encode the rows of |band| as the next band.height() rows of the image.
+     *
+     *  This is meant for encoders that were made from an SkImageInfo rather than an SkPixmap
+     *  (e.g. SkPngEncoder::MakeForBands()), so that the whole image never has to be in memory
+     *  at once. |band| must have the width, color type and alpha type the encoder was made
+     *  with, and must not extend past the bottom of the image. Its pixels only need to remain
+     *  valid for the duration of this call.
+     */
+    bool encodeBand(const SkPixmap& band);
+
+    /**
+     *  Pull-based version of encodeBand(). Until the image is complete, calls |produceBand|
+     *  with the index of the next row and a pixmap of up to |bandHeight| rows to fill with
+     *  the image starting at that row, then encodes it. The pixmap is reused between calls,
+     *  and is not cleared.
+     *
+     *  For example, to encode an SkPicture without rasterizing all of it at once:
+     *
+     *      encoder->encodeBands(256, [&](int top, const SkPixmap& band) {
+     *          auto canvas = SkCanvas::MakeRasterDirect(band.info(), band.writable_addr(),
+     *                                                   band.rowBytes());
+     *          canvas->clear(SK_ColorTRANSPARENT);
+     *          canvas->translate(0, -top);
+     *          canvas->drawPicture(picture);
+     *          return true;
+     *      });
+     *
+     *  Returns false if |produceBand| returns false or if encoding fails.
+     */
+    using BandProducer = std::function<bool(int firstRow, const SkPixmap& band)>;
+    bool encodeBands(int bandHeight, const BandProducer& produceBand);
+
     virtual ~SkEncoder() {}
 
 protected:
@@ -55,9 +89,18 @@ protected:
         , fStorage(storageBytes)
     {}
 
-    const SkPixmap&        fSrc;
+    // Returns the address of row |y| of the image. The row comes from the band being encoded by
+    // encodeBand(), if there is one, and from the source pixmap otherwise.
+    const void* srcRow(int y) const;
+
+    // When encoding bands, this has the dimensions of the image but no pixels.
+    const SkPixmap         fSrc;
     int                    fCurrRow;
     skia_private::AutoTMalloc<uint8_t> fStorage;
+
+private:
+    SkPixmap               fBand;
+    int                    fBandTop = 0;
 };
 
 #endif
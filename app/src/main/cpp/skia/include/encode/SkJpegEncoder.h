@@ -23,6 +23,7 @@ class SkWStream;
 class SkImage;
 class GrDirectContext;
 class SkYUVAPixmaps;
+struct SkImageInfo;
 struct skcms_ICCProfile;
 
 namespace SkJpegEncoder {
@@ -127,6 +128,19 @@ SK_API std::unique_ptr<SkEncoder> Make(SkWStream* dst,
                                        const SkYUVAPixmaps& src,
                                        const SkColorSpace* srcColorSpace,
                                        const Options& options);
+
+/**
+ *  Create a jpeg encoder for an image described by |info|, whose pixels will be provided a
+ *  band of rows at a time with SkEncoder::encodeBand() or SkEncoder::encodeBands(). Only one
+ *  band (and the encoder's own row buffers) has to be in memory at a time.
+ *
+ *  |dst| is unowned but must remain valid for the lifetime of the object.
+ *
+ *  This returns nullptr on an invalid or unsupported |info|.
+ */
+SK_API std::unique_ptr<SkEncoder> MakeForBands(SkWStream* dst,
+                                               const SkImageInfo& info,
+                                               const Options& options);
 }  // namespace SkJpegEncoder
 
 #endif
@@ -19,11 +19,13 @@
 
 class GrDirectContext;
 class SkData;
+class SkExecutor;
 class SkImage;
 class SkPixmap;
 class SkWStream;
-struct skcms_ICCProfile;
 struct SkGainmapInfo;
+struct SkImageInfo;
+struct skcms_ICCProfile;
 
 namespace SkPngEncoder {
 
@@ -94,6 +96,20 @@ struct Options {
      */
     const SkPixmap* fGainmap = nullptr;
     const SkGainmapInfo* fGainmapInfo = nullptr;
+
+    /**
+     *  If non-null, Encode() splits the image into bands of rows that are filtered and
+     *  compressed concurrently on this executor, then stitched into a single IDAT stream.
+     *  Each band's compressor is primed with the end of the previous band, so the size of
+     *  the output is close to that of a serial encode. The output is a standard PNG, but
+     *  it is not byte-identical to the serial output.
+     *
+     *  When more than one filter is allowed, rows are filtered with a heuristic that picks
+     *  the filter with the smallest sum of absolute values, like libpng's default.
+     *
+     *  This is ignored by the incremental encoders returned by Make() and MakeForBands().
+     */
+    SkExecutor* fExecutor = nullptr;
 };
 
 /**
@@ -126,6 +142,21 @@ SK_API sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Opti
  */
 SK_API std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options);
 
+/**
+ *  Create a png encoder for an image described by |info|, whose pixels will be provided a
+ *  band of rows at a time with SkEncoder::encodeBand() or SkEncoder::encodeBands(). Only one
+ *  band (and the encoder's own row buffer) has to be in memory at a time.
+ *
+ *  |options.fExecutor| is ignored.
+ *
+ *  |dst| is unowned but must remain valid for the lifetime of the object.
+ *
+ *  This returns nullptr on an invalid or unsupported |info|.
+ */
+SK_API std::unique_ptr<SkEncoder> MakeForBands(SkWStream* dst,
+                                               const SkImageInfo& info,
+                                               const Options& options);
+
 }  // namespace SkPngEncoder
 
 #endif
@@ -12,6 +12,8 @@
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTDArray.h"
 
+class SkExecutor;
+
 struct SkRect;
 
 
@@ -109,12 +111,24 @@ public:
       */
     bool resolve(SkPath* result);
 
+    /** Like resolve(result), but when every operand is a union, paths whose bounds
+        do not touch are resolved as independent clusters, on the executor's threads
+        if executor is not nullptr. Each cluster is unioned hierarchically, so this
+        scales to many thousands of small paths.
+
+        @param result The product of the operands.
+        @param executor Runs clusters in parallel; may be nullptr.
+        @return True if the operation succeeded.
+      */
+    bool resolve(SkPath* result, SkExecutor* executor);
+
 private:
     skia_private::TArray<SkPath> fPathRefs;
     SkTDArray<SkPathOp> fOps;
 
     static bool FixWinding(SkPath* path);
     static void ReversePath(SkPath* path);
+    bool resolveUnionBatch(SkPath* result, SkExecutor* executor);
     void reset();
 };
 
@@ -0,0 +1,26 @@
+// Copyright 2026 Google LLC
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#ifndef PathBoolean_DEFINED
+#define PathBoolean_DEFINED
+
+#include "include/core/SkPath.h"
+#include "include/pathops/SkPathOps.h"
+
+namespace bentleyottmann {
+
+// Computes (one op two), like Op() in SkPathOps.h, using exact integer geometry.
+//
+// Curves are flattened, and points are rounded to a grid of 1/1024 (coarser for paths that are
+// too large to fit). Crossings are snap rounded to the same grid, so the result is always
+// computed; self-intersecting, coincident, and otherwise degenerate paths are handled like any
+// other. Non-finite paths are treated as empty.
+//
+// The result only has lines, and uses a winding fill with consistently oriented contours. Crossings
+// are found with myers_find_crossings, and the result is built with a single sweep, so for n edges
+// with k crossings it takes O((n + k) log n) time.
+SkPath boolean_op(const SkPath& one, const SkPath& two, SkPathOp op);
+
+}  // namespace bentleyottmann
+
+#endif  // PathBoolean_DEFINED
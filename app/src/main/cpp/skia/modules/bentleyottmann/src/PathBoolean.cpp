@@ -0,0 +1,615 @@
+// Copyright 2026 Google LLC
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#include "modules/bentleyottmann/include/PathBoolean.h"
+
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRect.h"
+#include "include/core/SkScalar.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTo.h"
+#include "modules/bentleyottmann/include/Myers.h"
+#include "modules/bentleyottmann/include/Point.h"
+#include "modules/bentleyottmann/include/Segment.h"
+#include "src/core/SkGeometry.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace bentleyottmann {
+namespace {
+
+constexpr double kScaleFactor = 1024;
+// Points are kept within ±2^29 so that differences of coordinates fit in an int32_t, as the
+// predicates in Segment.h and Myers.h require.
+constexpr double kMaxCoordinate = 1 << 29;
+// Curves are flattened to within this many grid units, which is 1/64 on the finest grid.
+constexpr double kFlattenTolerance = 16;
+constexpr int kMaxFlattenSegments = 1024;
+
+// -- Input edges ----------------------------------------------------------------------------------
+struct Edge {
+    Point from;
+    Point to;
+    int operand;
+};
+
+class EdgeCollector {
+public:
+    EdgeCollector(double scale, int operand, std::vector<Edge>* edges)
+            : fScale{scale}, fOperand{operand}, fEdges{edges} {}
+
+    void moveTo(SkPoint p) {
+        this->close();
+        fStart = fLast = this->round(p);
+        fOpen = true;
+    }
+
+    void lineTo(SkPoint p) {
+        Point to = this->round(p);
+        if (to != fLast) {
+            fEdges->push_back({fLast, to, fOperand});
+            fLast = to;
+        }
+    }
+
+    void close() {
+        if (fOpen && fLast != fStart) {
+            fEdges->push_back({fLast, fStart, fOperand});
+        }
+        fLast = fStart;
+        fOpen = false;
+    }
+
+private:
+    Point round(SkPoint p) const {
+        return {SkToS32(std::lround(p.x() * fScale)), SkToS32(std::lround(p.y() * fScale))};
+    }
+
+    const double fScale;
+    const int fOperand;
+    std::vector<Edge>* const fEdges;
+    Point fStart = {0, 0};
+    Point fLast = {0, 0};
+    bool fOpen = false;
+};
+
+// The number of lines needed to flatten a quad or cubic to within tolerance, from Wang's formula.
+int flatten_count(SkSpan<const SkPoint> pts, float tolerance) {
+    const int degree = SkToInt(pts.size()) - 1;
+    float maxLength = 0;
+    for (size_t i = 0; i + 2 < pts.size(); ++i) {
+        maxLength = std::max(maxLength, (pts[i] - pts[i + 1] * 2 + pts[i + 2]).length());
+    }
+    const float count = std::ceil(
+            std::sqrt(degree * (degree - 1) / 8.0f * maxLength / tolerance));
+    return count < kMaxFlattenSegments ? std::max(1, static_cast<int>(count)) : kMaxFlattenSegments;
+}
+
+void flatten_quad(const SkPoint pts[3], float tolerance, EdgeCollector* collector) {
+    const int count = flatten_count({pts, 3}, tolerance);
+    for (int i = 1; i < count; ++i) {
+        collector->lineTo(SkEvalQuadAt(pts, SkScalar(i) / count));
+    }
+    collector->lineTo(pts[2]);
+}
+
+void add_path(const SkPath& path, double scale, int operand, std::vector<Edge>* edges) {
+    EdgeCollector collector{scale, operand, edges};
+    const float tolerance = kFlattenTolerance / scale;
+    SkPath::Iter iter(path, false);
+    while (auto rec = iter.next()) {
+        SkSpan<const SkPoint> pts = rec->fPoints;
+        switch (rec->fVerb) {
+            case SkPathVerb::kMove:
+                collector.moveTo(pts[0]);
+                break;
+            case SkPathVerb::kLine:
+                collector.lineTo(pts[1]);
+                break;
+            case SkPathVerb::kQuad:
+                flatten_quad(pts.data(), tolerance, &collector);
+                break;
+            case SkPathVerb::kConic: {
+                // An elliptical conic is flatter than the quad with the same control points, so
+                // the quad's count is enough. Hyperbolic conics are approximated by quads first.
+                if (rec->fConicWeight <= 1) {
+                    const SkConic conic{pts.data(), rec->fConicWeight};
+                    const int count = flatten_count(pts, tolerance);
+                    for (int i = 1; i < count; ++i) {
+                        collector.lineTo(conic.evalAt(SkScalar(i) / count));
+                    }
+                    collector.lineTo(pts[2]);
+                    break;
+                }
+                SkAutoConicToQuads quadder;
+                const SkPoint* quads =
+                        quadder.computeQuads(pts.data(), rec->fConicWeight, tolerance);
+                for (int i = 0; i < quadder.countQuads(); ++i) {
+                    flatten_quad(quads + 2 * i, tolerance, &collector);
+                }
+                break;
+            }
+            case SkPathVerb::kCubic: {
+                const int count = flatten_count(pts, tolerance);
+                for (int i = 1; i < count; ++i) {
+                    SkPoint p;
+                    SkEvalCubicAt(pts.data(), SkScalar(i) / count, &p, nullptr, nullptr);
+                    collector.lineTo(p);
+                }
+                collector.lineTo(pts[3]);
+                break;
+            }
+            case SkPathVerb::kClose:
+                collector.close();
+                break;
+        }
+    }
+    // Paths are filled as if every contour were closed.
+    collector.close();
+}
+
+// Use the finest grid, up to kScaleFactor, that keeps every point within kMaxCoordinate.
+double grid_scale(const SkRect& bounds) {
+    const double extent = std::max({std::abs(bounds.fLeft), std::abs(bounds.fTop),
+                                    std::abs(bounds.fRight), std::abs(bounds.fBottom)});
+    double scale = kScaleFactor;
+    while (extent * scale > kMaxCoordinate) {
+        scale /= 2;
+    }
+    return scale;
+}
+
+// -- Snap rounding --------------------------------------------------------------------------------
+// Hot pixels are the unit squares centered on every vertex and rounded crossing. Each edge is
+// replaced by the polyline through the centers of the hot pixels it touches, after which edges only
+// meet at their end points (Hobby, "Practical segment intersection with finite precision output").
+class HotPixels {
+public:
+    explicit HotPixels(std::vector<Point> centers) {
+        std::sort(centers.begin(), centers.end());
+        centers.erase(std::unique(centers.begin(), centers.end()), centers.end());
+        SkASSERT(!centers.empty());
+
+        // Bucket the pixels into square cells, about one pixel per cell.
+        int64_t left = centers[0].x, right = centers[0].x;
+        for (const Point& c : centers) {
+            left = std::min<int64_t>(left, c.x);
+            right = std::max<int64_t>(right, c.x);
+        }
+        fOrigin = {SkToS32(left), centers.front().y};
+        const int64_t extent = std::max(right - left, SkToS64(centers.back().y) - fOrigin.y) + 1;
+        fCellSize = std::max<int64_t>(
+                1, static_cast<int64_t>(std::ceil(extent / std::sqrt(double(centers.size())))));
+        fColumns = (right - left) / fCellSize + 1;
+        const int64_t rows = (SkToS64(centers.back().y) - fOrigin.y) / fCellSize + 1;
+
+        // Counting sort the pixels by cell.
+        fCellStart.assign(fColumns * rows + 1, 0);
+        for (const Point& c : centers) {
+            ++fCellStart[this->cell(c) + 1];
+        }
+        for (size_t i = 1; i < fCellStart.size(); ++i) {
+            fCellStart[i] += fCellStart[i - 1];
+        }
+        fCenters.resize(centers.size());
+        std::vector<size_t> next(fCellStart.begin(), std::prev(fCellStart.end()));
+        for (const Point& c : centers) {
+            fCenters[next[this->cell(c)]++] = c;
+        }
+    }
+
+    // Append the centers of the hot pixels touched by the edge from `from` to `to`, in order.
+    void snap(Point from, Point to, std::vector<Point>* polyline) const {
+        const size_t start = polyline->size();
+        polyline->push_back(from);
+
+        // Only pixels with centers in the edge's bounds can touch it.
+        const auto [top, bottom] = std::minmax(from.y, to.y);
+        const auto [left, right] = std::minmax(from.x, to.x);
+        const int64_t firstRow = std::max<int64_t>(0, this->row(top)),
+                      lastRow = std::min<int64_t>(this->rowCount() - 1, this->row(bottom));
+        for (int64_t r = firstRow; r <= lastRow; ++r) {
+            // Bound the x extent of the edge within this row of cells.
+            double rowLeft = left, rowRight = right;
+            if (from.y != to.y) {
+                auto xAt = [&](double y) {
+                    return from.x + (y - from.y) * (to.x - from.x) / (to.y - from.y);
+                };
+                const double y0 = std::max<double>(top, fOrigin.y + r * fCellSize - 0.5),
+                             y1 = std::min<double>(bottom, fOrigin.y + (r + 1) * fCellSize - 0.5);
+                std::tie(rowLeft, rowRight) = std::minmax(xAt(y0), xAt(y1));
+            }
+            const int64_t firstColumn = std::max<int64_t>(
+                                  0, this->column(std::max<int64_t>(left, std::floor(rowLeft) - 1))),
+                          lastColumn = std::min<int64_t>(
+                                  fColumns - 1,
+                                  this->column(std::min<int64_t>(right, std::ceil(rowRight) + 1)));
+            for (int64_t c = firstColumn; c <= lastColumn; ++c) {
+                const int64_t cell = r * fColumns + c;
+                for (size_t i = fCellStart[cell]; i < fCellStart[cell + 1]; ++i) {
+                    const Point center = fCenters[i];
+                    if (center != from && center != to && touches_pixel(from, to, center)) {
+                        polyline->push_back(center);
+                    }
+                }
+            }
+        }
+
+        // Order by distance along the edge. The end points are hot pixels themselves; keep them at
+        // the ends even if a neighboring pixel's center projects beyond them.
+        const int64_t dx = SkToS64(to.x) - from.x,
+                      dy = SkToS64(to.y) - from.y;
+        auto along = [&](const Point& p) {
+            return (SkToS64(p.x) - from.x) * dx + (SkToS64(p.y) - from.y) * dy;
+        };
+        std::sort(polyline->begin() + start + 1, polyline->end(),
+                  [&](const Point& p0, const Point& p1) { return along(p0) < along(p1); });
+        polyline->push_back(to);
+    }
+
+private:
+    int64_t row(int32_t y) const { return (SkToS64(y) - fOrigin.y) / fCellSize; }
+    int64_t column(int64_t x) const { return (x - fOrigin.x) / fCellSize; }
+    int64_t rowCount() const { return SkToS64(fCellStart.size() - 1) / fColumns; }
+    int64_t cell(Point p) const { return this->row(p.y) * fColumns + this->column(p.x); }
+
+    // Does the edge touch the closed unit square centered on c? Coordinates are doubled so that
+    // the square's corners are integers.
+    static bool touches_pixel(Point from, Point to, Point c) {
+        const int64_t x0 = 2 * SkToS64(from.x), y0 = 2 * SkToS64(from.y),
+                      x1 = 2 * SkToS64(to.x),   y1 = 2 * SkToS64(to.y),
+                      left = 2 * SkToS64(c.x) - 1, right  = 2 * SkToS64(c.x) + 1,
+                      top  = 2 * SkToS64(c.y) - 1, bottom = 2 * SkToS64(c.y) + 1;
+        if (std::max(x0, x1) < left || right < std::min(x0, x1) ||
+            std::max(y0, y1) < top  || bottom < std::min(y0, y1)) {
+            return false;
+        }
+        // The edge's line separates the square only if all four corners are strictly on one side.
+        const int64_t dx = x1 - x0, dy = y1 - y0;
+        auto side = [&](int64_t x, int64_t y) {
+            const int64_t cross = dx * (y - y0) - dy * (x - x0);
+            return (cross > 0) - (cross < 0);
+        };
+        const int sum = side(left, top) + side(right, top) +
+                        side(left, bottom) + side(right, bottom);
+        return sum != 4 && sum != -4;
+    }
+
+    Point fOrigin;
+    int64_t fCellSize;
+    int64_t fColumns;
+    // The pixels in each cell are fCenters[fCellStart[cell]] to fCenters[fCellStart[cell + 1]].
+    std::vector<size_t> fCellStart;
+    std::vector<Point> fCenters;
+};
+
+// An edge of the snapped arrangement from upper to lower, merged with any coincident edges. The
+// winding deltas count edges going from upper to lower as +1, and the other way as -1.
+struct SnappedEdge {
+    Point upper;
+    Point lower;
+    int winding[2];
+
+    Segment segment() const { return {upper, lower}; }
+};
+
+std::vector<SnappedEdge> snap_edges(SkSpan<const Edge> edges, const HotPixels& hotPixels) {
+    std::vector<SnappedEdge> snapped;
+    std::vector<Point> polyline;
+    for (const Edge& edge : edges) {
+        polyline.clear();
+        hotPixels.snap(edge.from, edge.to, &polyline);
+        for (size_t i = 0; i + 1 < polyline.size(); ++i) {
+            const Point p0 = polyline[i], p1 = polyline[i + 1];
+            SnappedEdge e{std::min(p0, p1), std::max(p0, p1), {0, 0}};
+            e.winding[edge.operand] = p0 < p1 ? 1 : -1;
+            snapped.push_back(e);
+        }
+    }
+
+    // Merge coincident edges. Edges whose windings cancel out do not separate different regions.
+    std::sort(snapped.begin(), snapped.end(), [](const SnappedEdge& e0, const SnappedEdge& e1) {
+        return std::tie(e0.upper, e0.lower) < std::tie(e1.upper, e1.lower);
+    });
+    std::vector<SnappedEdge> merged;
+    for (const SnappedEdge& e : snapped) {
+        if (!merged.empty() && merged.back().upper == e.upper && merged.back().lower == e.lower) {
+            merged.back().winding[0] += e.winding[0];
+            merged.back().winding[1] += e.winding[1];
+        } else {
+            merged.push_back(e);
+        }
+    }
+    merged.erase(std::remove_if(merged.begin(), merged.end(), [](const SnappedEdge& e) {
+        return e.winding[0] == 0 && e.winding[1] == 0;
+    }), merged.end());
+    return merged;
+}
+
+// Returns the rounded crossings in the interiors of the edges. The exact sweep from Myers.h is
+// used because it handles coincident and touching segments.
+std::vector<Point> crossing_points(SkSpan<const SnappedEdge> edges) {
+    std::vector<myers::Segment> segments;
+    segments.reserve(edges.size());
+    for (const SnappedEdge& e : edges) {
+        segments.emplace_back(myers::Point{e.upper.x, e.upper.y},
+                              myers::Point{e.lower.x, e.lower.y});
+    }
+    std::sort(segments.begin(), segments.end());
+    segments.erase(std::unique(segments.begin(), segments.end()), segments.end());
+    if (segments.empty()) {
+        return {};
+    }
+
+    auto toSegment = [](const myers::Segment& s) {
+        return Segment{{s.upper().x, s.upper().y}, {s.lower().x, s.lower().y}};
+    };
+    std::vector<Point> points;
+    for (const myers::Crossing& crossing : myers::myers_find_crossings(segments)) {
+        // Collinear overlaps have no crossing point, but they do not need one; the end points of
+        // each segment are already hot pixels, and snapping merges the overlapping parts.
+        if (auto p = intersect(toSegment(crossing.higher()), toSegment(crossing.lower()))) {
+            points.push_back(*p);
+        }
+    }
+    return points;
+}
+
+std::vector<SnappedEdge> snap_round(SkSpan<const Edge> edges) {
+    if (edges.empty()) {
+        return {};
+    }
+    std::vector<Point> hot;
+    hot.reserve(2 * edges.size());
+    for (const Edge& e : edges) {
+        hot.push_back(e.from);
+        hot.push_back(e.to);
+    }
+    std::vector<SnappedEdge> unsnapped;
+    unsnapped.reserve(edges.size());
+    for (const Edge& e : edges) {
+        unsnapped.push_back({std::min(e.from, e.to), std::max(e.from, e.to), {0, 0}});
+    }
+    const std::vector<Point> crossings = crossing_points(unsnapped);
+    hot.insert(hot.end(), crossings.begin(), crossings.end());
+    std::vector<SnappedEdge> snapped = snap_edges(edges, HotPixels{std::move(hot)});
+    // Snapped edges never cross, since each one passes through the center of every hot pixel it
+    // touches.
+    SkASSERT(crossing_points(snapped).empty());
+    return snapped;
+}
+
+// -- Sweep ----------------------------------------------------------------------------------------
+// Sweep the snapped arrangement top to bottom to find the winding numbers on the left of each
+// edge. Since edges only meet at their end points, the order of the edges crossing the sweep line
+// only changes at vertices. Horizontal edges are treated as if the plane were sheared very slightly
+// down to the right, so they start at their left end and end at their right end, with the region
+// below them on their left.
+class Sweep {
+public:
+    explicit Sweep(SkSpan<const SnappedEdge> edges)
+            : fEdges{edges}
+            , fLeftWinding(edges.size(), {0, 0})
+            , fStatus{EdgeLess{this}} {}
+
+    // Returns the winding numbers, for each operand, of the region left of each edge.
+    std::vector<std::array<int, 2>> run() {
+        std::vector<int> starts(fEdges.size()), ends(fEdges.size());
+        for (size_t i = 0; i < fEdges.size(); ++i) {
+            starts[i] = ends[i] = SkToInt(i);
+        }
+        std::sort(starts.begin(), starts.end(), [&](int e0, int e1) {
+            const SnappedEdge &s0 = fEdges[e0], &s1 = fEdges[e1];
+            if (s0.upper != s1.upper) {
+                return s0.upper < s1.upper;
+            }
+            return compare_slopes(s0.segment(), s1.segment()) < 0;
+        });
+        std::sort(ends.begin(), ends.end(),
+                  [&](int e0, int e1) { return fEdges[e0].lower < fEdges[e1].lower; });
+
+        std::vector<Status::iterator> positions(fEdges.size(), fStatus.end());
+        auto start = starts.begin(), end = ends.begin();
+        while (start != starts.end() || end != ends.end()) {
+            fSweepPoint = end == ends.end() ? fEdges[*start].upper
+                        : start == starts.end() ? fEdges[*end].lower
+                        : std::min(fEdges[*start].upper, fEdges[*end].lower);
+
+            for (; end != ends.end() && fEdges[*end].lower == fSweepPoint; ++end) {
+                fStatus.erase(positions[*end]);
+            }
+            for (; start != starts.end() && fEdges[*start].upper == fSweepPoint; ++start) {
+                auto position = fStatus.insert(*start);
+                positions[*start] = position;
+                if (position != fStatus.begin()) {
+                    const int left = *std::prev(position);
+                    fLeftWinding[*start] = {fLeftWinding[left][0] + fEdges[left].winding[0],
+                                            fLeftWinding[left][1] + fEdges[left].winding[1]};
+                }
+            }
+        }
+        return std::move(fLeftWinding);
+    }
+
+private:
+    // Orders edges along the sweep line at fSweepPoint. Edges are only compared when one of them
+    // is being inserted, so it starts at the sweep point.
+    struct EdgeLess {
+        const Sweep* sweep;
+
+        bool operator()(int e0, int e1) const {
+            const Point p = sweep->fSweepPoint;
+            const SnappedEdge &s0 = sweep->fEdges[e0], &s1 = sweep->fEdges[e1];
+            const bool starts0 = s0.upper == p, starts1 = s1.upper == p;
+            if (starts0 && starts1) {
+                return compare_slopes(s0.segment(), s1.segment()) < 0;
+            }
+            if (starts0) {
+                return point_less_than_segment_in_x(p, s1.segment());
+            }
+            if (starts1) {
+                return !point_less_than_segment_in_x(p, s0.segment());
+            }
+            return false;
+        }
+    };
+    using Status = std::multiset<int, EdgeLess>;
+
+    SkSpan<const SnappedEdge> fEdges;
+    std::vector<std::array<int, 2>> fLeftWinding;
+    Point fSweepPoint = Point::Smallest();
+    Status fStatus;
+};
+
+// -- Output ---------------------------------------------------------------------------------------
+bool is_inside(int winding, SkPathFillType fillType) {
+    bool inside = SkPathFillType_IsEvenOdd(fillType) ? (winding & 1) : winding != 0;
+    return inside != SkPathFillType_IsInverse(fillType);
+}
+
+bool apply_op(bool one, bool two, SkPathOp op) {
+    switch (op) {
+        case kDifference_SkPathOp:        return one && !two;
+        case kIntersect_SkPathOp:         return one && two;
+        case kUnion_SkPathOp:             return one || two;
+        case kXOR_SkPathOp:               return one != two;
+        case kReverseDifference_SkPathOp: return two && !one;
+    }
+    SkUNREACHABLE;
+}
+
+// Link directed edges into closed contours. Every vertex of a region's boundary has as many edges
+// leaving it as entering it, so the walk always returns to where it started.
+SkPath build_path(std::vector<std::pair<Point, Point>> edges, double scale, SkPathFillType fill) {
+    std::sort(edges.begin(), edges.end());
+    std::vector<bool> used(edges.size(), false);
+    // The next possibly unused edge leaving each vertex, indexed by the vertex's first edge.
+    std::vector<size_t> nextUnused(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i) {
+        nextUnused[i] = i;
+    }
+    auto takeEdgeFrom = [&](Point p) -> std::optional<size_t> {
+        auto first = std::lower_bound(edges.begin(), edges.end(), p,
+                                      [](const auto& e, Point q) { return e.first < q; });
+        if (first == edges.end() || first->first != p) {
+            return std::nullopt;
+        }
+        size_t& next = nextUnused[first - edges.begin()];
+        while (next < edges.size() && edges[next].first == p && used[next]) {
+            ++next;
+        }
+        if (next == edges.size() || edges[next].first != p) {
+            return std::nullopt;
+        }
+        used[next] = true;
+        return next;
+    };
+
+    SkPathBuilder builder{fill};
+    std::vector<Point> contour;
+    auto toSkPoint = [scale](Point p) { return SkPoint::Make(p.x / scale, p.y / scale); };
+    for (size_t i = 0; i < edges.size(); ++i) {
+        if (used[i]) {
+            continue;
+        }
+        used[i] = true;
+        contour.clear();
+        contour.push_back(edges[i].first);
+        Point at = edges[i].second;
+        while (at != contour.front()) {
+            contour.push_back(at);
+            std::optional<size_t> next = takeEdgeFrom(at);
+            if (!next) {
+                break;
+            }
+            at = edges[*next].second;
+        }
+
+        // Drop the vertices in the middle of straight runs, which snapping splits edges at.
+        const size_t count = contour.size();
+        bool started = false;
+        for (size_t j = 0; j < count; ++j) {
+            const Point prev = contour[(j + count - 1) % count], p = contour[j],
+                        next = contour[(j + 1) % count];
+            const int64_t cross = (SkToS64(p.x) - prev.x) * (SkToS64(next.y) - p.y) -
+                                  (SkToS64(p.y) - prev.y) * (SkToS64(next.x) - p.x);
+            const int64_t dot = (SkToS64(p.x) - prev.x) * (SkToS64(next.x) - p.x) +
+                                (SkToS64(p.y) - prev.y) * (SkToS64(next.y) - p.y);
+            if (cross == 0 && dot > 0) {
+                continue;
+            }
+            if (started) {
+                builder.lineTo(toSkPoint(p));
+            } else {
+                builder.moveTo(toSkPoint(p));
+                started = true;
+            }
+        }
+        if (started) {
+            builder.close();
+        }
+    }
+    return builder.detach();
+}
+
+}  // namespace
+
+SkPath boolean_op(const SkPath& one, const SkPath& two, SkPathOp op) {
+    const SkPath* operands[2] = {&one, &two};
+    SkRect bounds = SkRect::MakeEmpty();
+    for (const SkPath* path : operands) {
+        if (path->isFinite()) {
+            bounds.joinPossiblyEmptyRect(path->getBounds());
+        }
+    }
+    const double scale = grid_scale(bounds);
+
+    std::vector<Edge> edges;
+    for (int operand = 0; operand < 2; ++operand) {
+        if (operands[operand]->isFinite()) {
+            add_path(*operands[operand], scale, operand, &edges);
+        }
+    }
+    std::vector<SnappedEdge> snapped = snap_round(edges);
+    std::vector<std::array<int, 2>> leftWinding = Sweep{snapped}.run();
+
+    auto inside = [&](const std::array<int, 2>& winding) {
+        return apply_op(is_inside(winding[0], one.getFillType()),
+                        is_inside(winding[1], two.getFillType()),
+                        op);
+    };
+    // If the result is unbounded, write its complement with an inverse fill.
+    const bool inverse = inside({0, 0});
+
+    std::vector<std::pair<Point, Point>> boundary;
+    for (size_t i = 0; i < snapped.size(); ++i) {
+        const SnappedEdge& e = snapped[i];
+        const std::array<int, 2> left = leftWinding[i],
+                                 right = {left[0] + e.winding[0], left[1] + e.winding[1]};
+        const bool insideLeft = inside(left) != inverse,
+                   insideRight = inside(right) != inverse;
+        if (insideLeft == insideRight) {
+            continue;
+        }
+        // Going down with the inside on the right, or up with it on the left, makes the winding
+        // number one inside the result and zero outside.
+        if (insideRight) {
+            boundary.push_back({e.upper, e.lower});
+        } else {
+            boundary.push_back({e.lower, e.upper});
+        }
+    }
+    return build_path(std::move(boundary), scale,
+                      inverse ? SkPathFillType::kInverseWinding : SkPathFillType::kWinding);
+}
+
+}  // namespace bentleyottmann
@@ -0,0 +1,238 @@
+// Copyright 2026 Google LLC
+// Use of this source code is governed by a BSD-style license that can be found in the LICENSE file.
+
+#include "modules/bentleyottmann/include/PathBoolean.h"
+
+#include "include/core/SkPath.h"
+#include "include/core/SkRect.h"
+#include "include/pathops/SkPathOps.h"
+#include "src/base/SkRandom.h"
+#include "tests/Test.h"
+
+#include <chrono>
+#include <cinttypes>
+#include <cstdint>
+
+using namespace bentleyottmann;
+
+static bool apply_op(bool one, bool two, SkPathOp op) {
+    switch (op) {
+        case kDifference_SkPathOp:        return one && !two;
+        case kIntersect_SkPathOp:         return one && two;
+        case kUnion_SkPathOp:             return one || two;
+        case kXOR_SkPathOp:               return one != two;
+        case kReverseDifference_SkPathOp: return two && !one;
+    }
+    SkUNREACHABLE;
+}
+
+// Points closer than this to an edge of the operands may land on either side after rounding.
+static constexpr SkScalar kNear = 0.05f;
+
+static bool expected_inside(const SkPath& one, const SkPath& two, SkPathOp op, SkPoint p) {
+    return apply_op(one.contains(p.x(), p.y()), two.contains(p.x(), p.y()), op);
+}
+
+static bool near_boundary(const SkPath& one, const SkPath& two, SkPathOp op, SkPoint p) {
+    const bool inside = expected_inside(one, two, op, p);
+    for (SkScalar dx : {-kNear, 0.0f, kNear}) {
+        for (SkScalar dy : {-kNear, 0.0f, kNear}) {
+            if (expected_inside(one, two, op, p + SkVector{dx, dy}) != inside) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Check that result is (one op two), or matches reference if there is one, at random points away
+// from the operands' edges.
+static void check_samples(skiatest::Reporter* r, SkRandom* random, const SkPath& result,
+                          const SkPath& one, const SkPath& two, SkPathOp op,
+                          const SkPath* reference = nullptr) {
+    SkRect bounds = one.getBounds();
+    bounds.join(two.getBounds());
+    bounds.outset(10, 10);
+    for (int i = 0; i < 1000; ++i) {
+        const SkPoint p = {random->nextRangeF(bounds.fLeft, bounds.fRight),
+                           random->nextRangeF(bounds.fTop, bounds.fBottom)};
+        const bool expected = reference ? reference->contains(p.x(), p.y())
+                                        : expected_inside(one, two, op, p);
+        if (result.contains(p.x(), p.y()) != expected) {
+            REPORTER_ASSERT(r, near_boundary(one, two, op, p), "op %d at (%g, %g)",
+                            op, p.x(), p.y());
+        }
+    }
+}
+
+static SkPath random_path(SkRandom* random, bool curves, bool onGrid) {
+    SkPath path;
+    path.setFillType(random->nextBool() ? SkPathFillType::kEvenOdd : SkPathFillType::kWinding);
+    auto randomPoint = [&]() {
+        if (onGrid) {
+            // Many collinear, coincident and touching edges.
+            return SkPoint{20.0f * random->nextULessThan(6), 20.0f * random->nextULessThan(6)};
+        }
+        return SkPoint{random->nextRangeF(0, 100), random->nextRangeF(0, 100)};
+    };
+    const int contourCount = 1 + random->nextULessThan(3);
+    for (int contour = 0; contour < contourCount; ++contour) {
+        path.moveTo(randomPoint());
+        const int verbCount = 3 + random->nextULessThan(10);
+        for (int verb = 0; verb < verbCount; ++verb) {
+            if (curves && random->nextBool()) {
+                path.quadTo(randomPoint(), randomPoint());
+            } else {
+                path.lineTo(randomPoint());
+            }
+        }
+        path.close();
+    }
+    return path;
+}
+
+DEF_TEST(BO_PathBooleanBasic, r) {
+    const SkPath square = SkPath::Rect({0, 0, 10, 10});
+    const SkPath shifted = SkPath::Rect({5, 5, 15, 15});
+
+    {
+        SkPath result = boolean_op(square, shifted, kUnion_SkPathOp);
+        REPORTER_ASSERT(r, result.getBounds() == SkRect::MakeLTRB(0, 0, 15, 15));
+        REPORTER_ASSERT(r, result.countPoints() == 8);
+        REPORTER_ASSERT(r, result.contains(12, 7) && !result.contains(12, 2));
+    }
+
+    {
+        SkPath result = boolean_op(square, shifted, kIntersect_SkPathOp);
+        REPORTER_ASSERT(r, result.getBounds() == SkRect::MakeLTRB(5, 5, 10, 10));
+        REPORTER_ASSERT(r, result.countPoints() == 4);
+    }
+
+    {
+        SkPath result = boolean_op(square, shifted, kDifference_SkPathOp);
+        REPORTER_ASSERT(r, result.contains(2, 2) && !result.contains(7, 7));
+        REPORTER_ASSERT(r, result.countPoints() == 6);
+    }
+
+    {
+        SkPath result = boolean_op(square, shifted, kXOR_SkPathOp);
+        REPORTER_ASSERT(r, result.contains(2, 2) && result.contains(12, 12));
+        REPORTER_ASSERT(r, !result.contains(7, 7) && !result.contains(12, 2));
+    }
+}
+
+DEF_TEST(BO_PathBooleanDegenerate, r) {
+    const SkPath square = SkPath::Rect({0, 0, 10, 10});
+
+    // Coincident operands.
+    REPORTER_ASSERT(r, boolean_op(square, square, kXOR_SkPathOp).isEmpty());
+    REPORTER_ASSERT(r, boolean_op(square, square, kDifference_SkPathOp).isEmpty());
+    REPORTER_ASSERT(r, boolean_op(square, square, kUnion_SkPathOp).countPoints() == 4);
+
+    // Empty and non-finite operands.
+    REPORTER_ASSERT(r, boolean_op(SkPath(), SkPath(), kUnion_SkPathOp).isEmpty());
+    {
+        SkPath nonFinite;
+        nonFinite.moveTo(0, 0);
+        nonFinite.lineTo(SK_ScalarInfinity, 0);
+        nonFinite.lineTo(0, 5);
+        REPORTER_ASSERT(r, boolean_op(nonFinite, square, kUnion_SkPathOp).countPoints() == 4);
+    }
+
+    // Edges that touch along their length, and squares that only share a corner.
+    {
+        SkPath result = boolean_op(square, SkPath::Rect({10, 0, 20, 10}), kUnion_SkPathOp);
+        REPORTER_ASSERT(r, result.countPoints() == 4);
+        REPORTER_ASSERT(r, result.getBounds() == SkRect::MakeLTRB(0, 0, 20, 10));
+
+        result = boolean_op(square, SkPath::Rect({10, 10, 20, 20}), kIntersect_SkPathOp);
+        REPORTER_ASSERT(r, result.isEmpty());
+    }
+
+    // A self-intersecting star, filled with both fill rules.
+    {
+        SkPath star;
+        star.moveTo(50, 0);
+        star.lineTo(79.39f, 90.45f);
+        star.lineTo(2.45f, 34.55f);
+        star.lineTo(97.55f, 34.55f);
+        star.lineTo(20.61f, 90.45f);
+        star.close();
+        SkPath result = boolean_op(star, SkPath(), kUnion_SkPathOp);
+        REPORTER_ASSERT(r, result.contains(50, 50) && result.contains(50, 10));
+
+        star.setFillType(SkPathFillType::kEvenOdd);
+        result = boolean_op(star, SkPath(), kUnion_SkPathOp);
+        REPORTER_ASSERT(r, !result.contains(50, 50) && result.contains(50, 10));
+    }
+
+    // Unbounded results use an inverse fill.
+    {
+        SkPath inverse = square;
+        inverse.setFillType(SkPathFillType::kInverseWinding);
+        SkPath result = boolean_op(inverse, SkPath::Rect({20, 20, 30, 30}), kDifference_SkPathOp);
+        REPORTER_ASSERT(r, result.isInverseFillType());
+        REPORTER_ASSERT(r, !result.contains(5, 5) && !result.contains(25, 25));
+        REPORTER_ASSERT(r, result.contains(15, 15));
+    }
+
+    // Large paths use a coarser grid, but small features survive.
+    {
+        SkPath result = boolean_op(SkPath::Rect({-1e9f, -1e9f, 1e9f, 1e9f}),
+                                   SkPath::Rect({0, 0, 1, 1}),
+                                   kDifference_SkPathOp);
+        REPORTER_ASSERT(r, !result.contains(0.5f, 0.5f) && result.contains(5e8f, 5e8f));
+    }
+}
+
+DEF_TEST(BO_PathBooleanMatchesPathOps, r) {
+    SkRandom random;
+    for (int i = 0; i < 200; ++i) {
+        const bool curves = i % 3 == 0,
+                   onGrid = i % 4 == 0;
+        SkPath one = random_path(&random, curves, onGrid),
+               two = random_path(&random, curves, onGrid);
+        if (i % 7 == 0) {
+            one.toggleInverseFillType();
+        }
+        const SkPathOp op = static_cast<SkPathOp>(i % (kReverseDifference_SkPathOp + 1));
+
+        SkPath result = boolean_op(one, two, op);
+        check_samples(r, &random, result, one, two, op);
+
+        // Where pathops succeeds, the two results should agree away from the edges.
+        SkPath pathOpsResult;
+        if (Op(one, two, op, &pathOpsResult)) {
+            check_samples(r, &random, result, one, two, op, &pathOpsResult);
+        }
+    }
+}
+
+constexpr bool kRunTimingComparison = false;
+DEF_TEST(BO_PathBooleanTimingComparison, r) {
+    if constexpr (!kRunTimingComparison) {
+        return;
+    }
+    SkRandom random;
+    SkPath circles, squares;
+    for (int i = 0; i < 2000; ++i) {
+        circles.addCircle(random.nextRangeF(0, 1000), random.nextRangeF(0, 1000), 10);
+        squares.addRect(SkRect::MakeXYWH(random.nextRangeF(0, 1000), random.nextRangeF(0, 1000),
+                                         15, 15));
+    }
+
+    using Clock = std::chrono::high_resolution_clock;
+    auto start = Clock::now();
+    SkPath result = boolean_op(circles, squares, kUnion_SkPathOp);
+    auto afterBooleanOp = Clock::now();
+    SkPath pathOpsResult;
+    Op(circles, squares, kUnion_SkPathOp, &pathOpsResult);
+    auto afterOp = Clock::now();
+
+    auto micros = [](Clock::duration d) {
+        return static_cast<int64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(d).count());
+    };
+    SkDebugf("boolean_op: %" PRId64 " µs, Op: %" PRId64 " µs\n",
+             micros(afterBooleanOp - start), micros(afterOp - afterBooleanOp));
+}
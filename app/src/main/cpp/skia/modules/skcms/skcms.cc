@@ -2620,40 +2620,27 @@ static bool prep_for_destination(const skcms_ICCProfile* profile,
         && skcms_Matrix3x3_invert(&profile->toXYZD50, fromXYZD50);
 }
 
-bool skcms_Transform(const void*             src,
-                     skcms_PixelFormat       srcFmt,
-                     skcms_AlphaFormat       srcAlpha,
-                     const skcms_ICCProfile* srcProfile,
-                     void*                   dst,
-                     skcms_PixelFormat       dstFmt,
-                     skcms_AlphaFormat       dstAlpha,
-                     const skcms_ICCProfile* dstProfile,
-                     size_t                  nz) {
-    const size_t dst_bpp = bytes_per_pixel(dstFmt),
-                 src_bpp = bytes_per_pixel(srcFmt);
-    // Let's just refuse if the request is absurdly big.
-    if (nz * dst_bpp > INT_MAX || nz * src_bpp > INT_MAX) {
-        return false;
-    }
-    int n = (int)nz;
-
-    // Null profiles default to sRGB. Passing null for both is handy when doing format conversion.
-    if (!srcProfile) {
-        srcProfile = skcms_sRGB_profile();
-    }
-    if (!dstProfile) {
-        dstProfile = skcms_sRGB_profile();
-    }
+static constexpr int kMaxProgramSize = 32;
 
-    // We can't transform in place unless the PixelFormats are the same size.
-    if (dst == src && dst_bpp != src_bpp) {
-        return false;
-    }
-    // TODO: more careful alias rejection (like, dst == src + 1)?
-
-    Op          program[32];
-    const void* context[32];
+// Everything other than the profiles that the contexts of a program may point to.
+struct ProgramStorage {
+    skcms_ICCProfile       gray_dst_profile;
+    skcms_Matrix3x3        from_xyz;
+    // These are always parametric curves of some sort.
+    skcms_Curve            dst_curves[3];
+};
 
+// Plans the ops to convert from srcFmt/srcProfile to dstFmt/dstProfile, and returns how many
+// there are, or 0 if the conversion isn't supported.  Neither profile may be null.
+static int compile_program(skcms_PixelFormat       srcFmt,
+                           skcms_AlphaFormat       srcAlpha,
+                           const skcms_ICCProfile* srcProfile,
+                           skcms_PixelFormat       dstFmt,
+                           skcms_AlphaFormat       dstAlpha,
+                           const skcms_ICCProfile* dstProfile,
+                           ProgramStorage*         storage,
+                           Op                      program[kMaxProgramSize],
+                           const void*             context[kMaxProgramSize]) {
     Op*          ops      = program;
     const void** contexts = context;
 
@@ -2678,16 +2665,15 @@ bool skcms_Transform(const void*             src,
         }
     };
 
-    // These are always parametric curves of some sort.
-    skcms_Curve dst_curves[3];
+    skcms_Curve* dst_curves = storage->dst_curves;
     dst_curves[0].table_entries =
     dst_curves[1].table_entries =
     dst_curves[2].table_entries = 0;
 
-    skcms_Matrix3x3        from_xyz;
+    skcms_Matrix3x3& from_xyz = storage->from_xyz;
 
     switch (srcFmt >> 1) {
-        default: return false;
+        default: return 0;
         case skcms_PixelFormat_A_8              >> 1: add_op(Op::load_a8);          break;
         case skcms_PixelFormat_G_8              >> 1: add_op(Op::load_g8);          break;
         case skcms_PixelFormat_GA_88            >> 1: add_op(Op::load_ga88);        break;
@@ -2721,7 +2707,7 @@ bool skcms_Transform(const void*             src,
     if (srcFmt & 1) {
         add_op(Op::swap_rb);
     }
-    skcms_ICCProfile gray_dst_profile;
+    skcms_ICCProfile& gray_dst_profile = storage->gray_dst_profile;
     switch (dstFmt >> 1) {
         case skcms_PixelFormat_G_8:
         case skcms_PixelFormat_GA_88:
@@ -2756,7 +2742,7 @@ bool skcms_Transform(const void*             src,
                                   &dst_curves[0].parametric,
                                   &dst_curves[1].parametric,
                                   &dst_curves[2].parametric)) {
-            return false;
+            return 0;
         }
 
         if (srcProfile->has_A2B) {
@@ -2791,7 +2777,7 @@ bool skcms_Transform(const void*             src,
         } else if (srcProfile->has_trc && srcProfile->has_toXYZD50) {
             add_curve_ops(srcProfile->trc, /*numChannels=*/3);
         } else {
-            return false;
+            return 0;
         }
 
         // A2B sources are in XYZD50 by now, but TRC sources are still in their original gamut.
@@ -2891,7 +2877,7 @@ bool skcms_Transform(const void*             src,
         add_op(Op::swap_rb);
     }
     switch (dstFmt >> 1) {
-        default: return false;
+        default: return 0;
         case skcms_PixelFormat_A_8              >> 1: add_op(Op::store_a8);          break;
         case skcms_PixelFormat_G_8              >> 1: add_op(Op::store_g8);          break;
         case skcms_PixelFormat_GA_88            >> 1: add_op(Op::store_ga88);        break;
@@ -2919,9 +2905,15 @@ bool skcms_Transform(const void*             src,
             break;
     }
 
-    assert(ops      <= program + ARRAY_COUNT(program));
-    assert(contexts <= context + ARRAY_COUNT(context));
+    assert(ops      <= program + kMaxProgramSize);
+    assert(contexts <= context + kMaxProgramSize);
+    return (int)(ops - program);
+}
+
+using RunProgramFn = void (*)(const Op*, const void**, ptrdiff_t, const char*, char*, int,
+                              size_t, size_t);
 
+static RunProgramFn select_run_program() {
     auto run = baseline::run_program;
     switch (cpu_type()) {
         case CpuType::SKX:
@@ -2940,7 +2932,141 @@ bool skcms_Transform(const void*             src,
             break;
     }
 
-    run(program, context, ops - program, (const char*)src, (char*)dst, n, src_bpp,dst_bpp);
+    return run;
+}
+
+bool skcms_Transform(const void*             src,
+                     skcms_PixelFormat       srcFmt,
+                     skcms_AlphaFormat       srcAlpha,
+                     const skcms_ICCProfile* srcProfile,
+                     void*                   dst,
+                     skcms_PixelFormat       dstFmt,
+                     skcms_AlphaFormat       dstAlpha,
+                     const skcms_ICCProfile* dstProfile,
+                     size_t                  nz) {
+    const size_t dst_bpp = bytes_per_pixel(dstFmt),
+                 src_bpp = bytes_per_pixel(srcFmt);
+    // Let's just refuse if the request is absurdly big.
+    if (nz * dst_bpp > INT_MAX || nz * src_bpp > INT_MAX) {
+        return false;
+    }
+    int n = (int)nz;
+
+    // Null profiles default to sRGB. Passing null for both is handy when doing format conversion.
+    if (!srcProfile) {
+        srcProfile = skcms_sRGB_profile();
+    }
+    if (!dstProfile) {
+        dstProfile = skcms_sRGB_profile();
+    }
+
+    // We can't transform in place unless the PixelFormats are the same size.
+    if (dst == src && dst_bpp != src_bpp) {
+        return false;
+    }
+    // TODO: more careful alias rejection (like, dst == src + 1)?
+
+    ProgramStorage storage;
+    Op             program[kMaxProgramSize];
+    const void*    context[kMaxProgramSize];
+    int programSize = compile_program(srcFmt, srcAlpha, srcProfile, dstFmt, dstAlpha, dstProfile,
+                                      &storage, program, context);
+    if (programSize == 0) {
+        return false;
+    }
+
+    select_run_program()(program, context, programSize, (const char*)src, (char*)dst, n,
+                         src_bpp, dst_bpp);
+    return true;
+}
+
+struct skcms_CompiledTransform {
+    Op               program[kMaxProgramSize];
+    const void*      context[kMaxProgramSize];
+    int              programSize;
+    size_t           src_bpp,
+                     dst_bpp;
+    RunProgramFn     run;
+
+    skcms_ICCProfile src_profile,
+                     dst_profile;
+    ProgramStorage   storage;
+};
+
+skcms_CompiledTransform* skcms_MakeTransform(skcms_PixelFormat       srcFmt,
+                                             skcms_AlphaFormat       srcAlpha,
+                                             const skcms_ICCProfile* srcProfile,
+                                             skcms_PixelFormat       dstFmt,
+                                             skcms_AlphaFormat       dstAlpha,
+                                             const skcms_ICCProfile* dstProfile) {
+    if (!srcProfile) {
+        srcProfile = skcms_sRGB_profile();
+    }
+    if (!dstProfile) {
+        dstProfile = skcms_sRGB_profile();
+    }
+
+    auto t = (skcms_CompiledTransform*)malloc(sizeof(skcms_CompiledTransform));
+    if (!t) {
+        return nullptr;
+    }
+    t->src_bpp = bytes_per_pixel(srcFmt);
+    t->dst_bpp = bytes_per_pixel(dstFmt);
+    t->run     = select_run_program();
+
+    // The program compares the profile pointers to skip the gamut and curve ops,
+    // so keep them identical when they start out that way.
+    t->src_profile = *srcProfile;
+    const skcms_ICCProfile* dst = &t->src_profile;
+    if (dstProfile != srcProfile) {
+        t->dst_profile = *dstProfile;
+        dst = &t->dst_profile;
+    }
+
+    t->programSize = compile_program(srcFmt, srcAlpha, &t->src_profile, dstFmt, dstAlpha, dst,
+                                     &t->storage, t->program, t->context);
+    if (t->programSize == 0) {
+        free(t);
+        return nullptr;
+    }
+    return t;
+}
+
+void skcms_FreeTransform(skcms_CompiledTransform* t) {
+    free(t);
+}
+
+bool skcms_RunTransform(const skcms_CompiledTransform* t,
+                        const void* src,
+                        void*       dst,
+                        size_t      npixels) {
+    // Same limits as skcms_Transform().
+    if (npixels * t->dst_bpp > INT_MAX || npixels * t->src_bpp > INT_MAX) {
+        return false;
+    }
+    if (dst == src && t->dst_bpp != t->src_bpp) {
+        return false;
+    }
+    t->run(t->program, const_cast<const void**>(t->context), t->programSize,
+           (const char*)src, (char*)dst, (int)npixels, t->src_bpp, t->dst_bpp);
+    return true;
+}
+
+bool skcms_RunTransformRows(const skcms_CompiledTransform* t,
+                            const void* src, size_t srcRowBytes,
+                            void*       dst, size_t dstRowBytes,
+                            size_t width, size_t height) {
+    // Contiguous rows run as one long row.
+    if (srcRowBytes == width * t->src_bpp && dstRowBytes == width * t->dst_bpp &&
+        width * height * t->src_bpp <= INT_MAX && width * height * t->dst_bpp <= INT_MAX) {
+        return skcms_RunTransform(t, src, dst, width * height);
+    }
+    for (size_t y = 0; y < height; y++) {
+        if (!skcms_RunTransform(t, (const char*)src + y * srcRowBytes,
+                                   (char*)dst       + y * dstRowBytes, width)) {
+            return false;
+        }
+    }
     return true;
 }
 
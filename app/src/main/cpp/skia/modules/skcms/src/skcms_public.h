@@ -417,6 +417,36 @@ SKCMS_API bool skcms_Transform(const void*             src,
                                const skcms_ICCProfile* dstProfile,
                                size_t                  npixels);
 
+// skcms_Transform() plans its work (which curves, matrices and lookups to apply) on every call.
+// To convert many rows or tiles between the same formats and profiles, plan once with
+// skcms_MakeTransform() and run the result as often as needed.
+//
+// A compiled transform is immutable and may be run from multiple threads at once.  It keeps its
+// own copies of the profiles, but any ICC data those profiles were parsed from (table curves,
+// A2B/B2A grids) must outlive it.  Returns null if skcms_Transform() would fail for this pair.
+typedef struct skcms_CompiledTransform skcms_CompiledTransform;
+
+SKCMS_API skcms_CompiledTransform* skcms_MakeTransform(skcms_PixelFormat       srcFmt,
+                                                       skcms_AlphaFormat       srcAlpha,
+                                                       const skcms_ICCProfile* srcProfile,
+                                                       skcms_PixelFormat       dstFmt,
+                                                       skcms_AlphaFormat       dstAlpha,
+                                                       const skcms_ICCProfile* dstProfile);
+
+SKCMS_API void skcms_FreeTransform(skcms_CompiledTransform*);
+
+// Convert npixels pixels, with the same aliasing rules as skcms_Transform().
+SKCMS_API bool skcms_RunTransform(const skcms_CompiledTransform*,
+                                  const void* src,
+                                  void*       dst,
+                                  size_t      npixels);
+
+// Convert a batch of rows, each width pixels long.
+SKCMS_API bool skcms_RunTransformRows(const skcms_CompiledTransform*,
+                                      const void* src, size_t srcRowBytes,
+                                      void*       dst, size_t dstRowBytes,
+                                      size_t width, size_t height);
+
 // If profile can be used as a destination in skcms_Transform, return true. Otherwise, attempt to
 // rewrite it with approximations where reasonable. If successful, return true. If no reasonable
 // approximation exists, leave the profile unchanged and return false.
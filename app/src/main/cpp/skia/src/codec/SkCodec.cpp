@@ -25,6 +25,7 @@
 #include "src/codec/SkFrameHolder.h"
 #include "src/codec/SkPixmapUtilsPriv.h"
 #include "src/codec/SkSampler.h"
+#include "src/codec/SkSkcmsTransformCache.h"
 #include "src/core/SkColorPriv.h"
 
 #include <string>
@@ -266,6 +267,9 @@ SkCodec::~SkCodec() {}
 
 void SkCodec::setSrcXformFormat(XformFormat pixelFormat) {
     fSrcXformFormat = pixelFormat;
+    if (fXformTime != kNo_XformTime) {
+        this->compileColorXform();
+    }
 }
 
 bool SkCodec::queryYUVAInfo(const SkYUVAPixmapInfo::SupportedDataTypes& supportedDataTypes,
@@ -815,6 +819,7 @@ bool SkCodecPriv::SelectXformFormat(SkColorType colorType,
 bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Alpha encodedAlpha,
                                    bool srcIsOpaque) {
     fXformTime = kNo_XformTime;
+    fColorXform = nullptr;
     bool needsColorXform = false;
     if (this->usesColorXform()) {
         if (kRGBA_F16_SkColorType == dstInfo.colorType() ||
@@ -860,11 +865,24 @@ bool SkCodec::initializeColorXform(const SkImageInfo& dstInfo, SkEncodedInfo::Al
         } else {
             fDstXformAlphaFormat = skcms_AlphaFormat_Unpremul;
         }
+        this->compileColorXform();
     }
     return true;
 }
 
+void SkCodec::compileColorXform() {
+    // It is okay for srcProfile to be null. This will use sRGB.
+    const auto* srcProfile = fEncodedInfo.profile();
+    fColorXform = SkSkcmsTransformCache::FindOrMake(fSrcXformFormat, skcms_AlphaFormat_Unpremul,
+                                                    srcProfile, fDstXformFormat,
+                                                    fDstXformAlphaFormat, fDstProfile);
+}
+
 void SkCodec::applyColorXform(void* dst, const void* src, int count) const {
+    if (fColorXform) {
+        SkAssertResult(skcms_RunTransform(fColorXform.get(), src, dst, count));
+        return;
+    }
     // It is okay for srcProfile to be null. This will use sRGB.
     const auto* srcProfile = fEncodedInfo.profile();
     SkAssertResult(skcms_Transform(src, fSrcXformFormat, skcms_AlphaFormat_Unpremul, srcProfile,
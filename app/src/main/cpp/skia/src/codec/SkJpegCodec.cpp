@@ -26,14 +26,18 @@
 #include "src/codec/SkJpegDecoderMgr.h"
 #include "src/codec/SkJpegMetadataDecoderImpl.h"
 #include "src/codec/SkJpegPriv.h"
+#include "src/codec/SkJpegRestartStripes.h"
 #include "src/codec/SkParseEncodedOrigin.h"
 #include "src/codec/SkSwizzler.h"
+#include "src/core/SkTaskGroup.h"
 
 #ifdef SK_CODEC_DECODES_JPEG_GAINMAPS
 #include "include/private/SkGainmapInfo.h"
 #endif  // SK_CODEC_DECODES_JPEG_GAINMAPS
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <csetjmp>
 #include <cstring>
 #include <utility>
@@ -500,6 +504,11 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     }
 
     const bool isProgressive = dinfo->progressive_mode;
+    if (!isProgressive && options.fExecutor &&
+        kSuccess == this->decodeRestartStripes(dstInfo, dst, dstRowBytes, options)) {
+        return kSuccess;
+    }
+
     if (isProgressive) {
        dinfo->buffered_image = TRUE;
        jpeg_start_decompress(dinfo);
@@ -567,6 +576,122 @@ SkCodec::Result SkJpegCodec::onGetPixels(const SkImageInfo& dstInfo,
     return kSuccess;
 }
 
+SkCodec::Result SkJpegCodec::decodeRestartStripes(const SkImageInfo& dstInfo, void* dst,
+                                                  size_t dstRowBytes, const Options& options) {
+    // Splitting the image only pays for itself when every stripe has a reasonable amount of
+    // work, since each stripe re-parses the tables and decodes its neighbors' context rows.
+    static constexpr int kMinRowsPerStripe = 128;
+    static constexpr int kMaxStripes = 32;
+
+    SkASSERT(options.fExecutor);
+    SkASSERT(!options.fSubset);
+
+    jpeg_decompress_struct* dinfo = fDecoderMgr->dinfo();
+    if (dinfo->progressive_mode ||
+        needs_swizzler_to_convert_from_cmyk(dinfo->out_color_space,
+                                            this->getEncodedInfo().profile(),
+                                            this->colorXform())) {
+        return kUnimplemented;
+    }
+
+    const int maxStripes = std::min(kMaxStripes, this->dimensions().height() / kMinRowsPerStripe);
+    if (maxStripes < 2) {
+        return kUnimplemented;
+    }
+
+    // The stripes are spliced together from the encoded data, so it must all be in memory.
+    SkStream* stream = this->stream();
+    const void* memoryBase = stream->getMemoryBase();
+    if (!memoryBase || !stream->hasLength() || !IsJpeg(memoryBase, stream->getLength())) {
+        return kUnimplemented;
+    }
+    std::unique_ptr<SkJpegRestartStripes> stripes = SkJpegRestartStripes::Make(
+            SkData::MakeWithoutCopy(memoryBase, stream->getLength()), maxStripes);
+    if (!stripes) {
+        return kUnimplemented;
+    }
+
+    // Every stripe decoder must produce exactly what the serial decoder would.
+    const J_COLOR_SPACE outColorSpace = dinfo->out_color_space;
+    const J_DITHER_MODE ditherMode = dinfo->dither_mode;
+    const unsigned int scaleNum = dinfo->scale_num;
+    const unsigned int scaleDenom = dinfo->scale_denom;
+    const int dstWidth = dstInfo.width();
+    const int dstHeight = dstInfo.height();
+    const bool xformFromScratch =
+            this->colorXform() && sizeof(uint32_t) != dstInfo.bytesPerPixel();
+    auto scaleRows = [scaleNum, scaleDenom](int rows) {
+        return static_cast<int>(rows * scaleNum / scaleDenom);
+    };
+
+    std::atomic<bool> failed{false};
+    auto decodeStripe = [&](int index) {
+        const SkJpegRestartStripes::Stripe& stripe = stripes->stripe(index);
+        const int firstRow = scaleRows(stripe.fFirstRow);
+        const int contextRows = scaleRows(stripe.fLeadingContextRows);
+        const int rowCount = index + 1 == stripes->count() ? dstHeight - firstRow
+                                                           : scaleRows(stripe.fRowCount);
+
+        // Allocate everything before setjmp, so a longjmp cannot skip a destructor.
+        SkMemoryStream stripeStream(stripes->makeStripeData(index));
+        JpegDecoderMgr stripeMgr(&stripeStream);
+        AutoTMalloc<uint32_t> scratchRow(dstWidth);
+
+        skjpeg_error_mgr::AutoPushJmpBuf jmp(stripeMgr.errorMgr());
+        if (setjmp(jmp)) {
+            return stripeMgr.returnFalse("decodeStripe");
+        }
+
+        stripeMgr.init();
+        jpeg_decompress_struct* stripeInfo = stripeMgr.dinfo();
+        if (JPEG_HEADER_OK != jpeg_read_header(stripeInfo, TRUE)) {
+            return stripeMgr.returnFalse("decodeStripe");
+        }
+        stripeInfo->out_color_space = outColorSpace;
+        stripeInfo->dither_mode = ditherMode;
+        stripeInfo->scale_num = scaleNum;
+        stripeInfo->scale_denom = scaleDenom;
+        if (!jpeg_start_decompress(stripeInfo) ||
+            stripeInfo->output_width != (JDIMENSION)dstWidth ||
+            stripeInfo->output_height < (JDIMENSION)(contextRows + rowCount)) {
+            return stripeMgr.returnFalse("decodeStripe");
+        }
+
+        // The leading rows belong to the previous stripe and were only decoded so that the
+        // first rows of this stripe are upsampled with the correct context.
+        JSAMPLE* scratch = reinterpret_cast<JSAMPLE*>(scratchRow.get());
+        for (int y = 0; y < contextRows; y++) {
+            if (1 != jpeg_read_scanlines(stripeInfo, &scratch, 1)) {
+                return false;
+            }
+        }
+
+        void* dstRow = SkTAddOffset<void>(dst, firstRow * dstRowBytes);
+        for (int y = 0; y < rowCount; y++) {
+            JSAMPLE* decodeDst = xformFromScratch ? scratch : static_cast<JSAMPLE*>(dstRow);
+            if (1 != jpeg_read_scanlines(stripeInfo, &decodeDst, 1)) {
+                return false;
+            }
+            if (this->colorXform()) {
+                this->applyColorXform(dstRow, decodeDst, dstWidth);
+            }
+            dstRow = SkTAddOffset<void>(dstRow, dstRowBytes);
+        }
+        // The trailing context rows are never read. Destroying the decompressor aborts it.
+        return true;
+    };
+
+    SkTaskGroup taskGroup(*options.fExecutor);
+    taskGroup.batch(stripes->count(), [&](int index) {
+        if (!failed.load(std::memory_order_relaxed) && !decodeStripe(index)) {
+            failed.store(true, std::memory_order_relaxed);
+        }
+    });
+    taskGroup.wait();
+
+    return failed.load() ? kUnimplemented : kSuccess;
+}
+
 bool SkJpegCodec::allocateStorage(const SkImageInfo& dstInfo) {
     int dstWidth = dstInfo.width();
 
@@ -133,6 +133,14 @@ private:
     Result readRows(const SkImageInfo& dstInfo, void* dst, size_t rowBytes, int count,
                   const Options&, int* rowsDecoded);
 
+    /*
+     * Decodes independent restart-interval stripes concurrently on options.fExecutor.
+     * Returns kUnimplemented if the image or the requested conversion cannot be decoded this
+     * way, or if any stripe fails, in which case the caller should fall back to a serial decode.
+     */
+    Result decodeRestartStripes(const SkImageInfo& dstInfo, void* dst, size_t rowBytes,
+                                const Options&);
+
     /*
      * Scanline decoding.
      */
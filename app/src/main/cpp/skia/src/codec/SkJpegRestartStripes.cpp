@@ -0,0 +1,265 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkJpegRestartStripes.h"
+
+#include "include/core/SkData.h"
+#include "include/private/base/SkAssert.h"
+#include "src/codec/SkCodecPriv.h"
+#include "src/codec/SkJpegConstants.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace {
+
+constexpr uint8_t kMarkerSOF0 = 0xC0;  // Baseline DCT
+constexpr uint8_t kMarkerSOF1 = 0xC1;  // Extended sequential DCT, Huffman coding
+constexpr uint8_t kMarkerDHT = 0xC4;
+constexpr uint8_t kMarkerJPG = 0xC8;
+constexpr uint8_t kMarkerDAC = 0xCC;
+constexpr uint8_t kMarkerSOF15 = 0xCF;
+constexpr uint8_t kMarkerRST0 = 0xD0;
+constexpr uint8_t kMarkerRST7 = 0xD7;
+constexpr uint8_t kMarkerDRI = 0xDD;
+constexpr uint8_t kMarkerAPP15 = 0xEF;
+constexpr uint8_t kMarkerCOM = 0xFE;
+
+// DCT block size, in pixels.
+constexpr int kBlockSize = 8;
+
+uint16_t get_be16(const uint8_t* p) { return static_cast<uint16_t>((p[0] << 8) | p[1]); }
+
+int div_round_up(int a, int b) { return (a + b - 1) / b; }
+
+bool is_restart_marker(uint8_t marker) {
+    return marker >= kMarkerRST0 && marker <= kMarkerRST7;
+}
+
+bool is_unsupported_frame_marker(uint8_t marker) {
+    // Progressive, lossless, hierarchical and arithmetic coded frames cannot be split at
+    // restart markers with a single scan.
+    return marker > kMarkerSOF1 && marker <= kMarkerSOF15 &&
+           marker != kMarkerDHT && marker != kMarkerJPG && marker != kMarkerDAC;
+}
+
+}  // namespace
+
+std::unique_ptr<SkJpegRestartStripes> SkJpegRestartStripes::Make(sk_sp<SkData> data,
+                                                                  int maxStripes) {
+    if (!data || maxStripes < 2) {
+        return nullptr;
+    }
+    const uint8_t* bytes = data->bytes();
+    const size_t size = data->size();
+    if (size < 4 || bytes[0] != 0xFF || bytes[1] != kJpegMarkerStartOfImage) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SkJpegRestartStripes> stripes(new SkJpegRestartStripes);
+    std::vector<uint8_t>& header = stripes->fHeader;
+    header.push_back(0xFF);
+    header.push_back(kJpegMarkerStartOfImage);
+
+    bool foundFrame = false;
+    int width = 0;
+    int height = 0;
+    int numComponents = 0;
+    int maxH = 1;
+    int maxV = 1;
+    int restartInterval = 0;
+    size_t entropyStart = 0;
+
+    // Walk the header segments up to the StartOfScan.
+    size_t pos = 2;
+    while (entropyStart == 0) {
+        if (pos >= size || bytes[pos] != 0xFF) {
+            return nullptr;
+        }
+        // Markers may be preceded by any number of fill bytes.
+        while (pos < size && bytes[pos] == 0xFF) {
+            pos++;
+        }
+        if (pos + 1 + kJpegSegmentParameterLengthSize > size) {
+            return nullptr;
+        }
+        const uint8_t marker = bytes[pos++];
+        if (marker == kJpegMarkerEndOfImage || is_restart_marker(marker)) {
+            return nullptr;
+        }
+        const size_t length = get_be16(bytes + pos);
+        if (length < kJpegSegmentParameterLengthSize || pos + length > size) {
+            return nullptr;
+        }
+        const uint8_t* params = bytes + pos + kJpegSegmentParameterLengthSize;
+        const size_t paramsSize = length - kJpegSegmentParameterLengthSize;
+
+        bool keepSegment = true;
+        if (marker == kMarkerSOF0 || marker == kMarkerSOF1) {
+            if (foundFrame || paramsSize < 6) {
+                return nullptr;
+            }
+            // Only 8-bit samples are decoded by the JPEG codec.
+            if (params[0] != 8) {
+                return nullptr;
+            }
+            height = get_be16(params + 1);
+            width = get_be16(params + 3);
+            numComponents = params[5];
+            if (height == 0 || width == 0 || numComponents == 0 ||
+                paramsSize < 6 + 3 * static_cast<size_t>(numComponents)) {
+                return nullptr;
+            }
+            for (int i = 0; i < numComponents; ++i) {
+                const uint8_t sampling = params[6 + 3 * i + 1];
+                maxH = std::max(maxH, sampling >> 4);
+                maxV = std::max(maxV, sampling & 0xF);
+            }
+            // The height field follows the marker code, the length and the sample precision.
+            stripes->fHeightFieldOffset = header.size() + kJpegMarkerCodeSize +
+                                          kJpegSegmentParameterLengthSize + 1;
+            foundFrame = true;
+        } else if (is_unsupported_frame_marker(marker)) {
+            return nullptr;
+        } else if (marker == kMarkerDRI) {
+            if (paramsSize < 2) {
+                return nullptr;
+            }
+            restartInterval = get_be16(params);
+        } else if (marker == kJpegMarkerStartOfScan) {
+            // Multi-scan (non-interleaved) baseline images cannot be split into stripes.
+            if (!foundFrame || paramsSize < 1 || params[0] != numComponents) {
+                return nullptr;
+            }
+            entropyStart = pos + length;
+        } else if ((marker >= kJpegMarkerAPP0 && marker <= kMarkerAPP15) || marker == kMarkerCOM) {
+            // Metadata is not needed to decode the stripes.
+            keepSegment = false;
+        }
+
+        if (keepSegment) {
+            header.push_back(0xFF);
+            header.push_back(marker);
+            header.insert(header.end(), bytes + pos, bytes + pos + length);
+        }
+        pos += length;
+    }
+
+    if (restartInterval == 0) {
+        return nullptr;
+    }
+
+    // A non-interleaved scan of a single component uses one block per MCU, regardless of the
+    // sampling factors.
+    const int mcuWidth = numComponents == 1 ? kBlockSize : kBlockSize * maxH;
+    const int mcuHeight = numComponents == 1 ? kBlockSize : kBlockSize * maxV;
+    const int mcusPerRow = div_round_up(width, mcuWidth);
+    const int mcuRows = div_round_up(height, mcuHeight);
+    if (restartInterval % mcusPerRow != 0) {
+        // Intervals that do not start at the left edge cannot begin a stripe.
+        return nullptr;
+    }
+    const int mcuRowsPerInterval = restartInterval / mcusPerRow;
+    const int expectedIntervals = div_round_up(mcuRows, mcuRowsPerInterval);
+    if (expectedIntervals < 2) {
+        return nullptr;
+    }
+
+    // Find the restart markers in the entropy-coded data.
+    std::vector<Interval>& intervals = stripes->fIntervals;
+    intervals.reserve(expectedIntervals);
+    size_t segmentStart = entropyStart;
+    pos = entropyStart;
+    while (true) {
+        const uint8_t* sentinel =
+                reinterpret_cast<const uint8_t*>(memchr(bytes + pos, 0xFF, size - pos));
+        if (!sentinel) {
+            // Truncated. Let the serial decoder handle partial data.
+            return nullptr;
+        }
+        const size_t markerStart = sentinel - bytes;
+        size_t markerPos = markerStart + 1;
+        while (markerPos < size && bytes[markerPos] == 0xFF) {
+            markerPos++;
+        }
+        if (markerPos >= size) {
+            return nullptr;
+        }
+        const uint8_t marker = bytes[markerPos];
+        if (marker == 0x00) {
+            // A stuffed zero byte is part of the entropy-coded data.
+            pos = markerPos + 1;
+            continue;
+        }
+        intervals.push_back({segmentStart, markerStart - segmentStart});
+        if (!is_restart_marker(marker)) {
+            // Any other marker ends the scan.
+            break;
+        }
+        const size_t expectedMarker = kMarkerRST0 + (intervals.size() - 1) % 8;
+        if (marker != expectedMarker || intervals.size() >= (size_t)expectedIntervals) {
+            return nullptr;
+        }
+        segmentStart = pos = markerPos + 1;
+    }
+    if (intervals.size() != (size_t)expectedIntervals) {
+        return nullptr;
+    }
+
+    stripes->fData = std::move(data);
+    stripes->fImageHeight = height;
+    stripes->fMCURowHeight = mcuHeight;
+    stripes->fMCURowsPerInterval = mcuRowsPerInterval;
+
+    const int rowsPerInterval = mcuRowsPerInterval * mcuHeight;
+    const int numStripes = std::min(maxStripes, expectedIntervals);
+    for (int i = 0; i < numStripes; ++i) {
+        const int first = i * expectedIntervals / numStripes;
+        const int last = (i + 1) * expectedIntervals / numStripes;
+        const int decodeFirst = first > 0 ? first - 1 : first;
+        const int decodeLast = last < expectedIntervals ? last + 1 : last;
+        stripes->fStripeIntervals.emplace_back(decodeFirst, decodeLast);
+
+        Stripe stripe;
+        stripe.fFirstRow = first * rowsPerInterval;
+        stripe.fRowCount = std::min(last * rowsPerInterval, height) - stripe.fFirstRow;
+        stripe.fLeadingContextRows = (first - decodeFirst) * rowsPerInterval;
+        stripes->fStripes.push_back(stripe);
+    }
+    return stripes;
+}
+
+sk_sp<SkData> SkJpegRestartStripes::makeStripeData(int i) const {
+    SkASSERT(i >= 0 && i < this->count());
+    const auto [first, last] = fStripeIntervals[i];
+    const int rowsPerInterval = fMCURowsPerInterval * fMCURowHeight;
+    const int height = std::min(last * rowsPerInterval, fImageHeight) - first * rowsPerInterval;
+
+    size_t size = fHeader.size() + kJpegMarkerCodeSize * (last - first);
+    for (int j = first; j < last; ++j) {
+        size += fIntervals[j].fSize;
+    }
+
+    sk_sp<SkData> stripeData = SkData::MakeUninitialized(size);
+    uint8_t* dst = static_cast<uint8_t*>(stripeData->writable_data());
+    memcpy(dst, fHeader.data(), fHeader.size());
+    dst[fHeightFieldOffset] = static_cast<uint8_t>(height >> 8);
+    dst[fHeightFieldOffset + 1] = static_cast<uint8_t>(height & 0xFF);
+    dst += fHeader.size();
+
+    for (int j = first; j < last; ++j) {
+        const Interval& interval = fIntervals[j];
+        memcpy(dst, fData->bytes() + interval.fOffset, interval.fSize);
+        dst += interval.fSize;
+        *dst++ = 0xFF;
+        // The decoder expects restart markers to count up from RST0.
+        *dst++ = j + 1 < last ? kMarkerRST0 + (j - first) % 8 : kJpegMarkerEndOfImage;
+    }
+    SkASSERT(dst == stripeData->bytes() + size);
+    return stripeData;
+}
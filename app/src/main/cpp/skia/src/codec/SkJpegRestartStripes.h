@@ -0,0 +1,90 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkJpegRestartStripes_codec_DEFINED
+#define SkJpegRestartStripes_codec_DEFINED
+
+#include "include/core/SkRefCnt.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+class SkData;
+
+/*
+ * Splits a baseline, single-scan JPEG whose restart interval covers a whole number of MCU rows
+ * into horizontal stripes that can be decoded independently.
+ *
+ * Restart markers reset the DC predictors and the entropy decoder, so every restart interval
+ * that starts at the left edge of the image can be decoded without knowing anything about the
+ * data before it. Each stripe is handed to its own decompressor as a synthesized, standalone
+ * JPEG: the tables from the original header, a frame header whose height is patched to the
+ * stripe height, the stripe's entropy-coded segments (with their restart markers renumbered
+ * from zero), and an EndOfImage marker.
+ *
+ * Chroma upsampling needs one row of context above and below each output row. To keep the
+ * result identical to a serial decode, each stripe also contains the restart interval before
+ * and after it (when those exist). The decoder discards the leading rows and stops before the
+ * trailing ones.
+ */
+class SkJpegRestartStripes {
+public:
+    struct Stripe {
+        // The first image row written by this stripe, and the number of rows it writes.
+        int fFirstRow = 0;
+        int fRowCount = 0;
+        // Number of rows at the top of the synthesized image that belong to the previous stripe
+        // and only exist to provide upsampling context.
+        int fLeadingContextRows = 0;
+    };
+
+    /*
+     * Returns nullptr if |data| is not a baseline JPEG with usable restart intervals, or if
+     * it cannot be split into at least two stripes. |maxStripes| bounds the number of
+     * stripes returned; the restart intervals are distributed evenly among them.
+     */
+    static std::unique_ptr<SkJpegRestartStripes> Make(sk_sp<SkData> data, int maxStripes);
+
+    int count() const { return static_cast<int>(fStripes.size()); }
+    const Stripe& stripe(int i) const { return fStripes[i]; }
+
+    /*
+     * Synthesizes the standalone JPEG for stripe |i|. This is safe to call concurrently for
+     * different stripes.
+     */
+    sk_sp<SkData> makeStripeData(int i) const;
+
+private:
+    // The byte range of one restart interval's entropy-coded data, excluding the restart marker
+    // that terminates it.
+    struct Interval {
+        size_t fOffset;
+        size_t fSize;
+    };
+
+    SkJpegRestartStripes() = default;
+
+    sk_sp<SkData>         fData;
+    // Every segment of the original header needed for decoding (APPn and COM are dropped), up to
+    // and including the StartOfScan segment.
+    std::vector<uint8_t>  fHeader;
+    // Offset in |fHeader| of the frame height field of the StartOfFrame segment.
+    size_t                fHeightFieldOffset = 0;
+    int                   fImageHeight = 0;
+    int                   fMCURowHeight = 0;
+    int                   fMCURowsPerInterval = 0;
+    std::vector<Interval> fIntervals;
+    // For each stripe, the first and one-past-last restart interval that it decodes, including
+    // context intervals.
+    std::vector<std::pair<int, int>> fStripeIntervals;
+    std::vector<Stripe>   fStripes;
+};
+
+#endif
@@ -16,375 +16,107 @@
 #include "src/core/SkColorData.h"
 #include "src/core/SkMasks.h"
 
-static void swizzle_mask16_to_rgba_opaque(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPackARGB_as_RGBA(0xFF, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask16_to_bgra_opaque(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPackARGB_as_BGRA(0xFF, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask16_to_rgba_unpremul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkPackARGB_as_RGBA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask16_to_bgra_unpremul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkPackARGB_as_BGRA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask16_to_rgba_premul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkCodecPriv::PremultiplyARGBasRGBA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+namespace {
+
+enum class MaskDst {
+    kRGBA_Opaque,
+    kBGRA_Opaque,
+    kRGBA_Unpremul,
+    kBGRA_Unpremul,
+    kRGBA_Premul,
+    kBGRA_Premul,
+    k565,
+};
+
+using U32x8 = SkMasks::Pixels;
+
+// Same as SkMulDiv255Round().
+SK_ALWAYS_INLINE U32x8 mul_div_255_round(const U32x8& x, const U32x8& a) {
+    U32x8 prod = x * a + 128;
+    return (prod + (prod >> 8)) >> 8;
 }
 
-static void swizzle_mask16_to_bgra_premul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkCodecPriv::PremultiplyARGBasBGRA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-// TODO (msarett): We have promoted a two byte per pixel image to 8888, only to
-// convert it back to 565. Instead, we should swizzle to 565 directly.
-static void swizzle_mask16_to_565(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint16_t* srcPtr = ((const uint16_t*) srcRow) + startX;
-    uint16_t* dstPtr = (uint16_t*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint16_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPack888ToRGB16(red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask24_to_rgba_opaque(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPackARGB_as_RGBA(0xFF, red, green, blue);
-        srcRow += 3 * sampleX;
+template <MaskDst kDst>
+SK_ALWAYS_INLINE U32x8 pack(const U32x8& px, const SkMasks& masks) {
+    U32x8 r = masks.getReds(px),
+          g = masks.getGreens(px),
+          b = masks.getBlues(px);
+    if constexpr (kDst == MaskDst::k565) {
+        return (r >> (8 - SK_R16_BITS)) << SK_R16_SHIFT |
+               (g >> (8 - SK_G16_BITS)) << SK_G16_SHIFT |
+               (b >> (8 - SK_B16_BITS)) << SK_B16_SHIFT;
+    } else {
+        U32x8 a = 0xFF;
+        if constexpr (kDst != MaskDst::kRGBA_Opaque && kDst != MaskDst::kBGRA_Opaque) {
+            a = masks.getAlphas(px);
+        }
+        if constexpr (kDst == MaskDst::kRGBA_Premul || kDst == MaskDst::kBGRA_Premul) {
+            r = mul_div_255_round(r, a);
+            g = mul_div_255_round(g, a);
+            b = mul_div_255_round(b, a);
+        }
+        if constexpr (kDst == MaskDst::kRGBA_Opaque || kDst == MaskDst::kRGBA_Unpremul ||
+                      kDst == MaskDst::kRGBA_Premul) {
+            return a << SK_RGBA_A32_SHIFT | r << SK_RGBA_R32_SHIFT |
+                   g << SK_RGBA_G32_SHIFT | b << SK_RGBA_B32_SHIFT;
+        } else {
+            return a << SK_BGRA_A32_SHIFT | r << SK_BGRA_R32_SHIFT |
+                   g << SK_BGRA_G32_SHIFT | b << SK_BGRA_B32_SHIFT;
+        }
     }
 }
 
-static void swizzle_mask24_to_bgra_opaque(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPackARGB_as_BGRA(0xFF, red, green, blue);
-        srcRow += 3 * sampleX;
+template <int kBytesPerPixel>
+SK_ALWAYS_INLINE uint32_t load_pixel(const uint8_t* src) {
+    if constexpr (kBytesPerPixel == 2) {
+        uint16_t p;
+        memcpy(&p, src, 2);
+        return p;
+    } else if constexpr (kBytesPerPixel == 3) {
+        return src[0] | (src[1] << 8) | src[2] << 16;
+    } else {
+        static_assert(kBytesPerPixel == 4);
+        uint32_t p;
+        memcpy(&p, src, 4);
+        return p;
     }
 }
 
-static void swizzle_mask24_to_rgba_unpremul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkPackARGB_as_RGBA(alpha, red, green, blue);
-        srcRow += 3 * sampleX;
+// Decodes 8 pixels at a time. The pixels are loaded one by one, which handles 24-bit pixels and
+// sampling, and then the masks are applied to all of them at once.
+template <int kBytesPerPixel, MaskDst kDst>
+void swizzle_mask(void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
+                  uint32_t startX, uint32_t sampleX) {
+    using DstT = std::conditional_t<kDst == MaskDst::k565, uint16_t, uint32_t>;
+    constexpr int N = sizeof(U32x8) / sizeof(uint32_t);
+
+    const uint8_t* src = srcRow + kBytesPerPixel * startX;
+    const size_t deltaSrc = kBytesPerPixel * sampleX;
+    DstT* dst = static_cast<DstT*>(dstRow);
+
+    uint32_t pixels[N] = {};
+    for (int x = 0; x < width; x += N) {
+        const int n = std::min(N, width - x);
+        for (int i = 0; i < n; i++) {
+            pixels[i] = load_pixel<kBytesPerPixel>(src);
+            src += deltaSrc;
+        }
+        const U32x8 packed = pack<kDst>(U32x8::Load(pixels), *masks);
+        if (n == N) {
+            skvx::cast<DstT>(packed).store(dst + x);
+        } else {
+            DstT tail[N];
+            skvx::cast<DstT>(packed).store(tail);
+            memcpy(dst + x, tail, n * sizeof(DstT));
+        }
     }
 }
 
-static void swizzle_mask24_to_bgra_unpremul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkPackARGB_as_BGRA(alpha, red, green, blue);
-        srcRow += 3 * sampleX;
-    }
-}
-
-static void swizzle_mask24_to_rgba_premul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkCodecPriv::PremultiplyARGBasRGBA(alpha, red, green, blue);
-        srcRow += 3 * sampleX;
-    }
-}
-
-static void swizzle_mask24_to_bgra_premul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkCodecPriv::PremultiplyARGBasBGRA(alpha, red, green, blue);
-        srcRow += 3 * sampleX;
-    }
-}
-
-static void swizzle_mask24_to_565(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    srcRow += 3 * startX;
-    uint16_t* dstPtr = (uint16_t*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcRow[0] | (srcRow[1] << 8) | srcRow[2] << 16;
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPack888ToRGB16(red, green, blue);
-        srcRow += 3 * sampleX;
-    }
-}
-
-static void swizzle_mask32_to_rgba_opaque(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPackARGB_as_RGBA(0xFF, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask32_to_bgra_opaque(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPackARGB_as_BGRA(0xFF, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask32_to_rgba_unpremul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkPackARGB_as_RGBA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask32_to_bgra_unpremul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkPackARGB_as_BGRA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask32_to_rgba_premul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkCodecPriv::PremultiplyARGBasRGBA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask32_to_bgra_premul(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    SkPMColor* dstPtr = (SkPMColor*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        uint8_t alpha = masks->getAlpha(p);
-        dstPtr[i] = SkCodecPriv::PremultiplyARGBasBGRA(alpha, red, green, blue);
-        srcPtr += sampleX;
-    }
-}
-
-static void swizzle_mask32_to_565(
-        void* dstRow, const uint8_t* srcRow, int width, SkMasks* masks,
-        uint32_t startX, uint32_t sampleX) {
-    // Use the masks to decode to the destination
-    const uint32_t* srcPtr = ((const uint32_t*) srcRow) + startX;
-    uint16_t* dstPtr = (uint16_t*) dstRow;
-    for (int i = 0; i < width; i++) {
-        uint32_t p = srcPtr[0];
-        uint8_t red = masks->getRed(p);
-        uint8_t green = masks->getGreen(p);
-        uint8_t blue = masks->getBlue(p);
-        dstPtr[i] = SkPack888ToRGB16(red, green, blue);
-        srcPtr += sampleX;
-    }
-}
+}  // namespace
 
 /*
  *
@@ -402,14 +134,14 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
             switch (dstInfo.colorType()) {
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
-                        proc = &swizzle_mask16_to_rgba_opaque;
+                        proc = &swizzle_mask<2, MaskDst::kRGBA_Opaque>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
-                                proc = &swizzle_mask16_to_rgba_unpremul;
+                                proc = &swizzle_mask<2, MaskDst::kRGBA_Unpremul>;
                                 break;
                             case kPremul_SkAlphaType:
-                                proc = &swizzle_mask16_to_rgba_premul;
+                                proc = &swizzle_mask<2, MaskDst::kRGBA_Premul>;
                                 break;
                             default:
                                 break;
@@ -418,14 +150,14 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                     break;
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
-                        proc = &swizzle_mask16_to_bgra_opaque;
+                        proc = &swizzle_mask<2, MaskDst::kBGRA_Opaque>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
-                                proc = &swizzle_mask16_to_bgra_unpremul;
+                                proc = &swizzle_mask<2, MaskDst::kBGRA_Unpremul>;
                                 break;
                             case kPremul_SkAlphaType:
-                                proc = &swizzle_mask16_to_bgra_premul;
+                                proc = &swizzle_mask<2, MaskDst::kBGRA_Premul>;
                                 break;
                             default:
                                 break;
@@ -433,7 +165,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                     }
                     break;
                 case kRGB_565_SkColorType:
-                    proc = &swizzle_mask16_to_565;
+                    proc = &swizzle_mask<2, MaskDst::k565>;
                     break;
                 default:
                     break;
@@ -443,14 +175,14 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
             switch (dstInfo.colorType()) {
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
-                        proc = &swizzle_mask24_to_rgba_opaque;
+                        proc = &swizzle_mask<3, MaskDst::kRGBA_Opaque>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
-                                proc = &swizzle_mask24_to_rgba_unpremul;
+                                proc = &swizzle_mask<3, MaskDst::kRGBA_Unpremul>;
                                 break;
                             case kPremul_SkAlphaType:
-                                proc = &swizzle_mask24_to_rgba_premul;
+                                proc = &swizzle_mask<3, MaskDst::kRGBA_Premul>;
                                 break;
                             default:
                                 break;
@@ -459,14 +191,14 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                     break;
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
-                        proc = &swizzle_mask24_to_bgra_opaque;
+                        proc = &swizzle_mask<3, MaskDst::kBGRA_Opaque>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
-                                proc = &swizzle_mask24_to_bgra_unpremul;
+                                proc = &swizzle_mask<3, MaskDst::kBGRA_Unpremul>;
                                 break;
                             case kPremul_SkAlphaType:
-                                proc = &swizzle_mask24_to_bgra_premul;
+                                proc = &swizzle_mask<3, MaskDst::kBGRA_Premul>;
                                 break;
                             default:
                                 break;
@@ -474,7 +206,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                     }
                     break;
                 case kRGB_565_SkColorType:
-                    proc = &swizzle_mask24_to_565;
+                    proc = &swizzle_mask<3, MaskDst::k565>;
                     break;
                 default:
                     break;
@@ -484,14 +216,14 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
             switch (dstInfo.colorType()) {
                 case kRGBA_8888_SkColorType:
                     if (srcIsOpaque) {
-                        proc = &swizzle_mask32_to_rgba_opaque;
+                        proc = &swizzle_mask<4, MaskDst::kRGBA_Opaque>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
-                                proc = &swizzle_mask32_to_rgba_unpremul;
+                                proc = &swizzle_mask<4, MaskDst::kRGBA_Unpremul>;
                                 break;
                             case kPremul_SkAlphaType:
-                                proc = &swizzle_mask32_to_rgba_premul;
+                                proc = &swizzle_mask<4, MaskDst::kRGBA_Premul>;
                                 break;
                             default:
                                 break;
@@ -500,14 +232,14 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                     break;
                 case kBGRA_8888_SkColorType:
                     if (srcIsOpaque) {
-                        proc = &swizzle_mask32_to_bgra_opaque;
+                        proc = &swizzle_mask<4, MaskDst::kBGRA_Opaque>;
                     } else {
                         switch (dstInfo.alphaType()) {
                             case kUnpremul_SkAlphaType:
-                                proc = &swizzle_mask32_to_bgra_unpremul;
+                                proc = &swizzle_mask<4, MaskDst::kBGRA_Unpremul>;
                                 break;
                             case kPremul_SkAlphaType:
-                                proc = &swizzle_mask32_to_bgra_premul;
+                                proc = &swizzle_mask<4, MaskDst::kBGRA_Premul>;
                                 break;
                             default:
                                 break;
@@ -515,7 +247,7 @@ SkMaskSwizzler* SkMaskSwizzler::CreateMaskSwizzler(const SkImageInfo& dstInfo,
                     }
                     break;
                 case kRGB_565_SkColorType:
-                    proc = &swizzle_mask32_to_565;
+                    proc = &swizzle_mask<4, MaskDst::k565>;
                     break;
                 default:
                     break;
@@ -23,6 +23,7 @@
 #include "modules/skcms/skcms.h"
 #include "src/codec/SkCodecPriv.h"
 #include "src/codec/SkJpegCodec.h"
+#include "src/codec/SkSkcmsTransformCache.h"
 #include "src/core/SkStreamPriv.h"
 #include "src/core/SkTaskGroup.h"
 
@@ -777,6 +778,12 @@ SkCodec::Result SkRawCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
         cs->toProfile(&dstProfileStorage);
         dstProfile = &dstProfileStorage;
     }
+    const SkSkcmsTransformCache::Transform transform = SkSkcmsTransformCache::FindOrMake(
+            srcFormat, skcms_AlphaFormat_Unpremul, srcProfile,
+            dstFormat, skcms_AlphaFormat_Unpremul, dstProfile);
+    if (!transform) {
+        return kInvalidConversion;
+    }
 
     for (int i = 0; i < height; ++i) {
         buffer.fArea = dng_rect(i, 0, i + 1, width);
@@ -788,9 +795,7 @@ SkCodec::Result SkRawCodec::onGetPixels(const SkImageInfo& dstInfo, void* dst,
             return kIncompleteInput;
         }
 
-        if (!skcms_Transform(&srcRow[0], srcFormat, skcms_AlphaFormat_Unpremul, srcProfile,
-                             dstRow,     dstFormat, skcms_AlphaFormat_Unpremul, dstProfile,
-                             dstInfo.width())) {
+        if (!skcms_RunTransform(transform.get(), &srcRow[0], dstRow, dstInfo.width())) {
             SkDebugf("failed to transform\n");
             *rowsDecoded = i;
             return kInternalError;
@@ -0,0 +1,134 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/codec/SkSkcmsTransformCache.h"
+
+#include "include/private/base/SkMutex.h"
+#include "src/base/SkNoDestructor.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkLRUCache.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace {
+
+// Everything skcms reads from a profile without A2B or B2A. All fields are 4 bytes wide, so
+// there is no padding to disturb hashing and comparing the raw bytes.
+struct ProfileKey {
+    uint32_t               fDataColorSpace;
+    uint32_t               fHasTRC;
+    uint32_t               fHasToXYZD50;
+    skcms_TransferFunction fTRC[3];
+    skcms_Matrix3x3        fToXYZD50;
+};
+
+struct Key {
+    ProfileKey fSrc;
+    ProfileKey fDst;
+    uint32_t   fSrcFormat;
+    uint32_t   fSrcAlpha;
+    uint32_t   fDstFormat;
+    uint32_t   fDstAlpha;
+    // skcms skips the conversion entirely when both ends share a profile pointer.
+    uint32_t   fSameProfile;
+
+    bool operator==(const Key& that) const { return 0 == memcmp(this, &that, sizeof(Key)); }
+};
+
+struct KeyHash {
+    uint32_t operator()(const Key& key) const { return SkChecksum::Hash32(&key, sizeof(Key)); }
+};
+
+bool is_self_contained(const skcms_ICCProfile* profile) {
+    if (profile->has_A2B || profile->has_B2A) {
+        return false;
+    }
+    for (const skcms_Curve& curve : profile->trc) {
+        if (curve.table_entries != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void make_profile_key(const skcms_ICCProfile* profile, ProfileKey* key) {
+    key->fDataColorSpace = profile->data_color_space;
+    key->fHasTRC = profile->has_trc;
+    key->fHasToXYZD50 = profile->has_toXYZD50;
+    for (int i = 0; i < 3; ++i) {
+        key->fTRC[i] = profile->trc[i].parametric;
+    }
+    key->fToXYZD50 = profile->toXYZD50;
+}
+
+SkSkcmsTransformCache::Transform compile(skcms_PixelFormat srcFormat,
+                                         skcms_AlphaFormat srcAlpha,
+                                         const skcms_ICCProfile* srcProfile,
+                                         skcms_PixelFormat dstFormat,
+                                         skcms_AlphaFormat dstAlpha,
+                                         const skcms_ICCProfile* dstProfile) {
+    skcms_CompiledTransform* transform = skcms_MakeTransform(srcFormat, srcAlpha, srcProfile,
+                                                             dstFormat, dstAlpha, dstProfile);
+    if (!transform) {
+        return nullptr;
+    }
+    return SkSkcmsTransformCache::Transform(transform, skcms_FreeTransform);
+}
+
+}  // namespace
+
+namespace SkSkcmsTransformCache {
+
+Transform FindOrMake(skcms_PixelFormat srcFormat, skcms_AlphaFormat srcAlpha,
+                     const skcms_ICCProfile* srcProfile,
+                     skcms_PixelFormat dstFormat, skcms_AlphaFormat dstAlpha,
+                     const skcms_ICCProfile* dstProfile) {
+    if (!srcProfile) {
+        srcProfile = skcms_sRGB_profile();
+    }
+    if (!dstProfile) {
+        dstProfile = skcms_sRGB_profile();
+    }
+    if (!is_self_contained(srcProfile) || !is_self_contained(dstProfile)) {
+        return compile(srcFormat, srcAlpha, srcProfile, dstFormat, dstAlpha, dstProfile);
+    }
+
+    Key key;
+    memset(&key, 0, sizeof(Key));
+    make_profile_key(srcProfile, &key.fSrc);
+    make_profile_key(dstProfile, &key.fDst);
+    key.fSrcFormat = srcFormat;
+    key.fSrcAlpha = srcAlpha;
+    key.fDstFormat = dstFormat;
+    key.fDstAlpha = dstAlpha;
+    key.fSameProfile = srcProfile == dstProfile;
+
+    static SkNoDestructor<SkMutex> mutex;
+    static SkNoDestructor<SkLRUCache<Key, Transform, KeyHash>> cache(32 /*arbitrary*/);
+    {
+        SkAutoMutexExclusive lock(*mutex);
+        if (Transform* found = cache->find(key)) {
+            return *found;
+        }
+    }
+
+    // Compile outside of the lock. If another thread races us here, the loser's transform is
+    // simply dropped.
+    Transform transform = compile(srcFormat, srcAlpha, srcProfile,
+                                  dstFormat, dstAlpha, dstProfile);
+    if (transform) {
+        SkAutoMutexExclusive lock(*mutex);
+        if (Transform* found = cache->find(key)) {
+            return *found;
+        }
+        cache->insert(key, transform);
+    }
+    return transform;
+}
+
+}  // namespace SkSkcmsTransformCache
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkSkcmsTransformCache_DEFINED
+#define SkSkcmsTransformCache_DEFINED
+
+#include "modules/skcms/skcms.h"
+
+#include <memory>
+
+/*
+ * A process-wide cache of compiled skcms transforms, keyed by the pixel formats, alpha formats and
+ * profiles at either end.
+ *
+ * Only profiles that are fully described by their skcms_ICCProfile (parametric TRC curves and a
+ * toXYZD50 matrix, without A2B or B2A) are cached. Other profiles point into ICC data that the
+ * cache cannot keep alive, so transforms involving them are compiled anew on each call.
+ */
+namespace SkSkcmsTransformCache {
+
+using Transform = std::shared_ptr<const skcms_CompiledTransform>;
+
+/*
+ * Returns a compiled transform for the given conversion, or nullptr if skcms does not support
+ * it. Null profiles mean sRGB, as in skcms_Transform().
+ */
+Transform FindOrMake(skcms_PixelFormat srcFormat, skcms_AlphaFormat srcAlpha,
+                     const skcms_ICCProfile* srcProfile,
+                     skcms_PixelFormat dstFormat, skcms_AlphaFormat dstAlpha,
+                     const skcms_ICCProfile* dstProfile);
+
+}  // namespace SkSkcmsTransformCache
+
+#endif
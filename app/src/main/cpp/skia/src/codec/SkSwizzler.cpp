@@ -26,7 +26,9 @@
     #include "include/android/SkAndroidFrameworkUtils.h"
 #endif
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 
 static void copy(void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -255,6 +257,17 @@ static void swizzle_index_to_n32(
     }
 }
 
+static void fast_swizzle_index_to_n32(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::index_to_8888((uint32_t*) dst, src + offset, width, ctable);
+}
+
 static void swizzle_index_to_n32_skipZ(
         void* SK_RESTRICT dstRow, const uint8_t* SK_RESTRICT src, int dstWidth,
         int bpp, int deltaSrc, int offset, const SkPMColor ctable[]) {
@@ -281,6 +294,30 @@ static void swizzle_index_to_565(
     }
 }
 
+static void fast_swizzle_index_to_565(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    // The table holds 8888 colors, so look them up in chunks and pack each chunk to 565.
+    src += offset;
+    uint16_t* dst16 = (uint16_t*) dst;
+    uint32_t colors[64];
+    while (width > 0) {
+        int n = std::min(width, (int) std::size(colors));
+        SkOpts::index_to_8888(colors, src, n, ctable);
+        for (int x = 0; x < n; x++) {
+            dst16[x] = SkPixel32ToPixel16(colors[x]);
+        }
+        src += n;
+        dst16 += n;
+        width -= n;
+    }
+}
+
 // kGray
 
 static void swizzle_gray_to_n32(
@@ -320,6 +357,17 @@ static void swizzle_gray_to_565(
     }
 }
 
+static void fast_swizzle_gray_to_565(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::gray_to_565((uint16_t*) dst, src + offset, width);
+}
+
 // kGrayAlpha
 
 static void swizzle_grayalpha_to_n32_unpremul(
@@ -397,6 +445,17 @@ static void swizzle_bgr_to_565(
     }
 }
 
+static void fast_swizzle_bgr_to_565(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::BGR_to_565((uint16_t*) dst, src + offset, width);
+}
+
 // kRGB
 
 static void swizzle_rgb_to_rgba(
@@ -457,6 +516,17 @@ static void swizzle_rgb_to_565(
     }
 }
 
+static void fast_swizzle_rgb_to_565(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB_to_565((uint16_t*) dst, src + offset, width);
+}
+
 // kRGBA
 
 static void swizzle_rgba_to_rgba_premul(
@@ -576,6 +646,39 @@ static void swizzle_rgb16_to_565(
     }
 }
 
+static void fast_swizzle_rgb16_to_rgba(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_RGB1((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgb16_to_bgra(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_BGR1((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgb16_to_565(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGB16_to_565((uint16_t*) dst, src + offset, width);
+}
+
 static void swizzle_rgba16_to_rgba_unpremul(
         void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
         const SkPMColor ctable[]) {
@@ -636,6 +739,53 @@ static void swizzle_rgba16_to_bgra_premul(
     }
 }
 
+static void fast_swizzle_rgba16_to_rgba_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_bgra_unpremul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+}
+
+static void fast_swizzle_rgba16_to_rgba_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    // Premultiplying does not depend on the channel order, so it can be done in place.
+    SkOpts::RGBA16_to_RGBA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, (const uint32_t*) dst, width);
+}
+
+static void fast_swizzle_rgba16_to_bgra_premul(
+        void* dst, const uint8_t* src, int width, int bpp, int deltaSrc, int offset,
+        const SkPMColor ctable[]) {
+
+    // This function must not be called if we are sampling.  If we are not
+    // sampling, deltaSrc should equal bpp.
+    SkASSERT(deltaSrc == bpp);
+
+    SkOpts::RGBA16_to_BGRA((uint32_t*) dst, src + offset, width);
+    SkOpts::RGBA_to_rgbA((uint32_t*) dst, (const uint32_t*) dst, width);
+}
+
 // kCMYK
 //
 // CMYK is stored as four bytes per pixel.
@@ -876,6 +1026,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                             break;
                         case kRGB_565_SkColorType:
                             proc = &swizzle_gray_to_565;
+                            fastProc = &fast_swizzle_gray_to_565;
                             break;
                         default:
                             return nullptr;
@@ -947,10 +1098,12 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                                 proc = &swizzle_index_to_n32_skipZ;
                             } else {
                                 proc = &swizzle_index_to_n32;
+                                fastProc = &fast_swizzle_index_to_n32;
                             }
                             break;
                         case kRGB_565_SkColorType:
                             proc = &swizzle_index_to_565;
+                            fastProc = &fast_swizzle_index_to_565;
                             break;
                         default:
                             return nullptr;
@@ -969,6 +1122,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kRGBA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_rgba;
+                        fastProc = &fast_swizzle_rgb16_to_rgba;
                         break;
                     }
 
@@ -979,6 +1133,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kBGRA_8888_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_bgra;
+                        fastProc = &fast_swizzle_rgb16_to_bgra;
                         break;
                     }
 
@@ -989,10 +1144,12 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                 case kRGB_565_SkColorType:
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = &swizzle_rgb16_to_565;
+                        fastProc = &fast_swizzle_rgb16_to_565;
                         break;
                     }
 
                     proc = &swizzle_rgb_to_565;
+                    fastProc = &fast_swizzle_rgb_to_565;
                     break;
                 default:
                     return nullptr;
@@ -1004,6 +1161,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_rgba_premul :
                                              &swizzle_rgba16_to_rgba_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_rgba_premul :
+                                                 &fast_swizzle_rgba16_to_rgba_unpremul;
                         break;
                     }
 
@@ -1031,6 +1190,8 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     if (16 == encodedInfo.bitsPerComponent()) {
                         proc = premultiply ? &swizzle_rgba16_to_bgra_premul :
                                              &swizzle_rgba16_to_bgra_unpremul;
+                        fastProc = premultiply ? &fast_swizzle_rgba16_to_bgra_premul :
+                                                 &fast_swizzle_rgba16_to_bgra_unpremul;
                         break;
                     }
 
@@ -1071,6 +1232,7 @@ std::unique_ptr<SkSwizzler> SkSwizzler::Make(const SkEncodedInfo& encodedInfo,
                     break;
                 case kRGB_565_SkColorType:
                     proc = &swizzle_bgr_to_565;
+                    fastProc = &fast_swizzle_bgr_to_565;
                     break;
                 default:
                     return nullptr;
@@ -1240,10 +1402,10 @@ int SkSwizzler::onSetSampleX(int sampleX) {
         }
     }
 
-    // The optimized swizzler functions do not support sampling.  Sampled swizzles
-    // are already fast because they skip pixels.  We haven't seen a situation
-    // where speeding up sampling has a significant impact on total decode time.
-    if (1 == fSampleX && fFastProc) {
+    // The optimized swizzler functions require contiguous pixels. When sampling, swizzle()
+    // gathers the sampled pixels first (see sampleThenSwizzle), unless the fast proc is a plain
+    // copy, in which case the slow proc already does the minimum amount of work.
+    if (fFastProc && (1 == fSampleX || fFastProc != &copy)) {
         fActualProc = fFastProc;
     } else {
         fActualProc = fSlowProc;
@@ -1252,8 +1414,48 @@ int SkSwizzler::onSetSampleX(int sampleX) {
     return fAllocatedWidth;
 }
 
+template <int kBPP>
+static void gather_pixels(uint8_t* dst, const uint8_t* src, int count, int deltaSrc) {
+    for (int x = 0; x < count; x++) {
+        memcpy(dst, src, kBPP);
+        dst += kBPP;
+        src += deltaSrc;
+    }
+}
+
+void SkSwizzler::sampleThenSwizzle(void* dst, const uint8_t* SK_RESTRICT src) const {
+    // Every format with a fast proc has a whole number of bytes per pixel.
+    static constexpr int kMaxSrcBPP = 8;
+    static constexpr int kChunkWidth = 128;
+    SkASSERT(fSrcBPP <= kMaxSrcBPP);
+
+    const int deltaSrc = fSampleX * fSrcBPP;
+    src += fSrcOffsetUnits;
+
+    uint8_t buffer[kChunkWidth * kMaxSrcBPP];
+    for (int x = 0; x < fSwizzleWidth; x += kChunkWidth) {
+        const int count = std::min(kChunkWidth, fSwizzleWidth - x);
+        switch (fSrcBPP) {
+            case 1: gather_pixels<1>(buffer, src, count, deltaSrc); break;
+            case 2: gather_pixels<2>(buffer, src, count, deltaSrc); break;
+            case 3: gather_pixels<3>(buffer, src, count, deltaSrc); break;
+            case 4: gather_pixels<4>(buffer, src, count, deltaSrc); break;
+            case 6: gather_pixels<6>(buffer, src, count, deltaSrc); break;
+            case 8: gather_pixels<8>(buffer, src, count, deltaSrc); break;
+            default: SkUNREACHABLE;
+        }
+        fFastProc(dst, buffer, count, fSrcBPP, fSrcBPP, 0, fColorTable);
+        src += count * deltaSrc;
+        dst = SkTAddOffset<void>(dst, count * fDstBPP);
+    }
+}
+
 void SkSwizzler::swizzle(void* dst, const uint8_t* SK_RESTRICT src) {
     SkASSERT(nullptr != dst && nullptr != src);
+    if (fSampleX > 1 && fActualProc == fFastProc) {
+        this->sampleThenSwizzle(SkTAddOffset<void>(dst, fDstOffsetBytes), src);
+        return;
+    }
     fActualProc(SkTAddOffset<void>(dst, fDstOffsetBytes), src, fSwizzleWidth, fSrcBPP,
             fSampleX * fSrcBPP, fSrcOffsetUnits, fColorTable);
 }
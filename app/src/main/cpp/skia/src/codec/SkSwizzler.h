@@ -127,6 +127,10 @@ private:
                                          int dstWidth, int bpp, int deltaSrc, int offset,
                                          const SkPMColor ctable[]);
 
+    // Used instead of fActualProc when sampling with a fast proc, which expects contiguous
+    // pixels.
+    void sampleThenSwizzle(void* dst, const uint8_t* SK_RESTRICT src) const;
+
     template <RowProc Proc>
     static void SkipLeadingGrayAlphaZerosThen(void* dst, const uint8_t* src, int width, int bpp,
                                               int deltaSrc, int offset, const SkPMColor ctable[]);
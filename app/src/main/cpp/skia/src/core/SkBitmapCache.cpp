@@ -19,11 +19,13 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/chromium/SkDiscardableMemory.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMipmap.h"
 #include "src/core/SkNextID.h"
 #include "src/core/SkResourceCache.h"
 #include "src/image/SkImage_Base.h"
 
+#include <atomic>
 #include <cstddef>
 #include <utility>
 
@@ -57,13 +59,27 @@ static unsigned gBitmapKeyNamespaceLabel;
 
 struct BitmapKey : public SkResourceCache::Key {
 public:
-    BitmapKey(const SkBitmapCacheDesc& desc) : fDesc(desc) {
+    BitmapKey(const SkBitmapCacheDesc& desc, SkISize variantDims = {0, 0})
+            : fDesc(desc), fVariantWidth(variantDims.width()), fVariantHeight(variantDims.height()) {
         this->init(&gBitmapKeyNamespaceLabel, SkMakeResourceCacheSharedIDForBitmap(fDesc.fImageID),
-                   sizeof(fDesc));
+                   sizeof(fDesc) + sizeof(fVariantWidth) + sizeof(fVariantHeight));
     }
 
+    bool isVariant() const { return fVariantWidth > 0; }
+
     const SkBitmapCacheDesc fDesc;
+    // The dimensions of a downscaled variant, or 0x0 for the full-size entry.
+    const int32_t           fVariantWidth;
+    const int32_t           fVariantHeight;
 };
+
+// Lookup counters are approximate; they are only used for reporting.
+std::atomic<uint64_t> gHits{0};
+std::atomic<uint64_t> gMisses{0};
+std::atomic<uint64_t> gVariantHits{0};
+std::atomic<uint64_t> gVariantMisses{0};
+std::atomic<size_t>   gBytesUsed{0};
+std::atomic<size_t>   gVariantBytesUsed{0};
 }  // namespace
 
 //////////////////////
@@ -74,9 +90,9 @@ void SkBitmapCache_setImmutableWithID(SkPixelRef* pr, uint32_t id) {
 
 class SkBitmapCache::Rec : public SkResourceCache::Rec {
 public:
-    Rec(const SkBitmapCacheDesc& desc, const SkImageInfo& info, size_t rowBytes,
+    Rec(const SkBitmapCacheDesc& desc, bool isVariant, const SkImageInfo& info, size_t rowBytes,
         std::unique_ptr<SkDiscardableMemory> dm, void* block)
-        : fKey(desc)
+        : fKey(desc, isVariant ? info.dimensions() : SkISize{0, 0})
         , fDM(std::move(dm))
         , fMalloc(block)
         , fInfo(info)
@@ -87,10 +103,15 @@ public:
         // We need an ID to return with the bitmap/pixelref. We can't necessarily use the key/desc
         // ID - lazy images cache the same ID with multiple keys (in different color types).
         fPrUniqueID = SkNextID::ImageID();
+
+        this->pixelBytesCounter().fetch_add(fInfo.computeByteSize(fRowBytes),
+                                            std::memory_order_relaxed);
     }
 
     ~Rec() override {
         SkASSERT(0 == fExternalCounter);
+        this->pixelBytesCounter().fetch_sub(fInfo.computeByteSize(fRowBytes),
+                                            std::memory_order_relaxed);
         if (fDM && fDiscardableIsLocked) {
             SkASSERT(fDM->data());
             fDM->unlock();
@@ -110,7 +131,9 @@ public:
         SkAssertResult(this->install(static_cast<SkBitmap*>(payload)));
     }
 
-    const char* getCategory() const override { return "bitmap"; }
+    const char* getCategory() const override {
+        return fKey.isVariant() ? "bitmap-variant" : "bitmap";
+    }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fDM.get();
     }
@@ -165,6 +188,10 @@ public:
     }
 
 private:
+    std::atomic<size_t>& pixelBytesCounter() const {
+        return fKey.isVariant() ? gVariantBytesUsed : gBytesUsed;
+    }
+
     BitmapKey   fKey;
 
     SkMutex     fMutex;
@@ -185,12 +212,8 @@ private:
 
 void SkBitmapCache::PrivateDeleteRec(Rec* rec) { delete rec; }
 
-SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
-                                           SkPixmap* pmap) {
-    // Ensure that the info matches the subset (i.e. the subset is the entire image)
-    SkASSERT(info.width() == desc.fSubset.width());
-    SkASSERT(info.height() == desc.fSubset.height());
-
+static SkBitmapCache::RecPtr alloc_rec(const SkBitmapCacheDesc& desc, bool isVariant,
+                                      const SkImageInfo& info, SkPixmap* pmap) {
     const size_t rb = info.minRowBytes();
     size_t size = info.computeByteSize(rb);
     if (SkImageInfo::ByteSizeOverflowed(size)) {
@@ -210,7 +233,28 @@ SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const
         return nullptr;
     }
     *pmap = SkPixmap(info, dm ? dm->data() : block, rb);
-    return RecPtr(new Rec(desc, info, rb, std::move(dm), block));
+    return SkBitmapCache::RecPtr(
+            new SkBitmapCache::Rec(desc, isVariant, info, rb, std::move(dm), block));
+}
+
+SkBitmapCache::RecPtr SkBitmapCache::Alloc(const SkBitmapCacheDesc& desc, const SkImageInfo& info,
+                                           SkPixmap* pmap) {
+    // Ensure that the info matches the subset (i.e. the subset is the entire image)
+    SkASSERT(info.width() == desc.fSubset.width());
+    SkASSERT(info.height() == desc.fSubset.height());
+
+    return alloc_rec(desc, false, info, pmap);
+}
+
+SkBitmapCache::RecPtr SkBitmapCache::AllocVariant(const SkBitmapCacheDesc& desc,
+                                                  const SkImageInfo& info, SkPixmap* pmap) {
+    // A variant is smaller than the subset it was decoded from.
+    SkASSERT(!info.isEmpty());
+    SkASSERT(info.width() <= desc.fSubset.width());
+    SkASSERT(info.height() <= desc.fSubset.height());
+    SkASSERT(info.dimensions() != desc.fSubset.size());
+
+    return alloc_rec(desc, true, info, pmap);
 }
 
 void SkBitmapCache::Add(RecPtr rec, SkBitmap* bitmap) {
@@ -219,7 +263,36 @@ void SkBitmapCache::Add(RecPtr rec, SkBitmap* bitmap) {
 
 bool SkBitmapCache::Find(const SkBitmapCacheDesc& desc, SkBitmap* result) {
     desc.validate();
-    return SkResourceCache::Find(BitmapKey(desc), SkBitmapCache::Rec::Finder, result);
+    bool found = SkResourceCache::Find(BitmapKey(desc), SkBitmapCache::Rec::Finder, result);
+    (found ? gHits : gMisses).fetch_add(1, std::memory_order_relaxed);
+    return found;
+}
+
+bool SkBitmapCache::FindVariant(const SkBitmapCacheDesc& desc, SkISize dims, SkBitmap* result) {
+    desc.validate();
+    SkASSERT(!dims.isEmpty());
+    bool found = SkResourceCache::Find(BitmapKey(desc, dims), SkBitmapCache::Rec::Finder, result);
+    (found ? gVariantHits : gVariantMisses).fetch_add(1, std::memory_order_relaxed);
+    return found;
+}
+
+SkBitmapCache::Stats SkBitmapCache::GetStats() {
+    Stats stats;
+    stats.fHits             = gHits.load(std::memory_order_relaxed);
+    stats.fMisses           = gMisses.load(std::memory_order_relaxed);
+    stats.fVariantHits      = gVariantHits.load(std::memory_order_relaxed);
+    stats.fVariantMisses    = gVariantMisses.load(std::memory_order_relaxed);
+    stats.fBytesUsed        = gBytesUsed.load(std::memory_order_relaxed);
+    stats.fVariantBytesUsed = gVariantBytesUsed.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void SkBitmapCache::ResetStats() {
+    // Byte counts track live entries and are not reset.
+    gHits.store(0, std::memory_order_relaxed);
+    gMisses.store(0, std::memory_order_relaxed);
+    gVariantHits.store(0, std::memory_order_relaxed);
+    gVariantMisses.store(0, std::memory_order_relaxed);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////
@@ -254,7 +327,11 @@ struct MipMapRec : public SkResourceCache::Rec {
     }
 
     const Key& getKey() const override { return fKey; }
-    size_t bytesUsed() const override { return sizeof(fKey) + fMipMap->size(); }
+    // A lazy mipmap keeps its base pixels alive, so they are charged to it as well (even if the
+    // image's own pixels are also in the cache).
+    size_t bytesUsed() const override {
+        return sizeof(fKey) + fMipMap->size() + fMipMap->lazyBaseSize();
+    }
     const char* getCategory() const override { return "mipmap"; }
     SkDiscardableMemory* diagnostic_only_getDiscardable() const override {
         return fMipMap->diagnostic_only_getDiscardable();
@@ -302,7 +379,9 @@ const SkMipmap* SkMipmapCache::AddAndRef(const SkImage_Base* image, SkResourceCa
         return nullptr;
     }
 
-    SkMipmap* mipmap = SkMipmap::Build(src, get_fact(localCache));
+    // Most draws only sample one or two levels, so only generate those.
+    SkMipmap* mipmap = SkMipmap::BuildLazy(src, get_fact(localCache),
+                                           SkImageFilter_Base::GetExecutor());
     if (mipmap) {
         MipMapRec* rec = new MipMapRec(SkBitmapCacheDesc::Make(image), mipmap);
         CHECK_LOCAL(localCache, add, Add, rec);
@@ -55,6 +55,32 @@ public:
     static RecPtr Alloc(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*);
     static void Add(RecPtr, SkBitmap*);
 
+    /**
+     *  Downscaled variants of an image are cached alongside the full-size decode, keyed by the
+     *  image's desc and the variant's dimensions, which are chosen by the decoder. Keying on the
+     *  dimensions means that requests for different scales that the decoder resolves to the same
+     *  size share a single decode.
+     */
+    static bool FindVariant(const SkBitmapCacheDesc&, SkISize dims, SkBitmap* result);
+    static RecPtr AllocVariant(const SkBitmapCacheDesc&, const SkImageInfo&, SkPixmap*);
+
+    struct Stats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        uint64_t fVariantHits = 0;
+        uint64_t fVariantMisses = 0;
+        // Bytes currently held by full-size and downscaled entries in the resource cache.
+        size_t   fBytesUsed = 0;
+        size_t   fVariantBytesUsed = 0;
+
+        float hitRate() const {
+            uint64_t lookups = fHits + fMisses + fVariantHits + fVariantMisses;
+            return lookups ? (float)(fHits + fVariantHits) / lookups : 0;
+        }
+    };
+    static Stats GetStats();
+    static void ResetStats();
+
 private:
     static void PrivateDeleteRec(Rec*);
 };
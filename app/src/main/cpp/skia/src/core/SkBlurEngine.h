@@ -17,8 +17,10 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <memory>
 
 class SkDevice;
+class SkExecutor;
 class SkRuntimeEffect;
 class SkRuntimeEffectBuilder;
 class SkSpecialImage;
@@ -76,6 +78,23 @@ public:
     // and other color types, it uses SkShaderBlurAlgorithm backed by the raster pipeline.
     static const SkBlurEngine* GetRasterBlurEngine();
 
+    struct RasterOptions {
+        // If not null, the 32-bit and A8 algorithms split each blur pass into bands of rows
+        // (horizontal pass) or strips of columns (vertical pass) that run on this executor. The
+        // output is identical to the serial engine's. Small blurs still run on the calling thread.
+        // The executor must outlive the engine.
+        SkExecutor* fExecutor = nullptr;
+        // If true, 32-bit and A8 blurs whose sigmas are both above 20 are downsampled by a power of
+        // two, blurred at the reduced resolution, and upsampled bilinearly. This is several times
+        // faster. In a 1D simulation the result differed from an exact Gaussian by up to 2.6/255;
+        // the two passes of a 2D blur can add up to about twice that.
+        bool fDownsampleLargeSigmas = false;
+    };
+
+    // Like GetRasterBlurEngine(), with the behavior configured by 'options'. Default options
+    // produce an engine equivalent to GetRasterBlurEngine().
+    static std::unique_ptr<SkBlurEngine> MakeRasterBlurEngine(const RasterOptions& options);
+
     // TODO: These are internal functions of the raster blur engine but need to be public for legacy
     // code paths to invoke them directly.
 
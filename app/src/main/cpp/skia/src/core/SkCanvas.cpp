@@ -853,7 +853,9 @@ void SkCanvas::internalDrawDeviceWithFilter(SkDevice* src,
     FilterSpan filtersOrNull = filters.empty() ? FilterSpan{&nullFilter, 1} : filters;
 
     for (const sk_sp<SkImageFilter>& filter : filtersOrNull) {
-        auto result = filter ? as_IFB(filter)->filterImage(ctx) : source;
+        auto result = filter ? as_IFB(filter)->filterImageTiled(
+                                       ctx, SkImageFilter_Base::CanvasTiledOptions())
+                             : source;
 
         if (srcIsCoverageLayer) {
             SkASSERT(dst->useDrawCoverageMaskForMaskFilters());
@@ -2336,7 +2338,8 @@ void SkCanvas::onDrawImageRect2(const SkImage* image, const SkRect& src, const S
         // and a desired output matching the device clip bounds.
         ctx = ctx.withNewDesiredOutput(mapping.deviceToLayer(outputBounds))
                  .withNewSource(source);
-        auto result = as_IFB(realPaint.getImageFilter())->filterImage(ctx);
+        auto result = as_IFB(realPaint.getImageFilter())->filterImageTiled(
+                ctx, SkImageFilter_Base::CanvasTiledOptions());
         result.draw(ctx, device, realPaint.getBlender());
         stats.reportStats();
         return;
@@ -12,11 +12,16 @@
 #include "include/core/SkPathBuilder.h"
 #include "include/core/SkScalar.h"
 #include "include/private/base/SkDebug.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTPin.h"
 #include "src/core/SkRectPriv.h"
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <cmath>
 #include <new>
+#include <utility>
 
 SkClipStack::Element::Element(const Element& that) {
     switch (that.getDeviceSpaceType()) {
@@ -49,6 +54,9 @@ SkClipStack::Element::Element(const Element& that) {
     fFiniteBoundType = that.fFiniteBoundType;
     fFiniteBound = that.fFiniteBound;
     fIsIntersectionOfRects = that.fIsIntersectionOfRects;
+    fInsideTiles = that.fInsideTiles;
+    fOutsideTiles = that.fOutsideTiles;
+    fTilesValid = that.fTilesValid;
     fGenID = that.fGenID;
 }
 
@@ -147,6 +155,9 @@ void SkClipStack::Element::initCommon(int saveCount, SkClipOp op, bool doAA) {
     fFiniteBoundType = kInsideOut_BoundsType;
     fFiniteBound.setEmpty();
     fIsIntersectionOfRects = false;
+    fInsideTiles = 0;
+    fOutsideTiles = 0;
+    fTilesValid = false;
     fGenID = kInvalidGenID;
 }
 
@@ -248,6 +259,9 @@ void SkClipStack::Element::setEmpty() {
     fFiniteBound.setEmpty();
     fFiniteBoundType = kNormal_BoundsType;
     fIsIntersectionOfRects = false;
+    fInsideTiles = 0;
+    fOutsideTiles = 0;
+    fTilesValid = true;
     fDeviceSpaceRRect.setEmpty();
     fDeviceSpacePath.reset();
     fShader.reset();
@@ -259,6 +273,7 @@ void SkClipStack::Element::checkEmpty() const {
     SkASSERT(fFiniteBound.isEmpty());
     SkASSERT(kNormal_BoundsType == fFiniteBoundType);
     SkASSERT(!fIsIntersectionOfRects);
+    SkASSERT(!fInsideTiles && !fOutsideTiles);
     SkASSERT(kEmptyGenID == fGenID);
     SkASSERT(fDeviceSpaceRRect.isEmpty());
     SkASSERT(!fDeviceSpacePath.isValid());
@@ -466,6 +481,308 @@ void SkClipStack::Element::updateBoundAndGenID(const Element* prior) {
                 break;
         }
     } // else Replace just ignores everything prior and should already have filled in bounds.
+
+    fTilesValid = false;
+}
+
+// Returns edge i of the n equal tiles spanning [lo, hi].
+static float tile_edge(float lo, float hi, int i, int n) {
+    return i == n ? hi : lo + (hi - lo) * i / n;
+}
+
+// Finds the tiles, of the n equal tiles spanning [lo, hi], that cover [a, b] within it. The span is
+// estimated, then adjusted against the exact tile edges.
+static void tile_span(float lo, float hi, int n, float a, float b, int* first, int* last) {
+    SkASSERT(lo <= a && a <= b && b <= hi);
+    const float scale = n / (hi - lo);
+    *first = SkTPin(static_cast<int>((a - lo) * scale), 0, n - 1);
+    while (*first > 0 && tile_edge(lo, hi, *first, n) > a) {
+        --*first;
+    }
+    while (*first + 1 < n && tile_edge(lo, hi, *first + 1, n) <= a) {
+        ++*first;
+    }
+    *last = SkTPin(static_cast<int>(std::ceil((b - lo) * scale)) - 1, *first, n - 1);
+    while (*last + 1 < n && tile_edge(lo, hi, *last + 1, n) < b) {
+        ++*last;
+    }
+    while (*last > *first && tile_edge(lo, hi, *last, n) >= b) {
+        --*last;
+    }
+}
+
+// Are the tiles in columns [x0, x1] of rows [y0, y1] all set in the n x n grid of tiles?
+static bool tiles_all_set(uint64_t tiles, int n, int x0, int x1, int y0, int y1) {
+    const uint64_t row = ((uint64_t(1) << (x1 - x0 + 1)) - 1) << x0;
+    for (int y = y0; y <= y1; ++y) {
+        if (((tiles >> (y * n)) & row) != row) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Sets edges[0..n] to the edges of the n equal tiles spanning [lo, hi].
+static void tile_edges(float lo, float hi, int n, float edges[]) {
+    for (int i = 0; i <= n; ++i) {
+        edges[i] = tile_edge(lo, hi, i, n);
+    }
+}
+
+// Returns the mask of the columns, of those with edges xs[0..n], that lie within [lo, hi].
+static uint64_t columns_within(const float xs[], int n, float lo, float hi) {
+    uint64_t mask = 0;
+    for (int x = 0; x < n; ++x) {
+        mask |= (lo <= xs[x] && xs[x + 1] <= hi) ? uint64_t(1) << x : 0;
+    }
+    return mask;
+}
+
+// Returns the mask of the columns, of those with edges xs[0..n], that lie outside (lo, hi).
+static uint64_t columns_outside(const float xs[], int n, float lo, float hi) {
+    uint64_t mask = 0;
+    for (int x = 0; x < n; ++x) {
+        mask |= (xs[x + 1] <= lo || hi <= xs[x]) ? uint64_t(1) << x : 0;
+    }
+    return mask;
+}
+
+// How far a rounded corner with the given radii pulls the rrect's edge in, at a distance d from
+// the corner's end along the other axis. Beyond the corner, d is negative and there is no inset.
+static float corner_inset(SkVector radii, float d, bool alongX) {
+    const float r = alongX ? radii.fY : radii.fX,
+                rOther = alongX ? radii.fX : radii.fY;
+    if (d <= 0 || r <= 0) {
+        return 0;
+    }
+    const float u = std::min(d / r, 1.0f);
+    return rOther * (1 - std::sqrt(1 - u * u));
+}
+
+// The horizontal extents of an rrect over a range of rows: [fInnerLeft, fInnerRight] is inside the
+// rrect at every y in the range, and anything left of fOuterLeft or right of fOuterRight is outside
+// it at every y.
+struct RowExtents {
+    float fInnerLeft, fInnerRight;
+    float fOuterLeft, fOuterRight;
+};
+
+// Finds the extents of the rrect over the rows [top, bottom], pulled in or out a little to stay
+// conservative. Returns false if the rrect does not reach into the range at all.
+static bool rrect_row_extents(const SkRRect& rrect, float top, float bottom, RowExtents* extents) {
+    const SkRect& b = rrect.getBounds();
+    const float t = std::max(top, b.fTop),
+                bt = std::min(bottom, b.fBottom);
+    if (!(t < bt)) {
+        return false;
+    }
+    const bool rangeWithin = b.fTop <= top && bottom <= b.fBottom;
+    const SkVector ul = rrect.radii(SkRRect::kUpperLeft_Corner),
+                   ur = rrect.radii(SkRRect::kUpperRight_Corner),
+                   lr = rrect.radii(SkRRect::kLowerRight_Corner),
+                   ll = rrect.radii(SkRRect::kLowerLeft_Corner);
+    if (b.fTop + std::max(ul.fY, ur.fY) <= t && bt <= b.fBottom - std::max(ll.fY, lr.fY)) {
+        // The range is clear of the corners, so only the straight edges matter.
+        *extents = {rangeWithin ? b.fLeft : SK_ScalarInfinity,
+                    rangeWithin ? b.fRight : SK_ScalarNegativeInfinity,
+                    b.fLeft, b.fRight};
+        return true;
+    }
+
+    // Enough to cover the rounding of the insets, relative to the size of the coordinates.
+    const float tolerance = std::max(1.0f / 256,
+                                     (std::abs(b.fLeft) + std::abs(b.fRight)) * 1e-6f);
+    auto pad = [tolerance](float inset) { return inset > 0 ? inset + tolerance : 0; };
+    auto unpad = [tolerance](float inset) { return std::max(inset - tolerance, 0.0f); };
+
+    // The corners pull the edges in the furthest at the ends of the range...
+    if (rangeWithin) {
+        extents->fInnerLeft = b.fLeft + pad(std::max(corner_inset(ul, b.fTop + ul.fY - t, true),
+                                                     corner_inset(ll, bt - (b.fBottom - ll.fY),
+                                                                  true)));
+        extents->fInnerRight = b.fRight - pad(std::max(corner_inset(ur, b.fTop + ur.fY - t, true),
+                                                       corner_inset(lr, bt - (b.fBottom - lr.fY),
+                                                                    true)));
+    } else {
+        extents->fInnerLeft = SK_ScalarInfinity;
+        extents->fInnerRight = SK_ScalarNegativeInfinity;
+    }
+    // ...and the least toward its middle, where an upper corner meets the end of the range or a
+    // lower corner meets its start.
+    extents->fOuterLeft = b.fLeft + unpad(std::min(corner_inset(ul, b.fTop + ul.fY - bt, true),
+                                                   corner_inset(ll, t - (b.fBottom - ll.fY),
+                                                                true)));
+    extents->fOuterRight = b.fRight - unpad(std::min(corner_inset(ur, b.fTop + ur.fY - bt, true),
+                                                     corner_inset(lr, t - (b.fBottom - lr.fY),
+                                                                  true)));
+    return true;
+}
+
+void SkClipStack::Element::classifyTiles(const float xs[], const float ys[],
+                                         uint64_t* inside, uint64_t* outside) const {
+    constexpr int n = kTileGridSize;
+    constexpr uint64_t kRow = (uint64_t(1) << n) - 1;
+    *inside = 0;
+    *outside = 0;
+    if (kEmptyGenID == fGenID) {
+        *outside = ~uint64_t(0);
+        return;
+    }
+    if (kInsideOut_BoundsType == fFiniteBoundType) {
+        // Every pixel outside the bound can be drawn to.
+        const uint64_t columns = columns_outside(xs, n, fFiniteBound.fLeft, fFiniteBound.fRight);
+        for (int y = 0; y < n; ++y) {
+            const bool rowOutside = ys[y + 1] <= fFiniteBound.fTop ||
+                                    fFiniteBound.fBottom <= ys[y];
+            *inside |= (rowOutside ? kRow : columns) << (y * n);
+        }
+        return;
+    }
+
+    // Map each column and row of the other grid to the span of ours that covers it.
+    const SkRect& b = fFiniteBound;
+    uint64_t spans[n] = {};
+    uint64_t columnsWithin = 0, columnsOutside = 0;
+    for (int x = 0; x < n; ++x) {
+        if (xs[x + 1] <= b.fLeft || b.fRight <= xs[x]) {
+            columnsOutside |= uint64_t(1) << x;
+            continue;
+        }
+        columnsWithin |= (b.fLeft <= xs[x] && xs[x + 1] <= b.fRight) ? uint64_t(1) << x : 0;
+        int x0, x1;
+        tile_span(b.fLeft, b.fRight, n, std::max(xs[x], b.fLeft), std::min(xs[x + 1], b.fRight),
+                  &x0, &x1);
+        spans[x] = ((uint64_t(1) << (x1 - x0 + 1)) - 1) << x0;
+    }
+    for (int y = 0; y < n; ++y) {
+        uint64_t rowInside = 0, rowOutside = kRow;
+        if (ys[y + 1] > b.fTop && b.fBottom > ys[y]) {
+            int y0, y1;
+            tile_span(b.fTop, b.fBottom, n, std::max(ys[y], b.fTop), std::min(ys[y + 1], b.fBottom),
+                      &y0, &y1);
+            const bool rowWithin = b.fTop <= ys[y] && ys[y + 1] <= b.fBottom;
+            // Our columns that are inside, or outside, in every one of our rows in the span.
+            uint64_t insideColumns = kRow, outsideColumns = kRow;
+            for (int row = y0; row <= y1; ++row) {
+                insideColumns &= fInsideTiles >> (row * n);
+                outsideColumns &= fOutsideTiles >> (row * n);
+            }
+            rowOutside = columnsOutside;
+            for (int x = 0; x < n; ++x) {
+                if (columnsOutside & (uint64_t(1) << x)) {
+                    continue;
+                }
+                const uint64_t bit = uint64_t(1) << x;
+                if (rowWithin && (columnsWithin & bit) &&
+                    (insideColumns & spans[x]) == spans[x]) {
+                    rowInside |= bit;
+                }
+                if ((outsideColumns & spans[x]) == spans[x]) {
+                    rowOutside |= bit;
+                }
+            }
+        }
+        *inside |= rowInside << (y * n);
+        *outside |= rowOutside << (y * n);
+    }
+}
+
+void SkClipStack::Element::updateTiles(const Element* prior) const {
+    constexpr int n = kTileGridSize;
+    constexpr uint64_t kRow = (uint64_t(1) << n) - 1;
+    SkASSERT(!prior || prior->fTilesValid);
+    fInsideTiles = 0;
+    fOutsideTiles = 0;
+    fTilesValid = true;
+    if (kEmptyGenID == fGenID || kNormal_BoundsType != fFiniteBoundType ||
+        DeviceSpaceType::kShader == fDeviceSpaceType ||
+        fFiniteBound.isEmpty() || !fFiniteBound.isFinite()) {
+        return;
+    }
+
+    const SkRect& b = fFiniteBound;
+    float xs[n + 1], ys[n + 1];
+    tile_edges(b.fLeft, b.fRight, n, xs);
+    tile_edges(b.fTop, b.fBottom, n, ys);
+
+    // Classify the tiles against this element's shape, a row at a time. Rects and rrects are
+    // convex, so the tiles of a row inside the shape are a run of columns, as are those of the
+    // row outside it on either side. Paths are only classified by their bounds.
+    SkRRect shape;
+    if (DeviceSpaceType::kPath == fDeviceSpaceType) {
+        shape.setRect(fDeviceSpacePath->getBounds());
+    } else {
+        shape = fDeviceSpaceRRect;
+    }
+    const bool hasInterior = DeviceSpaceType::kPath != fDeviceSpaceType;
+    const bool inverse = this->isInverseFilled();
+    uint64_t shapeInside = 0, shapeOutside = 0;
+    for (int y = 0; y < n; ++y) {
+        uint64_t rowInside = 0, rowOutside = kRow;
+        RowExtents extents;
+        if (rrect_row_extents(shape, ys[y], ys[y + 1], &extents)) {
+            rowInside = hasInterior
+                    ? columns_within(xs, n, extents.fInnerLeft, extents.fInnerRight) : 0;
+            rowOutside = columns_outside(xs, n, extents.fOuterLeft, extents.fOuterRight);
+        }
+        if (inverse) {
+            std::swap(rowInside, rowOutside);
+        }
+        shapeInside |= rowInside << (y * n);
+        shapeOutside |= rowOutside << (y * n);
+    }
+
+    // Combine with the clip before this element. With no prior clip, the plane is wide open.
+    uint64_t priorInside = ~uint64_t(0), priorOutside = 0;
+    if (prior && !this->isReplaceOp()) {
+        prior->classifyTiles(xs, ys, &priorInside, &priorOutside);
+    }
+    if (SkClipOp::kDifference == fOp && !this->isReplaceOp()) {
+        fInsideTiles = priorInside & shapeOutside;
+        fOutsideTiles = priorOutside | shapeInside;
+    } else {
+        fInsideTiles = priorInside & shapeInside;
+        fOutsideTiles = priorOutside | shapeOutside;
+    }
+}
+
+bool SkClipStack::Element::clipContains(const SkRect& devRect) const {
+    if (kEmptyGenID == fGenID || devRect.isEmpty()) {
+        return false;
+    }
+    if (kInsideOut_BoundsType == fFiniteBoundType) {
+        // Every pixel outside the bound can be drawn to.
+        return !SkRect::Intersects(fFiniteBound, devRect);
+    }
+    if (!fInsideTiles || !fFiniteBound.contains(devRect)) {
+        return false;
+    }
+    const SkRect& b = fFiniteBound;
+    int x0, x1, y0, y1;
+    tile_span(b.fLeft, b.fRight, kTileGridSize, devRect.fLeft, devRect.fRight, &x0, &x1);
+    tile_span(b.fTop, b.fBottom, kTileGridSize, devRect.fTop, devRect.fBottom, &y0, &y1);
+    return tiles_all_set(fInsideTiles, kTileGridSize, x0, x1, y0, y1);
+}
+
+bool SkClipStack::Element::clipExcludes(const SkRect& devRect) const {
+    if (kEmptyGenID == fGenID) {
+        return true;
+    }
+    if (kInsideOut_BoundsType == fFiniteBoundType) {
+        return false;
+    }
+    SkRect r;
+    if (!r.intersect(fFiniteBound, devRect)) {
+        return true;
+    }
+    if (!fOutsideTiles) {
+        return false;
+    }
+    const SkRect& b = fFiniteBound;
+    int x0, x1, y0, y1;
+    tile_span(b.fLeft, b.fRight, kTileGridSize, r.fLeft, r.fRight, &x0, &x1);
+    tile_span(b.fTop, b.fBottom, kTileGridSize, r.fTop, r.fBottom, &y0, &y1);
+    return tiles_all_set(fOutsideTiles, kTileGridSize, x0, x1, y0, y1);
 }
 
 // This constant determines how many Element's are allocated together as a block in
@@ -603,6 +920,37 @@ void SkClipStack::getBounds(SkRect* canvFiniteBound,
     }
 }
 
+const SkClipStack::Element* SkClipStack::topElementWithTiles() const {
+    const Element* top = (const Element*)fDeque.back();
+    if (!top || top->fTilesValid) {
+        return top;
+    }
+    // Collect the elements whose tiles are missing, from the top down to the first one that
+    // either has its tiles or ignores what is below it, then classify them bottom up.
+    skia_private::STArray<8, const Element*> pending;
+    SkDeque::Iter iter(fDeque, SkDeque::Iter::kBack_IterStart);
+    const Element* prior = (const Element*)iter.prev();
+    while (prior && !prior->fTilesValid) {
+        pending.push_back(prior);
+        prior = prior->isReplaceOp() ? nullptr : (const Element*)iter.prev();
+    }
+    for (int i = pending.size() - 1; i >= 0; --i) {
+        pending[i]->updateTiles(prior);
+        prior = pending[i];
+    }
+    return top;
+}
+
+bool SkClipStack::tilesContain(const SkRect& devRect) const {
+    const Element* element = this->topElementWithTiles();
+    return element && element->clipContains(devRect);
+}
+
+bool SkClipStack::quickReject(const SkRect& devRect) const {
+    const Element* element = this->topElementWithTiles();
+    return element && element->clipExcludes(devRect.makeOutset(1, 1));
+}
+
 bool SkClipStack::internalQuickContains(const SkRect& rect) const {
     Iter iter(*this, Iter::kTop_IterStart);
     const Element* element = iter.prev();
@@ -215,6 +215,20 @@ public:
         // equivalent to a single rect intersection? IIOW, is the clip effectively a rectangle.
         bool fIsIntersectionOfRects;
 
+        /* fInsideTiles and fOutsideTiles classify the kTileGridSize x kTileGridSize grid of equal
+           tiles spanning fFiniteBound against the clip up to and including this element, so that
+           quickContains() and quickReject() can answer without walking the stack. Bit
+           (y * kTileGridSize + x) is set in fInsideTiles if tile (x, y) is known to be entirely
+           inside the clip, and in fOutsideTiles if it is known to be entirely outside. Both are
+           conservative, and only kept when fFiniteBoundType is kNormal_BoundsType. They are
+           classified the first time the stack is queried with this element on top (see
+           SkClipStack::topElementWithTiles()), so pushes that are never queried don't pay for
+           them; fTilesValid is set once they are. */
+        static constexpr int kTileGridSize = 8;
+        mutable uint64_t fInsideTiles;
+        mutable uint64_t fOutsideTiles;
+        mutable bool fTilesValid;
+
         uint32_t fGenID;
         Element(int saveCount) {
             this->initCommon(saveCount, SkClipOp::kIntersect, false);
@@ -271,6 +285,17 @@ public:
         // per-set operation functions used by updateBoundAndGenID().
         inline void combineBoundsDiff(FillCombo combination, const SkRect& prevFinite);
         inline void combineBoundsIntersection(int combination, const SkRect& prevFinite);
+        /** Classifies the tiles of fFiniteBound, given the previous element of the stack, whose
+            tiles must already be valid. */
+        void updateTiles(const Element* prior) const;
+        // Classifies the tiles of another grid, with column edges xs and row edges ys, against
+        // the clip up to and including this element, in the layout of fInsideTiles/fOutsideTiles.
+        void classifyTiles(const float xs[], const float ys[],
+                           uint64_t* inside, uint64_t* outside) const;
+        // Conservatively checks whether the clip up to and including this element contains, or
+        // excludes, the device space rect.
+        bool clipContains(const SkRect& devRect) const;
+        bool clipExcludes(const SkRect& devRect) const;
     };
 
     SkClipStack();
@@ -331,13 +356,22 @@ public:
      * is not contained by the clip.
      */
     bool quickContains(const SkRect& devRect) const {
-        return this->isWideOpen() || this->internalQuickContains(devRect);
+        return this->isWideOpen() || this->tilesContain(devRect) ||
+               this->internalQuickContains(devRect);
     }
 
     bool quickContains(const SkRRect& devRRect) const {
-        return this->isWideOpen() || this->internalQuickContains(devRRect);
+        return this->isWideOpen() || this->tilesContain(devRRect.getBounds()) ||
+               this->internalQuickContains(devRRect);
     }
 
+    /**
+     * Returns true if the input rect in device space, outset by a pixel to allow for
+     * anti-aliasing, is entirely outside the clip, so nothing drawn inside it would be visible.
+     * A return value of false does not guarantee that the rect touches the clip.
+     */
+    bool quickReject(const SkRect& devRect) const;
+
     void clipDevRect(const SkIRect& ir, SkClipOp op) {
         SkRect r;
         r.set(ir);
@@ -490,6 +524,11 @@ private:
 
     bool internalQuickContains(const SkRect& devRect) const;
     bool internalQuickContains(const SkRRect& devRRect) const;
+    // Checks the topmost element's tiles, which answer in constant time however deep the stack.
+    bool tilesContain(const SkRect& devRect) const;
+    // Returns the topmost element, or null if the stack is empty, after classifying the tiles of
+    // it and of any elements below it that it depends on and that haven't been yet.
+    const Element* topElementWithTiles() const;
 
     /**
      * Helper for clipDevPath, etc.
@@ -322,7 +322,8 @@ sk_sp<SkSpecialImage> SkDevice::snapSpecial() {
 
 sk_sp<skif::Backend> SkDevice::createImageFilteringBackend(const SkSurfaceProps& surfaceProps,
                                                            SkColorType colorType) const {
-    return skif::MakeRasterBackend(surfaceProps, colorType);
+    return skif::MakeRasterBackend(surfaceProps, colorType,
+                                   SkImageFilter_Base::RasterBlurOptions());
 }
 
 void SkDevice::drawDevice(SkDevice* device,
@@ -368,7 +369,9 @@ void SkDevice::drawFilteredImage(const skif::Mapping& mapping,
                       &stats};
 
     SkIPoint offset;
-    sk_sp<SkSpecialImage> result = as_IFB(filter)->filterImage(ctx).imageAndOffset(ctx, &offset);
+    sk_sp<SkSpecialImage> result =
+            as_IFB(filter)->filterImageTiled(ctx, SkImageFilter_Base::CanvasTiledOptions())
+                          .imageAndOffset(ctx, &offset);
     stats.reportStats();
     if (result) {
         SkMatrix deviceMatrixWithOffset = mapping.layerToDevice().asM33();
@@ -11,6 +11,7 @@
 #include "src/core/SkBlitMask.h"
 #include "src/core/SkBlitRow.h"
 #include "src/core/SkCpu.h"
+#include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkMemset.h"
 #include "src/core/SkOpts.h"
@@ -94,6 +95,42 @@ size_t SkGraphics::SetResourceCacheSingleAllocationByteLimit(size_t newLimit) {
     return SkResourceCache::SetSingleAllocationByteLimit(newLimit);
 }
 
+size_t SkGraphics::GetImageFilterTileBudget() {
+    return SkImageFilter_Base::GetTileBudget();
+}
+
+size_t SkGraphics::SetImageFilterTileBudget(size_t bytes) {
+    return SkImageFilter_Base::SetTileBudget(bytes);
+}
+
+SkExecutor* SkGraphics::GetImageFilterExecutor() {
+    return SkImageFilter_Base::GetExecutor();
+}
+
+SkExecutor* SkGraphics::SetImageFilterExecutor(SkExecutor* executor) {
+    return SkImageFilter_Base::SetExecutor(executor);
+}
+
+bool SkGraphics::GetImageFilterApproximateLargeBlurs() {
+    return SkImageFilter_Base::GetApproximateLargeBlurs();
+}
+
+bool SkGraphics::SetImageFilterApproximateLargeBlurs(bool approximate) {
+    return SkImageFilter_Base::SetApproximateLargeBlurs(approximate);
+}
+
+bool SkGraphics::GetImageFilterCacheContentKeyed() {
+    return SkImageFilterCache::Get()->keyMode() == SkImageFilterCache::KeyMode::kContent;
+}
+
+bool SkGraphics::SetImageFilterCacheContentKeyed(bool contentKeyed) {
+    sk_sp<SkImageFilterCache> cache = SkImageFilterCache::Get();
+    const bool previous = cache->keyMode() == SkImageFilterCache::KeyMode::kContent;
+    cache->setKeyMode(contentKeyed ? SkImageFilterCache::KeyMode::kContent
+                                   : SkImageFilterCache::KeyMode::kUniqueID);
+    return previous;
+}
+
 void SkGraphics::PurgeResourceCache() {
     SkImageFilter_Base::PurgeCache();
     return SkResourceCache::PurgeAll();
@@ -8,14 +8,20 @@
 #include "include/core/SkImageFilter.h"
 
 #include "include/core/SkColorFilter.h"
+#include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImage.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkM44.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSerialProcs.h"
+#include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkImageFilterCache.h"
 #include "src/core/SkImageFilterTypes.h"
 #include "src/core/SkImageFilter_Base.h"
@@ -33,6 +39,7 @@
 #include <cstdint>
 #include <optional>
 #include <utility>
+#include <vector>
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 // SkImageFilter - A number of the public APIs on SkImageFilter downcast to SkImageFilter_Base
@@ -244,24 +251,251 @@ skif::FilterResult SkImageFilter_Base::filterImage(const skif::Context& context)
     uint32_t srcGenID = srcInKey ? context.source().image()->uniqueID() : SK_InvalidUniqueID;
     const SkIRect srcSubset = srcInKey ? context.source().image()->subset() : SkIRect::MakeWH(0, 0);
 
-    SkImageFilterCacheKey key(fUniqueID,
+    const bool contentKeyed =
+            context.cache() &&
+            context.cache()->keyMode() == SkImageFilterCache::KeyMode::kContent;
+    SkImageFilterCacheKey key(contentKeyed ? SK_InvalidUniqueID : fUniqueID,
                               context.mapping().layerMatrix().asM33(),
                               SkIRect(context.desiredOutput()),
-                              srcGenID, srcSubset);
-    if (context.backend()->cache() && context.backend()->cache()->get(key, &result)) {
+                              srcGenID, srcSubset,
+                              contentKeyed ? this->contentHash() : 0);
+    if (context.cache() && context.cache()->get(key, this, &result)) {
         context.markCacheHit();
         return result;
     }
 
     result = this->onFilterImage(context);
 
-    if (context.backend()->cache()) {
-        context.backend()->cache()->set(key, this, result);
+    if (context.cache()) {
+        context.cache()->set(key, this, result);
     }
 
     return result;
 }
 
+// Stands in for the content of images, pictures and typefaces when flattening a filter's content.
+template <typename T>
+static sk_sp<SkData> serialize_unique_id(T* object, void*) {
+    const uint32_t id = object->uniqueID();
+    return SkData::MakeWithCopy(&id, sizeof(id));
+}
+
+namespace {
+
+// Flattens one filter, writing the content hashes of the image filters it references instead of
+// flattening them again, so each node of a DAG is flattened once no matter how deep it is.
+class ContentWriteBuffer final : public SkBinaryWriteBuffer {
+public:
+    ContentWriteBuffer(const SkImageFilter* root, const SkSerialProcs& procs)
+            : SkBinaryWriteBuffer(procs), fRoot(root) {}
+
+    void writeFlattenable(const SkFlattenable* flattenable) override {
+        if (flattenable && flattenable != fRoot &&
+            flattenable->getFlattenableType() == SkFlattenable::kSkImageFilter_Type) {
+            const uint64_t hash =
+                    as_IFB(static_cast<const SkImageFilter*>(flattenable))->contentHash();
+            this->writeUInt(static_cast<uint32_t>(hash >> 32));
+            this->writeUInt(static_cast<uint32_t>(hash));
+        } else {
+            this->SkBinaryWriteBuffer::writeFlattenable(flattenable);
+        }
+    }
+
+private:
+    const SkImageFilter* fRoot;
+};
+
+} // namespace
+
+void SkImageFilter_Base::computeContent() const {
+    fContentOnce([this] {
+        SkSerialProcs procs;
+        procs.fImageProc = serialize_unique_id<SkImage>;
+        procs.fPictureProc = serialize_unique_id<SkPicture>;
+        procs.fTypefaceProc = serialize_unique_id<SkTypeface>;
+        ContentWriteBuffer writer(this, procs);
+        writer.writeFlattenable(this);
+        fContent = writer.snapshotAsData();
+        fContentHash = SkChecksum::Hash64(fContent->data(), fContent->size());
+    });
+}
+
+uint64_t SkImageFilter_Base::contentHash() const {
+    this->computeContent();
+    return fContentHash;
+}
+
+sk_sp<SkData> SkImageFilter_Base::content() const {
+    this->computeContent();
+    return fContent;
+}
+
+static int count_filter_nodes(const SkImageFilter* filter) {
+    int count = 1;
+    for (int i = 0; i < filter->countInputs(); ++i) {
+        if (const SkImageFilter* input = filter->getInput(i)) {
+            count += count_filter_nodes(input);
+        }
+    }
+    return count;
+}
+
+skif::FilterResult SkImageFilter_Base::filterImageTiled(const skif::Context& context,
+                                                        const TiledOptions& options) const {
+    // Below this, per-tile overhead and the repeated margins dominate.
+    static constexpr int kMinTileSize = 64;
+    // On top of the filters' own reach, each tile is evaluated this far past its edges and then
+    // cropped, so that resampling a result with a deferred transform reads real neighboring
+    // pixels instead of the tile's transparent boundary. This is the support of the widest kernel
+    // FilterResult resamples with: bicubic reaches 2 pixels, bilinear 1 and nearest 0.
+    static constexpr int kResampleOverlap = 2;
+
+    const SkIRect desiredOutput = SkIRect(context.desiredOutput());
+    if (!options.fMemoryBudget || desiredOutput.isEmpty() ||
+        !context.mapping().layerMatrix().isFinite()) {
+        return this->filterImage(context);
+    }
+
+    std::optional<skif::LayerSpace<SkIRect>> contentBounds;
+    if (context.source()) {
+        contentBounds = context.source().layerBounds();
+    }
+    // A graph that fills the layer (e.g. with a shader or a clamp-tiled crop) has effects whose
+    // extent doesn't come from its input bounds, so it can't be split exactly.
+    if (!this->onGetOutputLayerBounds(context.mapping(), contentBounds)) {
+        return this->filterImage(context);
+    }
+
+    const bool concurrent = options.fExecutor && options.fMaxConcurrentTiles > 1 &&
+                            context.backend()->supportsConcurrentFiltering();
+    const int maxConcurrentTiles = concurrent ? options.fMaxConcurrentTiles : 1;
+    const size_t tileBudget = options.fMemoryBudget / maxConcurrentTiles;
+
+    // Conservatively assume that every node of the DAG produces an image covering everything the
+    // root reads for the region being evaluated, which is where the margins of the filters have
+    // accumulated.
+    const double bytesPerPixel = SkColorTypeBytesPerPixel(context.backend()->colorType()) *
+                                 count_filter_nodes(this);
+    auto inputBounds = [&](const SkIRect& output) {
+        return SkIRect(this->onGetInputLayerBounds(
+                context.mapping(), skif::LayerSpace<SkIRect>(output), contentBounds));
+    };
+    auto requiredBytes = [&](const SkIRect& output, int overlap) {
+        const SkIRect evalBounds = output.makeOutset(overlap, overlap);
+        SkIRect input = inputBounds(evalBounds);
+        input.join(evalBounds);
+        return bytesPerPixel * input.width() * input.height();
+    };
+
+    if (requiredBytes(desiredOutput, /*overlap=*/0) <= options.fMemoryBudget) {
+        return this->filterImage(context);
+    }
+
+    // Everything a filter does near the edge of its desired output (the tail of a blur kernel,
+    // the partially covered pixels of a downscale, reading past the end of its input) stays
+    // within the reach of its input bounds. Evaluating each tile that far past its edges keeps
+    // those effects out of the part of the tile that is kept. A graph that reads as far as the
+    // whole output away from a tile isn't local enough to tile at all.
+    const int64_t maxReach = std::max(desiredOutput.width(), desiredOutput.height());
+    auto reach = [&](const SkIRect& tile) {
+        const SkIRect input = inputBounds(tile);
+        if (input.isEmpty()) {
+            return int64_t(0);
+        }
+        return std::max({int64_t(0),
+                         int64_t(tile.fLeft) - input.fLeft, int64_t(input.fRight) - tile.fRight,
+                         int64_t(tile.fTop) - input.fTop, int64_t(input.fBottom) - tile.fBottom});
+    };
+
+    // Content bounds and crops make the required input differ from tile to tile, so a tile size
+    // fits only if every tile in its grid does.
+    std::vector<skif::LayerSpace<SkIRect>> tiles;
+    int overlap = -1;
+    auto makeTiles = [&](int tileSize) {
+        tiles.clear();
+        int64_t tileReach = 0;
+        for (int y = desiredOutput.top(); y < desiredOutput.bottom(); y += tileSize) {
+            for (int x = desiredOutput.left(); x < desiredOutput.right(); x += tileSize) {
+                SkIRect tile = SkIRect::MakeLTRB(x, y,
+                                                 std::min(x + tileSize, desiredOutput.right()),
+                                                 std::min(y + tileSize, desiredOutput.bottom()));
+                tileReach = std::max(tileReach, reach(tile));
+                tiles.emplace_back(tile);
+            }
+        }
+        if (tileReach >= maxReach) {
+            overlap = -1;
+            return false;
+        }
+        overlap = SkToInt(tileReach) + kResampleOverlap;
+        double maxRequiredBytes = 0;
+        for (const skif::LayerSpace<SkIRect>& tile : tiles) {
+            maxRequiredBytes = std::max(maxRequiredBytes, requiredBytes(SkIRect(tile), overlap));
+        }
+        return maxRequiredBytes <= tileBudget;
+    };
+
+    int tileSize = std::max(desiredOutput.width(), desiredOutput.height());
+    while (tileSize > kMinTileSize) {
+        tileSize = std::max(kMinTileSize, tileSize / 2);
+        if (makeTiles(tileSize) || overlap < 0) {
+            break;
+        }
+    }
+    if (tiles.size() < 2 || overlap < 0) {
+        return this->filterImage(context);
+    }
+
+    return skif::FilterResult::MakeFromTiles(
+            context, tiles, overlap, concurrent ? options.fExecutor : nullptr,
+            maxConcurrentTiles,
+            [this](const skif::Context& tileContext) { return this->filterImage(tileContext); });
+}
+
+static std::atomic<size_t> gTileBudget{0};
+
+size_t SkImageFilter_Base::GetTileBudget() {
+    return gTileBudget.load(std::memory_order_relaxed);
+}
+
+size_t SkImageFilter_Base::SetTileBudget(size_t bytes) {
+    return gTileBudget.exchange(bytes, std::memory_order_relaxed);
+}
+
+static std::atomic<SkExecutor*> gExecutor{nullptr};
+
+SkExecutor* SkImageFilter_Base::GetExecutor() {
+    return gExecutor.load(std::memory_order_acquire);
+}
+
+SkExecutor* SkImageFilter_Base::SetExecutor(SkExecutor* executor) {
+    return gExecutor.exchange(executor, std::memory_order_acq_rel);
+}
+
+static std::atomic<bool> gApproximateLargeBlurs{false};
+
+bool SkImageFilter_Base::GetApproximateLargeBlurs() {
+    return gApproximateLargeBlurs.load(std::memory_order_relaxed);
+}
+
+bool SkImageFilter_Base::SetApproximateLargeBlurs(bool approximate) {
+    return gApproximateLargeBlurs.exchange(approximate, std::memory_order_relaxed);
+}
+
+SkBlurEngine::RasterOptions SkImageFilter_Base::RasterBlurOptions() {
+    SkBlurEngine::RasterOptions options;
+    options.fExecutor = GetExecutor();
+    options.fDownsampleLargeSigmas = GetApproximateLargeBlurs();
+    return options;
+}
+
+SkImageFilter_Base::TiledOptions SkImageFilter_Base::CanvasTiledOptions() {
+    TiledOptions options;
+    options.fMemoryBudget = GetTileBudget();
+    options.fExecutor = GetExecutor();
+    return options;
+}
+
 sk_sp<SkImage> SkImageFilter_Base::makeImageWithFilter(sk_sp<skif::Backend> backend,
                                                        sk_sp<SkImage> src,
                                                        const SkIRect& subset,
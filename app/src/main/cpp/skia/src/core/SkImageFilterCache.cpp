@@ -7,15 +7,18 @@
 
 #include "src/core/SkImageFilterCache.h"
 
+#include "include/core/SkData.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkOnce.h"
 #include "src/base/SkTInternalLList.h"
 #include "src/core/SkChecksum.h"
 #include "src/core/SkImageFilterTypes.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkSpecialImage.h"
 #include "src/core/SkTDynamicHash.h"
 #include "src/core/SkTHash.h"
 
+#include <atomic>
 #include <vector>
 
 using namespace skia_private;
@@ -31,18 +34,27 @@ namespace {
 class CacheImpl : public SkImageFilterCache {
 public:
     typedef SkImageFilterCacheKey Key;
-    CacheImpl(size_t maxBytes) : fMaxBytes(maxBytes), fCurrentBytes(0) { }
+    CacheImpl(size_t maxBytes, KeyMode keyMode)
+            : fMaxBytes(maxBytes), fCurrentBytes(0), fKeyMode(keyMode) { }
     ~CacheImpl() override {
         fLookup.foreach([&](Value* v) { delete v; });
     }
     struct Value {
         Value(const Key& key, const skif::FilterResult& image,
-              const SkImageFilter* filter)
-            : fKey(key), fImage(image), fFilter(filter) {}
+              const SkImageFilter* filter, sk_sp<SkData> content)
+            : fKey(key), fImage(image), fFilter(filter), fContent(std::move(content)) {}
 
         Key fKey;
         skif::FilterResult fImage;
         const SkImageFilter* fFilter;
+        // In KeyMode::kContent, the flattened content of the filter that produced fImage, to
+        // confirm a matching hash without keeping the filter (and its images) alive.
+        sk_sp<SkData> fContent;
+
+        size_t bytes() const {
+            return (fImage.image() ? fImage.image()->getSize() : 0) +
+                   (fContent ? fContent->size() : 0);
+        }
         static const Key& GetKey(const Value& v) {
             return v.fKey;
         }
@@ -52,36 +64,52 @@ public:
         SK_DECLARE_INTERNAL_LLIST_INTERFACE(Value);
     };
 
-    bool get(const Key& key, skif::FilterResult* result) const override {
+    bool get(const Key& key, const SkImageFilter* filter,
+             skif::FilterResult* result) const override {
         SkASSERT(result);
 
         SkAutoMutexExclusive mutex(fMutex);
-        if (Value* v = fLookup.find(key)) {
+        Value* v = fLookup.find(key);
+        if (v && v->fContent && !v->fContent->equals(as_IFB(filter)->content().get())) {
+            v = nullptr;
+        }
+        if (v) {
             if (v != fLRU.head()) {
                 fLRU.remove(v);
                 fLRU.addToHead(v);
             }
 
             *result = v->fImage;
+            fStats.fHits++;
             return true;
         }
+        fStats.fMisses++;
         return false;
     }
 
     void set(const Key& key, const SkImageFilter* filter,
              const skif::FilterResult& result) override {
+        // Content-keyed results can be reused by other filters with the same content, so they are
+        // not tracked for purgeByImageFilter().
+        sk_sp<SkData> content;
+        if (fKeyMode.load(std::memory_order_relaxed) == KeyMode::kContent) {
+            content = as_IFB(filter)->content();
+            filter = nullptr;
+        }
         SkAutoMutexExclusive mutex(fMutex);
         if (Value* v = fLookup.find(key)) {
             this->removeInternal(v);
         }
-        Value* v = new Value(key, result, filter);
+        Value* v = new Value(key, result, filter, std::move(content));
         fLookup.add(v);
         fLRU.addToHead(v);
-        fCurrentBytes += result.image() ? result.image()->getSize() : 0;
-        if (auto* values = fImageFilterValues.find(filter)) {
-            values->push_back(v);
-        } else {
-            fImageFilterValues.set(filter, {v});
+        fCurrentBytes += v->bytes();
+        if (filter) {
+            if (auto* values = fImageFilterValues.find(filter)) {
+                values->push_back(v);
+            } else {
+                fImageFilterValues.set(filter, {v});
+            }
         }
 
         while (fCurrentBytes > fMaxBytes) {
@@ -90,17 +118,14 @@ public:
             if (tail == v) {
                 break;
             }
+            fStats.fEvictedBytes += tail->bytes();
             this->removeInternal(tail);
         }
     }
 
     void purge() override {
         SkAutoMutexExclusive mutex(fMutex);
-        while (fCurrentBytes > 0) {
-            Value* tail = fLRU.tail();
-            SkASSERT(tail);
-            this->removeInternal(tail);
-        }
+        this->purgeInternal();
     }
 
     void purgeByImageFilter(const SkImageFilter* filter) override {
@@ -112,14 +137,42 @@ public:
         for (Value* v : *values) {
             // We set the filter to be null so that removeInternal() won't delete from values while
             // we're iterating over it.
+            SkASSERT(!v->fContent);
             v->fFilter = nullptr;
             this->removeInternal(v);
         }
         fImageFilterValues.remove(filter);
     }
 
+    KeyMode keyMode() const override { return fKeyMode.load(std::memory_order_relaxed); }
+
+    void setKeyMode(KeyMode keyMode) override {
+        SkAutoMutexExclusive mutex(fMutex);
+        if (fKeyMode.exchange(keyMode, std::memory_order_relaxed) != keyMode) {
+            this->purgeInternal();
+        }
+    }
+
+    Stats stats() const override {
+        SkAutoMutexExclusive mutex(fMutex);
+        Stats stats = fStats;
+        stats.fCurrentBytes = fCurrentBytes;
+        return stats;
+    }
+
+    void resetStats() override {
+        SkAutoMutexExclusive mutex(fMutex);
+        fStats = {};
+    }
+
     SkDEBUGCODE(int count() const override { return fLookup.count(); })
 private:
+    void purgeInternal() {
+        while (Value* tail = fLRU.tail()) {
+            this->removeInternal(tail);
+        }
+    }
+
     void removeInternal(Value* v) {
         if (v->fFilter) {
             if (auto* values = fImageFilterValues.find(v->fFilter)) {
@@ -135,7 +188,7 @@ private:
                 }
             }
         }
-        fCurrentBytes -= v->fImage.image() ? v->fImage.image()->getSize() : 0;
+        fCurrentBytes -= v->bytes();
         fLRU.remove(v);
         fLookup.remove(v->fKey);
         delete v;
@@ -147,13 +200,15 @@ private:
     THashMap<const SkImageFilter*, std::vector<Value*>> fImageFilterValues;
     size_t                                              fMaxBytes;
     size_t                                              fCurrentBytes;
+    std::atomic<KeyMode>                                fKeyMode;
+    mutable Stats                                       fStats;
     mutable SkMutex                                     fMutex;
 };
 
 } // namespace
 
-sk_sp<SkImageFilterCache> SkImageFilterCache::Create(size_t maxBytes) {
-    return sk_make_sp<CacheImpl>(maxBytes);
+sk_sp<SkImageFilterCache> SkImageFilterCache::Create(size_t maxBytes, KeyMode keyMode) {
+    return sk_make_sp<CacheImpl>(maxBytes, keyMode);
 }
 
 sk_sp<SkImageFilterCache> SkImageFilterCache::Get(CreateIfNecessary createIfNecessary) {
@@ -20,17 +20,23 @@
 class SkImageFilter;
 namespace skif { class FilterResult; }
 
+// 'uniqueID' identifies a specific image filter object. When the cache is content keyed,
+// 'uniqueID' is SK_InvalidUniqueID and 'contentHash' identifies the structure of the filter DAG
+// instead (see SkImageFilter_Base::contentHash()).
 struct SkImageFilterCacheKey {
     SkImageFilterCacheKey(const uint32_t uniqueID, const SkMatrix& matrix,
-        const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset)
+        const SkIRect& clipBounds, uint32_t srcGenID, const SkIRect& srcSubset,
+        uint64_t contentHash = 0)
         : fUniqueID(uniqueID)
         , fMatrix(matrix)
         , fClipBounds(clipBounds)
         , fSrcGenID(srcGenID)
-        , fSrcSubset(srcSubset) {
+        , fSrcSubset(srcSubset)
+        , fContentHash(contentHash) {
         // Assert that Key is tightly-packed, since it is hashed.
         static_assert(sizeof(SkImageFilterCacheKey) == sizeof(uint32_t) + sizeof(SkMatrix) +
-                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t),
+                                     sizeof(SkIRect) + sizeof(uint32_t) + 4 * sizeof(int32_t) +
+                                     sizeof(uint64_t),
                                      "image_filter_key_tight_packing");
         fMatrix.getType();  // force initialization of type, so hashes match
         SkASSERT(fMatrix.isFinite());   // otherwise we can't rely on == self when comparing keys
@@ -41,33 +47,55 @@ struct SkImageFilterCacheKey {
     SkIRect fClipBounds;
     uint32_t fSrcGenID;
     SkIRect fSrcSubset;
+    uint64_t fContentHash;
 
     bool operator==(const SkImageFilterCacheKey& other) const {
         return fUniqueID == other.fUniqueID &&
                fMatrix == other.fMatrix &&
                fClipBounds == other.fClipBounds &&
                fSrcGenID == other.fSrcGenID &&
-               fSrcSubset == other.fSrcSubset;
+               fSrcSubset == other.fSrcSubset &&
+               fContentHash == other.fContentHash;
     }
 };
 
 // This cache maps from (filter's unique ID + CTM + clipBounds + src bitmap generation ID) to result
-// NOTE: this is the _specific_ unique ID of the image filter, so refiltering the same image with a
-// copy of the image filter (with exactly the same parameters) will not yield a cache hit.
+// NOTE: by default this is the _specific_ unique ID of the image filter, so refiltering the same
+// image with a copy of the image filter (with exactly the same parameters) will not yield a cache
+// hit. In KeyMode::kContent, the unique ID is replaced by a hash of the flattened filter DAG, so
+// structurally identical filters that are rebuilt every frame share results. A content-keyed
+// result keeps the flattened content of the filter that produced it, which counts toward the
+// budget, and is only returned for a filter with the same content. That content refers to the
+// filter's inputs by hash and to its images by unique ID, so it keeps none of them alive.
+// Content-keyed results are not purged when the filter that produced them is destroyed; they
+// remain until evicted by the LRU budget. SkGraphics::SetImageFilterCacheContentKeyed() switches
+// the global cache to this mode.
 class SkImageFilterCache : public SkRefCnt {
 public:
     static constexpr size_t kDefaultTransientSize = 32 * 1024 * 1024;
 
+    enum class KeyMode : bool { kUniqueID, kContent };
+
+    struct Stats {
+        uint64_t fHits = 0;
+        uint64_t fMisses = 0;
+        // Bytes of results dropped to stay within the budget.
+        uint64_t fEvictedBytes = 0;
+        size_t   fCurrentBytes = 0;
+    };
+
     ~SkImageFilterCache() override {}
-    static sk_sp<SkImageFilterCache> Create(size_t maxBytes);
+    static sk_sp<SkImageFilterCache> Create(size_t maxBytes, KeyMode = KeyMode::kUniqueID);
 
     // Whether to create the cache if it doesn't yet exist.
     enum class CreateIfNecessary : bool { kNo, kYes };
     static sk_sp<SkImageFilterCache> Get(CreateIfNecessary = CreateIfNecessary::kYes);
 
     // Returns true on cache hit and updates 'result' to be the cached result. Returns false when
-    // not in the cache, in which case 'result' is not modified.
-    virtual bool get(const SkImageFilterCacheKey& key,
+    // not in the cache, in which case 'result' is not modified. 'filter' is the filter being
+    // evaluated; in KeyMode::kContent its content must match that of the filter that produced
+    // the cached result.
+    virtual bool get(const SkImageFilterCacheKey& key, const SkImageFilter* filter,
                      skif::FilterResult* result) const = 0;
     // 'filter' is included in the caching to allow the purging of all of an image filter's cached
     // results when it is destroyed.
@@ -75,6 +103,13 @@ public:
                      const skif::FilterResult& result) = 0;
     virtual void purge() = 0;
     virtual void purgeByImageFilter(const SkImageFilter*) = 0;
+
+    // Changing the key mode purges the cache.
+    virtual KeyMode keyMode() const = 0;
+    virtual void setKeyMode(KeyMode) = 0;
+
+    virtual Stats stats() const = 0;
+    virtual void resetStats() = 0;
     SkDEBUGCODE(virtual int count() const = 0;)
 };
 
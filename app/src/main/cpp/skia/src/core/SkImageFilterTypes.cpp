@@ -35,12 +35,16 @@
 #include "src/core/SkKnownRuntimeEffects.h"
 #include "src/core/SkMatrixPriv.h"
 #include "src/core/SkRectPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/core/SkTraceEvent.h"
 #include "src/effects/colorfilters/SkColorFilterBase.h"
 
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
 
 namespace skif {
 
@@ -183,8 +187,13 @@ std::optional<LayerSpace<SkMatrix>> periodic_axis_transform(
 class RasterBackend : public Backend {
 public:
 
-    RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType)
-            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType) {}
+    RasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType,
+                  const SkBlurEngine::RasterOptions& blurOptions)
+            : Backend(SkImageFilterCache::Get(), surfaceProps, colorType) {
+        if (blurOptions.fExecutor || blurOptions.fDownsampleLargeSigmas) {
+            fBlurEngine = SkBlurEngine::MakeRasterBlurEngine(blurOptions);
+        }
+    }
 
     sk_sp<SkDevice> makeDevice(SkISize size,
                                sk_sp<SkColorSpace> colorSpace,
@@ -205,8 +214,13 @@ public:
     }
 
     const SkBlurEngine* getBlurEngine() const override {
-        return SkBlurEngine::GetRasterBlurEngine();
+        return fBlurEngine ? fBlurEngine.get() : SkBlurEngine::GetRasterBlurEngine();
     }
+
+    bool supportsConcurrentFiltering() const override { return true; }
+
+private:
+    std::unique_ptr<SkBlurEngine> fBlurEngine;
 };
 
 } // anonymous namespace
@@ -222,8 +236,9 @@ Backend::Backend(sk_sp<SkImageFilterCache> cache,
 
 Backend::~Backend() = default;
 
-sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType) {
-    return sk_make_sp<RasterBackend>(surfaceProps, colorType);
+sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType,
+                                 const SkBlurEngine::RasterOptions& blurOptions) {
+    return sk_make_sp<RasterBackend>(surfaceProps, colorType, blurOptions);
 }
 
 void Stats::dumpStats() const {
@@ -1506,6 +1521,30 @@ PixelSpace<SkRect> scale_about_center(const PixelSpace<SkRect> src, float sx, fl
                                (src.right() - cx) * sx, (src.bottom() - cy) * sy});
 }
 
+// Grows 'bounds' so that halving it 'xSteps' and 'ySteps' times about its center samples a pixel
+// grid that is anchored at the layer origin instead of at wherever the bounds happen to start.
+// Rescales of different desired outputs (e.g. the tiles of one layer) then agree where they
+// overlap. Each axis is snapped out to a multiple of its final downscale factor, with an even
+// number of cells so that the center falls on the grid too.
+PixelSpace<SkIRect> align_to_downscale_grid(const PixelSpace<SkIRect>& bounds,
+                                            int xSteps, int ySteps) {
+    auto align = [](int lo, int hi, int steps) -> std::pair<int, int> {
+        if (steps <= 0) {
+            return {lo, hi};
+        }
+        const double cell = std::ldexp(1.0, steps);
+        const double first = std::floor(lo / cell);
+        double last = std::ceil(hi / cell);
+        if (std::fmod(first + last, 2.0) != 0.0) {
+            last += 1.0;
+        }
+        return {sk_double_saturate2int(first * cell), sk_double_saturate2int(last * cell)};
+    };
+    auto [left, right] = align(bounds.left(), bounds.right(), xSteps);
+    auto [top, bottom] = align(bounds.top(), bounds.bottom(), ySteps);
+    return PixelSpace<SkIRect>(SkIRect::MakeLTRB(left, top, right, bottom));
+}
+
 void draw_color_filtered_border(SkCanvas* canvas,
                                 PixelSpace<SkIRect> border,
                                 sk_sp<SkColorFilter> colorFilter) {
@@ -1668,6 +1707,7 @@ FilterResult FilterResult::rescale(const Context& ctx,
     SkTileMode tileMode;
     bool cfBorder = false;
     bool deferPeriodicTiling = false;
+    bool alignToLayer = false;
     if (canDeferTiling && (analysis & BoundsAnalysis::kHasLayerFillingEffect)) {
         // When we can defer tiling, and said tiling is visible, rescaling the original image
         // uses smaller textures.
@@ -1689,9 +1729,16 @@ FilterResult FilterResult::rescale(const Context& ctx,
         // image than the original image data.
         srcRect = visibleLayerBounds;
         tileMode = SkTileMode::kDecal;
+        // Every step halves the image when overscaling, so the low-res pixels can be lined up with
+        // the layer. The padding that adds is sampled with decal tiling, so it only brings in
+        // transparent black or more of the real content.
+        alignToLayer = allowOverscaling;
     }
 
     srcRect = srcRect.relevantSubset(ctx.desiredOutput(), tileMode);
+    if (alignToLayer && !srcRect.isEmpty()) {
+        srcRect = align_to_downscale_grid(srcRect, xSteps, ySteps);
+    }
     // To avoid incurring error from rounding up the dimensions at every step, the logical size of
     // the image is tracked in floats through the whole process; rounding to integers is only done
     // to produce a conservative pixel buffer and clamp-tiling is used so that partially covered
@@ -1937,6 +1984,67 @@ FilterResult FilterResult::MakeFromShader(const Context& ctx,
     return surface.snap();
 }
 
+FilterResult FilterResult::MakeFromTiles(
+        const Context& ctx,
+        SkSpan<const LayerSpace<SkIRect>> tiles,
+        int overlap,
+        SkExecutor* executor,
+        int maxConcurrentTiles,
+        const std::function<FilterResult(const Context&)>& evalTile) {
+    SkASSERT(!executor || ctx.backend()->supportsConcurrentFiltering());
+
+    AutoSurface surface{ctx, ctx.desiredOutput(), PixelBoundary::kTransparent,
+                        /*renderInParameterSpace=*/false};
+    if (!surface) {
+        return {};
+    }
+
+    const Context tileCtx = ctx.withoutCache();
+    auto tileContext = [&](const LayerSpace<SkIRect>& tile) {
+        // Tiles on the edge of the desired output stop there, so that the filters see the same
+        // boundary along it as when evaluating the whole output at once.
+        LayerSpace<SkIRect> evalBounds = tile;
+        evalBounds.outset(LayerSpace<SkISize>({overlap, overlap}));
+        SkAssertResult(evalBounds.intersect(ctx.desiredOutput()));
+        return tileCtx.withNewDesiredOutput(evalBounds);
+    };
+    auto drawTile = [&](const FilterResult& result, const LayerSpace<SkIRect>& tile) {
+        // A filter may return more than its desired output, so crop each result to its tile to
+        // keep neighboring tiles from blending over each other.
+        result.applyCrop(tileCtx.withNewDesiredOutput(tile), tile)
+              .draw(ctx, surface.device(), /*preserveDeviceState=*/true);
+    };
+
+    if (!executor || maxConcurrentTiles < 2) {
+        for (const LayerSpace<SkIRect>& tile : tiles) {
+            drawTile(evalTile(tileContext(tile)), tile);
+        }
+        return surface.snap();
+    }
+
+    // Evaluate the tiles in waves so that at most 'maxConcurrentTiles' are alive at once. Each tile
+    // records its own stats since the Context's Stats are not thread safe.
+    const int waveSize = std::min(maxConcurrentTiles, SkToInt(tiles.size()));
+    std::vector<FilterResult> results(waveSize);
+    std::vector<Stats> stats(waveSize);
+    for (size_t waveStart = 0; waveStart < tiles.size(); waveStart += waveSize) {
+        const int count = std::min(waveSize, SkToInt(tiles.size() - waveStart));
+        SkTaskGroup group(*executor);
+        group.batch(count, [&](int i) {
+            results[i] = evalTile(tileContext(tiles[waveStart + i]).withNewStats(&stats[i]));
+        });
+        group.wait();
+
+        for (int i = 0; i < count; ++i) {
+            drawTile(results[i], tiles[waveStart + i]);
+            ctx.addStats(stats[i]);
+            results[i] = {};
+            stats[i] = {};
+        }
+    }
+    return surface.snap();
+}
+
 FilterResult FilterResult::MakeFromImage(const Context& ctx,
                                          sk_sp<SkImage> image,
                                          SkRect srcRect,
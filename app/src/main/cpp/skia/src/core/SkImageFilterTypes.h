@@ -27,17 +27,19 @@
 #include "include/private/base/SkTPin.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkEnumBitMask.h"
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkSpecialImage.h"
 
 #include <cstdint>
+#include <functional>
 #include <optional>
 #include <utility>
 
 class FilterResultTestAccess;  // for testing
 class SkBitmap;
 class SkBlender;
-class SkBlurEngine;
 class SkDevice;
+class SkExecutor;
 class SkImage;
 class SkImageFilter;
 class SkImageFilterCache;
@@ -736,6 +738,21 @@ public:
                                        sk_sp<SkShader> shader,
                                        bool dither);
 
+    // Renders the FilterResults of 'evalTile' for each of 'tiles' into one surface covering the
+    // context's desired output. The tiles must be disjoint. Each tile is evaluated with a Context
+    // whose desired output is that tile outset by 'overlap' pixels, clipped to the context's
+    // desired output, and that does not use the image filter cache, so only the intermediates of the tiles currently being evaluated are alive at
+    // once. The result is cropped back to the tile, so the overlap has to cover how far the edge
+    // effects of 'evalTile' reach into its desired output. If 'executor' is not null, up to
+    // 'maxConcurrentTiles' tiles are evaluated concurrently on it; the backend must support
+    // concurrent filtering. Tile results are always composited on the calling thread.
+    static FilterResult MakeFromTiles(const Context& ctx,
+                                      SkSpan<const LayerSpace<SkIRect>> tiles,
+                                      int overlap,
+                                      SkExecutor* executor,
+                                      int maxConcurrentTiles,
+                                      const std::function<FilterResult(const Context&)>& evalTile);
+
     // Converts image to a FilterResult. If 'srcRect' is pixel-aligned it does so without rendering.
     // Otherwise it draws the src->dst sampling of 'image' into an optimally sized surface based
     // on the context's desired output. 'image' must not be null.
@@ -1123,6 +1140,9 @@ public:
 
     SkImageFilterCache* cache() const { return fCache.get(); }
 
+    // Whether multiple filter DAGs can be evaluated with this backend on different threads at once.
+    virtual bool supportsConcurrentFiltering() const { return false; }
+
 protected:
     Backend(sk_sp<SkImageFilterCache> cache,
             const SkSurfaceProps& surfaceProps,
@@ -1134,7 +1154,9 @@ private:
     SkColorType fColorType;
 };
 
-sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType);
+// 'blurOptions' configures the raster blur engine, see SkBlurEngine::MakeRasterBlurEngine.
+sk_sp<Backend> MakeRasterBackend(const SkSurfaceProps& surfaceProps, SkColorType colorType,
+                                 const SkBlurEngine::RasterOptions& blurOptions = {});
 
 // Stats for a single image filter evaluation
 struct Stats {
@@ -1146,6 +1168,15 @@ struct Stats {
 
     void dumpStats() const;   // log to std out
     void reportStats() const; // trace event counters
+
+    Stats& operator+=(const Stats& other) {
+        fNumVisitedImageFilters += other.fNumVisitedImageFilters;
+        fNumCacheHits += other.fNumCacheHits;
+        fNumOffscreenSurfaces += other.fNumOffscreenSurfaces;
+        fNumShaderClampedDraws += other.fNumShaderClampedDraws;
+        fNumShaderBasedTilingDraws += other.fNumShaderBasedTilingDraws;
+        return *this;
+    }
 };
 
 // The context contains all necessary information to describe how the image filter should be
@@ -1198,6 +1229,8 @@ public:
     // the output of the inner DAG as the "source" for the outer DAG.
     const FilterResult& source() const { return fSource; }
 
+    // The cache for filter results, or null if results should not be cached.
+    SkImageFilterCache* cache() const { return fUseCache ? fBackend->cache() : nullptr; }
 
     // Create a new context that matches this context, but with an overridden layer space.
     Context withNewMapping(const Mapping& mapping) const {
@@ -1224,6 +1257,18 @@ public:
         c.fSource = source;
         return c;
     }
+    // Create a new context that matches this context, but that does not read or write the cache.
+    Context withoutCache() const {
+        Context c = *this;
+        c.fUseCache = false;
+        return c;
+    }
+    // Create a new context that matches this context, but records stats into 'stats' (may be null).
+    Context withNewStats(Stats* stats) const {
+        Context c = *this;
+        c.fStats = stats;
+        return c;
+    }
 
 
     // Stats tracking
@@ -1251,6 +1296,11 @@ public:
             }
         }
     }
+    void addStats(const Stats& stats) const {
+        if (fStats) {
+            *fStats += stats;
+        }
+    }
 
 private:
     friend class ::FilterResultTestAccess; // For controlling Stats
@@ -1264,6 +1314,8 @@ private:
     FilterResult        fSource;
     // The color space the filters are evaluated in
     sk_sp<SkColorSpace> fColorSpace;
+    // False when evaluating in tiles, where caching every tile would defeat the memory bound
+    bool fUseCache = true;
 
     Stats* fStats;
 };
@@ -9,15 +9,21 @@
 #define SkImageFilter_Base_DEFINED
 
 #include "include/core/SkColorSpace.h"
+#include "include/core/SkData.h"
 #include "include/core/SkImageFilter.h"
 #include "include/core/SkImageInfo.h"
+#include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTemplates.h"
 
+#include "src/core/SkBlurEngine.h"
 #include "src/core/SkImageFilterTypes.h"
 
+#include <cstddef>
 #include <optional>
 
+class SkExecutor;
+
 // True base class that all SkImageFilter implementations need to extend from. This provides the
 // actual API surface that Skia will use to compute the filtered images.
 class SkImageFilter_Base : public SkImageFilter {
@@ -35,6 +41,55 @@ public:
      */
     skif::FilterResult filterImage(const skif::Context& context) const;
 
+    struct TiledOptions {
+        // The approximate number of bytes that intermediate images may use at once. 0 means
+        // unbounded, in which case filterImageTiled() is the same as filterImage().
+        size_t      fMemoryBudget = 0;
+        // If not null, and the context's backend supports concurrent filtering, up to
+        // 'fMaxConcurrentTiles' tiles are evaluated at once on this executor. The memory budget is
+        // shared between them.
+        SkExecutor* fExecutor = nullptr;
+        int         fMaxConcurrentTiles = 4;
+    };
+
+    /**
+     *  Like filterImage(), but if evaluating the DAG for the whole desired output would need more
+     *  than 'options.fMemoryBudget' bytes of intermediate images, the desired output is split into
+     *  tiles that are each evaluated separately and then assembled into the result. Each tile's
+     *  required input bounds are propagated through the DAG as usual, so the intermediates are
+     *  sized to the tile plus the margins its filters need. Each tile is also evaluated that far
+     *  past its edges and then cropped, so the edge effects of its intermediates stay outside the
+     *  part that is kept and the result matches the untiled one. Graphs that fill the layer, or
+     *  that read as far as the whole output away from a tile, are not tiled. Only the final
+     *  output is allocated at full size. The estimate is checked for every tile and assumes
+     *  every node produces a new image, so the budget is an upper bound except when even the
+     *  smallest tiles exceed it.
+     */
+    skif::FilterResult filterImageTiled(const skif::Context& context,
+                                        const TiledOptions& options) const;
+
+    // The memory budget used for the image filters applied when drawing to an SkCanvas, see
+    // SkGraphics::SetImageFilterTileBudget().
+    static size_t GetTileBudget();
+    static size_t SetTileBudget(size_t bytes);
+
+    // The executor used by the CPU backend for image filters applied when drawing to an SkCanvas,
+    // see SkGraphics::SetImageFilterExecutor().
+    static SkExecutor* GetExecutor();
+    static SkExecutor* SetExecutor(SkExecutor*);
+
+    // Whether the CPU backend downsamples large blurs, see
+    // SkGraphics::SetImageFilterApproximateLargeBlurs().
+    static bool GetApproximateLargeBlurs();
+    static bool SetApproximateLargeBlurs(bool);
+
+    // The blur engine options for raster image filtering, as configured through SkGraphics.
+    static SkBlurEngine::RasterOptions RasterBlurOptions();
+
+    // The tiling options for image filters applied when drawing to an SkCanvas, as configured
+    // through SkGraphics.
+    static TiledOptions CanvasTiledOptions();
+
     /**
      * Create a filtered version of the 'src' image using this filter. This is basically a wrapper
      * around filterImage that prepares the skif::Context to filter the 'src' image directly,
@@ -129,6 +184,16 @@ public:
 
     uint32_t uniqueID() const { return fUniqueID; }
 
+    // A hash of this filter's flattened DAG, so that separately constructed filters with the same
+    // parameters have the same hash. Images, pictures and typefaces referenced by the DAG
+    // contribute their unique IDs rather than their contents. Each filter flattens only itself,
+    // with the hashes of its inputs in place of their contents, once, on first use.
+    uint64_t contentHash() const;
+
+    // The flattened content that contentHash() is computed from. It refers to the inputs, images,
+    // pictures and typefaces only by hash or unique ID, so holding it keeps none of them alive.
+    sk_sp<SkData> content() const;
+
     static SkFlattenable::Type GetFlattenableType() {
         return kSkImageFilter_Type;
     }
@@ -304,6 +369,12 @@ private:
     bool fUsesSrcInput;
     uint32_t fUniqueID; // Globally unique
 
+    void computeContent() const;
+
+    mutable SkOnce fContentOnce;
+    mutable sk_sp<SkData> fContent;
+    mutable uint64_t fContentHash = 0;
+
     using INHERITED = SkImageFilter;
 };
 
@@ -108,6 +108,13 @@ public:
         }
     }
 
+    // Removes the least recently used entry, for caches that are bounded by something other than
+    // their count. The cache must not be empty.
+    void removeLeastRecentlyUsed() {
+        SkASSERT(fLRU.tail());
+        this->remove(fLRU.tail()->fKey);
+    }
+
     void remove(const K& key) {
         Entry** value = fMap.find(key);
         SkASSERT(value);
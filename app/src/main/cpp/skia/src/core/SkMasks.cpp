@@ -62,6 +62,20 @@ static uint8_t get_comp(uint32_t pixel, uint32_t mask, uint32_t shift,
     return convert_to_8((pixel & mask) >> shift, size);
 }
 
+// Same as get_comp(). Scaling by 255/(2^n - 1) and rounding matches the lookup table exactly.
+static SkMasks::Pixels get_comps(const SkMasks::Pixels& pixels, const SkMasks::MaskInfo& info) {
+    SkMasks::Pixels component = (pixels & info.mask) >> info.shift;
+    if (0 == info.size) {
+        return 0;
+    } else if (8 > info.size) {
+        const float scale = 255.0f / ((1 << info.size) - 1);
+        return skvx::cast<uint32_t>(skvx::cast<float>(component) * scale + 0.5f);
+    } else {
+        SkASSERT(8 == info.size);
+        return component;
+    }
+}
+
 /*
  *
  * Get a color component
@@ -80,6 +94,19 @@ uint8_t SkMasks::getAlpha(uint32_t pixel) const {
     return get_comp(pixel, fAlpha.mask, fAlpha.shift, fAlpha.size);
 }
 
+SkMasks::Pixels SkMasks::getReds(const Pixels& pixels) const {
+    return get_comps(pixels, fRed);
+}
+SkMasks::Pixels SkMasks::getGreens(const Pixels& pixels) const {
+    return get_comps(pixels, fGreen);
+}
+SkMasks::Pixels SkMasks::getBlues(const Pixels& pixels) const {
+    return get_comps(pixels, fBlue);
+}
+SkMasks::Pixels SkMasks::getAlphas(const Pixels& pixels) const {
+    return get_comps(pixels, fAlpha);
+}
+
 /*
  *
  * Process an input mask to obtain the necessary information
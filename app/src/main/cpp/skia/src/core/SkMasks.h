@@ -8,6 +8,7 @@
 #define SkMasks_DEFINED
 
 #include "include/core/SkTypes.h"
+#include "src/base/SkVx.h"
 
 #include <cstdint>
 
@@ -43,6 +44,13 @@ public:
     uint8_t getBlue(uint32_t pixel) const;
     uint8_t getAlpha(uint32_t pixel) const;
 
+    // Vector versions of the above, which return each component in the low byte of its lane.
+    using Pixels = skvx::Vec<8, uint32_t>;
+    Pixels getReds(const Pixels&) const;
+    Pixels getGreens(const Pixels&) const;
+    Pixels getBlues(const Pixels&) const;
+    Pixels getAlphas(const Pixels&) const;
+
     // Getter for the alpha mask
     // The alpha mask may be used in other decoding modes
     uint32_t getAlphaMask() const { return fAlpha.mask; }
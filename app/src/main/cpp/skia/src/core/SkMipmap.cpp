@@ -14,7 +14,9 @@
 #include "src/base/SkMathPriv.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkMipmapBuilder.h"
+#include "src/core/SkTaskGroup.h"
 
+#include <algorithm>
 #include <new>
 
 //
@@ -26,6 +28,38 @@
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Splitting a level into bands only pays off when each band has plenty of pixels to filter.
+static constexpr int64_t kMinPixelsPerBand = 64 * 1024;
+
+static void build_level(SkMipmapDownSampler* downsampler, const SkPixmap& dst,
+                        const SkPixmap& src, SkExecutor* executor) {
+    int bandCount = 1;
+    if (executor && downsampler->supportsRowBands() && src.height() > 1) {
+        bandCount = SkToInt(std::min<int64_t>(
+                dst.height(), sk_64_mul(dst.width(), dst.height()) / kMinPixelsPerBand));
+    }
+    if (bandCount < 2) {
+        downsampler->buildLevel(dst, src);
+        return;
+    }
+
+    // An odd src height means every dst row is filtered from three src rows.
+    const int extraSrcRow = src.height() & 1;
+    SkTaskGroup tasks(*executor);
+    tasks.batch(bandCount, [&](int i) {
+        const int top = i * dst.height() / bandCount;
+        const int bottom = (i + 1) * dst.height() / bandCount;
+        SkPixmap dstBand, srcBand;
+        SkAssertResult(dst.extractSubset(&dstBand,
+                                         SkIRect::MakeLTRB(0, top, dst.width(), bottom)));
+        SkAssertResult(src.extractSubset(&srcBand,
+                                         SkIRect::MakeLTRB(0, 2 * top, src.width(),
+                                                           2 * bottom + extraSrcRow)));
+        downsampler->buildLevel(dstBand, srcBand);
+    });
+    tasks.wait();
+}
+
 SkMipmap::SkMipmap(void* malloc, size_t size) : SkCachedData(malloc, size) {}
 SkMipmap::SkMipmap(size_t size, SkDiscardableMemory* dm) : SkCachedData(size, dm) {}
 
@@ -43,7 +77,7 @@ size_t SkMipmap::AllocLevelsSize(int levelCount, size_t pixelSize) {
 }
 
 SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
-                          bool computeContents) {
+                          bool computeContents, SkExecutor* executor) {
     if (src.width() <= 1 && src.height() <= 1) {
         return nullptr;
     }
@@ -120,7 +154,7 @@ SkMipmap* SkMipmap::Build(const SkPixmap& src, SkDiscardableFactoryProc fact,
 
         const SkPixmap& dstPM = levels[i].fPixmap;
         if (downsampler) {
-            downsampler->buildLevel(dstPM, srcPM);
+            build_level(downsampler.get(), dstPM, srcPM, executor);
         }
         srcPM = dstPM;
         addr += height * rowBytes;
@@ -188,6 +222,17 @@ SkISize SkMipmap::ComputeLevelSize(int baseWidth, int baseHeight, int level) {
     return SkISize::Make(width, height);
 }
 
+bool SkMipmap::IsLevelSize(SkISize base, int level, SkISize size) {
+    const SkISize expected = ComputeLevelSize(base, level - 1);
+    if (expected.isEmpty() || size == base) {
+        return false;
+    }
+    auto matches = [](int actual, int expected) {
+        return actual == expected || actual == expected + 1;
+    };
+    return matches(size.width(), expected.width()) && matches(size.height(), expected.height());
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // Returns fractional level value. floor(level) is the index of the larger level.
@@ -231,6 +276,7 @@ bool SkMipmap::extractLevel(SkSize scaleSize, Level* levelPtr) const {
     if (level > fCount) {
         level = fCount;
     }
+    this->ensureLevel(level - 1);
     if (levelPtr) {
         *levelPtr = fLevels[level - 1];
         // need to augment with our colorspace
@@ -273,6 +319,45 @@ SkMipmap* SkMipmap::Build(const SkBitmap& src, SkDiscardableFactoryProc fact) {
     return Build(srcPixmap, fact);
 }
 
+SkMipmap* SkMipmap::BuildLazy(const SkBitmap& src, SkDiscardableFactoryProc fact,
+                             SkExecutor* executor) {
+    SkPixmap srcPixmap;
+    if (!src.peekPixels(&srcPixmap)) {
+        return nullptr;
+    }
+    std::unique_ptr<SkMipmapDownSampler> downsampler = MakeDownSampler(srcPixmap);
+    if (!downsampler) {
+        return nullptr;
+    }
+    SkMipmap* mipmap = Build(srcPixmap, fact, /*computeContents=*/false);
+    if (!mipmap) {
+        return nullptr;
+    }
+    mipmap->fLazyBase = src;
+    mipmap->fLazyDownSampler = std::move(downsampler);
+    mipmap->fLazyLevelOnce = std::make_unique<SkOnce[]>(mipmap->fCount);
+    mipmap->fLazyExecutor = executor;
+    return mipmap;
+}
+
+size_t SkMipmap::lazyBaseSize() const {
+    return fLazyLevelOnce ? fLazyBase.computeByteSize() : 0;
+}
+
+void SkMipmap::ensureLevel(int index) const {
+    if (!fLazyLevelOnce) {
+        return;
+    }
+    SkASSERT(fLevels && index >= 0 && index < fCount);
+    fLazyLevelOnce[index]([this, index] {
+        if (index > 0) {
+            this->ensureLevel(index - 1);
+        }
+        const SkPixmap& src = index > 0 ? fLevels[index - 1].fPixmap : fLazyBase.pixmap();
+        build_level(fLazyDownSampler.get(), fLevels[index].fPixmap, src, fLazyExecutor);
+    });
+}
+
 int SkMipmap::countLevels() const {
     return fCount;
 }
@@ -287,6 +372,7 @@ bool SkMipmap::getLevel(int index, Level* levelPtr) const {
     if (index > fCount - 1) {
         return false;
     }
+    this->ensureLevel(index);
     if (levelPtr) {
         *levelPtr = fLevels[index];
         // need to augment with our colorspace
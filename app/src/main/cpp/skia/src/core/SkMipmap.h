@@ -8,17 +8,19 @@
 #ifndef SkMipmap_DEFINED
 #define SkMipmap_DEFINED
 
+#include "include/core/SkBitmap.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkScalar.h"
 #include "include/core/SkSize.h"
+#include "include/private/base/SkOnce.h"
 #include "src/core/SkCachedData.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/shaders/SkShaderBase.h"
 #include <memory>
 
-class SkBitmap;
 class SkData;
 class SkDiscardableMemory;
+class SkExecutor;
 class SkMipmapBuilder;
 
 typedef SkDiscardableMemory* (*SkDiscardableFactoryProc)(size_t bytes);
@@ -27,6 +29,12 @@ struct SkMipmapDownSampler {
     virtual ~SkMipmapDownSampler() {}
 
     virtual void buildLevel(const SkPixmap& dst, const SkPixmap& src) = 0;
+
+    // Returns true if buildLevel() may be called concurrently on horizontal bands of a level.
+    // Each band's src holds the rows 2*top up to 2*bottom of the full src (plus one more row
+    // when the full src has an odd height greater than 1), where [top, bottom) are the band's
+    // dst rows.
+    virtual bool supportsRowBands() const { return false; }
 };
 
 /*
@@ -41,11 +49,23 @@ public:
     ~SkMipmap() override;
     // Allocate and fill-in a mipmap. If computeContents is false, we just allocated
     // and compute the sizes/rowbytes, but leave the pixel-data uninitialized.
+    // If an executor is given, large levels are generated in bands of rows on it.
     static SkMipmap* Build(const SkPixmap& src, SkDiscardableFactoryProc,
-                           bool computeContents = true);
+                           bool computeContents = true, SkExecutor* executor = nullptr);
 
     static SkMipmap* Build(const SkBitmap& src, SkDiscardableFactoryProc);
 
+    // Like Build(), but each level is generated the first time it is returned by getLevel() or
+    // extractLevel() (along with any larger levels it depends on), so draws only pay for the
+    // levels they sample. The mipmap keeps a ref on src's pixels until it is destroyed; see
+    // lazyBaseSize(). If an executor is given, it must outlive the mipmap.
+    static SkMipmap* BuildLazy(const SkBitmap& src, SkDiscardableFactoryProc,
+                               SkExecutor* executor = nullptr);
+
+    // The bytes of the src pixels a lazy mipmap keeps alive, or 0 if it isn't lazy. They are not
+    // part of size().
+    size_t lazyBaseSize() const;
+
     // Determines how many levels a SkMipmap will have without creating that mipmap.
     // This does not include the base mipmap level that the user provided when
     // creating the SkMipmap.
@@ -60,6 +80,12 @@ public:
         return ComputeLevelSize(s.width(), s.height(), level);
     }
 
+    // Returns true if |size| can stand in for mipmap level |level| of a base image with
+    // dimensions |base|. Unlike ComputeLevelSize, |level| counts the base level, so 1 is the
+    // first level smaller than the base. Decoders that scale by a power of two may round up rather
+    // than down, so each dimension may be one more than ComputeLevelSize's.
+    static bool IsLevelSize(SkISize base, int level, SkISize size);
+
     // Computes the fractional level based on the scaling in X and Y.
     static float ComputeLevel(SkSize scaleSize);
 
@@ -96,6 +122,15 @@ private:
     Level*              fLevels;    // managed by the baseclass, may be null due to onDataChanged.
     int                 fCount;
 
+    // Only set for mipmaps built with BuildLazy().
+    SkBitmap                             fLazyBase;
+    std::unique_ptr<SkMipmapDownSampler> fLazyDownSampler;
+    std::unique_ptr<SkOnce[]>            fLazyLevelOnce;
+    SkExecutor*                          fLazyExecutor = nullptr;
+
+    // Generates level |index| (and the levels above it) if the mipmap is lazy and hasn't yet.
+    void ensureLevel(int index) const;
+
     SkMipmap(void* malloc, size_t size);
     SkMipmap(size_t size, SkDiscardableMemory* dm);
 
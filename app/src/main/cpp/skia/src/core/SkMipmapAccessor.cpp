@@ -18,14 +18,22 @@
 #include "src/core/SkMipmap.h"
 #include "src/image/SkImage_Base.h"
 
+#include <utility>
+
 class SkImage;
 
-// Try to load from the base image, or from the cache
-static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
+// Load from the base image or from the cache, without building anything
+static sk_sp<const SkMipmap> find_mips(const SkImage_Base* image) {
     sk_sp<const SkMipmap> mips = image->refMips();
     if (!mips) {
         mips.reset(SkMipmapCache::FindAndRef(SkBitmapCacheDesc::Make(image)));
     }
+    return mips;
+}
+
+// Try to load from the base image, or from the cache
+static sk_sp<const SkMipmap> try_load_mips(const SkImage_Base* image) {
+    sk_sp<const SkMipmap> mips = find_mips(image);
     if (!mips) {
         mips.reset(SkMipmapCache::AddAndRef(image));
     }
@@ -72,12 +80,40 @@ SkMipmapAccessor::SkMipmapAccessor(const SkImage_Base* image, const SkMatrix& in
     float lowerWeight = level - levelNum;   // fract(level)
     SkASSERT(levelNum >= 0);
 
+    // Lazy images may be able to decode a downscaled variant directly, which avoids decoding (and
+    // caching) the full-size image only to build mips from it. A variant stands in for the mip
+    // level with the same scale bucket, as long as it has that level's dimensions. Mips that are
+    // already cached are cheaper still, so a variant is only used when there are none.
+    if (levelNum > 0) {
+        fCurrMip = find_mips(image);
+    }
+    auto getVariant = [image](int levelNum, SkBitmap* variant) {
+        return image->getScaledROPixels(levelNum, variant) &&
+               SkMipmap::IsLevelSize(image->dimensions(), levelNum, variant->dimensions());
+    };
+    SkBitmap upperVariant, lowerVariant;
+    if (levelNum > 0 && !fCurrMip && getVariant(levelNum, &upperVariant)) {
+        fBaseStorage = std::move(upperVariant);
+        fUpper = fBaseStorage.pixmap();
+        if (resolvedMode == SkMipmapMode::kLinear && lowerWeight > 0 &&
+            getVariant(levelNum + 1, &lowerVariant)) {
+            fLowerStorage = std::move(lowerVariant);
+            fLower = fLowerStorage.pixmap();
+            fLowerWeight = lowerWeight;
+            fLowerInv = scale(fLower);
+        }
+        fUpperInv = scale(fUpper);
+        return;
+    }
+
     if (levelNum == 0) {
         load_upper_from_base();
     }
     // load fCurrMip if needed
     if (levelNum > 0 || (resolvedMode == SkMipmapMode::kLinear && lowerWeight > 0)) {
-        fCurrMip = try_load_mips(image);
+        if (!fCurrMip) {
+            fCurrMip = try_load_mips(image);
+        }
         if (!fCurrMip) {
             load_upper_from_base();
             resolvedMode = SkMipmapMode::kNone;
@@ -50,6 +50,7 @@ private:
 
     // these manage lifetime for the buffers
     SkBitmap              fBaseStorage;
+    SkBitmap              fLowerStorage;    // only used for downscaled variants
     sk_sp<const SkMipmap> fCurrMip;
 
 public:
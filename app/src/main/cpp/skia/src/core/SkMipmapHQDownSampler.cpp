@@ -140,17 +140,19 @@ struct ColorTypeFilter_16 {
 
 struct ColorTypeFilter_1010102 {
     typedef uint32_t Type;
+    // Each channel gets 16 bits, enough for the 3x3 filter's sum of 16 samples. (Alpha needs
+    // 6 bits for that sum, so it can't start any higher than bit 58.)
     static uint64_t Expand(uint64_t x) {
         return (((x      ) & 0x3ff)      ) |
-        (((x >> 10) & 0x3ff) << 20) |
-        (((x >> 20) & 0x3ff) << 40) |
-        (((x >> 30) & 0x3  ) << 60);
+        (((x >> 10) & 0x3ff) << 16) |
+        (((x >> 20) & 0x3ff) << 32) |
+        (((x >> 30) & 0x3  ) << 48);
     }
     static uint32_t Compact(uint64_t x) {
         return (((x      ) & 0x3ff)      ) |
-        (((x >> 20) & 0x3ff) << 10) |
-        (((x >> 40) & 0x3ff) << 20) |
-        (((x >> 60) & 0x3  ) << 30);
+        (((x >> 16) & 0x3ff) << 10) |
+        (((x >> 32) & 0x3ff) << 20) |
+        (((x >> 48) & 0x3  ) << 30);
     }
 };
 
@@ -162,7 +164,7 @@ template <typename T> T shift_right(const T& x, int bits) {
     return x >> bits;
 }
 
-skvx::float4 shift_right(const skvx::float4& x, int bits) {
+template <int N> skvx::Vec<N, float> shift_right(const skvx::Vec<N, float>& x, int bits) {
     return x * (1.0f / (1 << bits));
 }
 
@@ -170,7 +172,7 @@ template <typename T> T shift_left(const T& x, int bits) {
     return x << bits;
 }
 
-skvx::float4 shift_left(const skvx::float4& x, int bits) {
+template <int N> skvx::Vec<N, float> shift_left(const skvx::Vec<N, float>& x, int bits) {
     return x * (1 << bits);
 }
 
@@ -374,6 +376,154 @@ template <typename F> void downsample_3_3(void* dst, const void* src, size_t src
     }
 }
 
+//
+//  The most common color types also get vectorized 2x2, 2x3, 3x2 and 3x3 filters, which produce
+//  N dst pixels at a time. Each ColorTypeVec expands the even src pixels of a run of 2N pixels
+//  (p[0], p[2], ... p[2N-2]) into one vector, so the odd pixels are a Load() away at p + 1 and
+//  the right-hand pixels of a triangle filter are at p + 2. Sums are formed in the same order as
+//  the scalar filters above, so both produce identical results (including for F16). Whatever
+//  is left of a row after the last full vector is handed to the scalar filter.
+//
+
+struct ColorTypeVec_8888 {
+    using Filter = ColorTypeFilter_8888;
+    using Type = uint32_t;
+    static constexpr int N = 4;
+    static skvx::Vec<16, uint16_t> Load(const uint32_t* p) {
+        skvx::Vec<4, uint32_t> even = skvx::shuffle<0,2,4,6>(skvx::Vec<8, uint32_t>::Load(p));
+        return skvx::cast<uint16_t>(sk_bit_cast<skvx::Vec<16, uint8_t>>(even));
+    }
+    static void Store(uint32_t* d, const skvx::Vec<16, uint16_t>& x) {
+        skvx::cast<uint8_t>(x).store(d);
+    }
+};
+
+struct ColorTypeVec_8 {
+    using Filter = ColorTypeFilter_8;
+    using Type = uint8_t;
+    static constexpr int N = 16;
+    static skvx::Vec<16, uint16_t> Load(const uint8_t* p) {
+        // The even bytes are the low bytes of each (little-endian) pair.
+        return skvx::Vec<16, uint16_t>::Load(p) & 0xFF;
+    }
+    static void Store(uint8_t* d, const skvx::Vec<16, uint16_t>& x) {
+        skvx::cast<uint8_t>(x).store(d);
+    }
+};
+
+struct ColorTypeVec_RGBA_F16 {
+    using Filter = ColorTypeFilter_RGBA_F16;
+    using Type = uint64_t;
+    static constexpr int N = 4;
+    static skvx::Vec<16, float> Load(const uint64_t* p) {
+        skvx::Vec<4, uint64_t> even = skvx::shuffle<0,2,4,6>(skvx::Vec<8, uint64_t>::Load(p));
+        return from_half(sk_bit_cast<skvx::Vec<16, uint16_t>>(even));
+    }
+    static void Store(uint64_t* d, const skvx::Vec<16, float>& x) {
+        to_half(x).store(d);
+    }
+};
+
+struct ColorTypeVec_1010102 {
+    using Filter = ColorTypeFilter_1010102;
+    using Type = uint32_t;
+    static constexpr int N = 4;
+    // The channels are kept in separate quarters of the vector: r in lo.lo, g in lo.hi, etc.
+    static skvx::Vec<16, uint32_t> Load(const uint32_t* p) {
+        skvx::Vec<4, uint32_t> even = skvx::shuffle<0,2,4,6>(skvx::Vec<8, uint32_t>::Load(p));
+        return skvx::join(skvx::join((even      ) & 0x3ff, (even >> 10) & 0x3ff),
+                          skvx::join((even >> 20) & 0x3ff, (even >> 30)        ));
+    }
+    static void Store(uint32_t* d, const skvx::Vec<16, uint32_t>& x) {
+        (x.lo.lo | (x.lo.hi << 10) | (x.hi.lo << 20) | (x.hi.hi << 30)).store(d);
+    }
+};
+
+// The vector loops stop while at least one dst pixel is left, since the last vector of a row
+// reads one src pixel past the 2N it filters (two for the triangle filters).
+
+template <typename V> void downsample_2_2_vec(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const typename V::Type*>(src);
+    auto p1 = (const typename V::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename V::Type*>(dst);
+
+    int i = 0;
+    for (; i + V::N < count; i += V::N) {
+        auto c = V::Load(p0) + V::Load(p1) + V::Load(p0 + 1) + V::Load(p1 + 1);
+        V::Store(d, shift_right(c, 2));
+        p0 += 2 * V::N;
+        p1 += 2 * V::N;
+        d += V::N;
+    }
+    downsample_2_2<typename V::Filter>(d, p0, srcRB, count - i);
+}
+
+template <typename V> void downsample_2_3_vec(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const typename V::Type*>(src);
+    auto p1 = (const typename V::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename V::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename V::Type*>(dst);
+
+    int i = 0;
+    for (; i + V::N < count; i += V::N) {
+        auto c = add_121(V::Load(p0    ), V::Load(p1    ), V::Load(p2    )) +
+                 add_121(V::Load(p0 + 1), V::Load(p1 + 1), V::Load(p2 + 1));
+        V::Store(d, shift_right(c, 3));
+        p0 += 2 * V::N;
+        p1 += 2 * V::N;
+        p2 += 2 * V::N;
+        d += V::N;
+    }
+    downsample_2_3<typename V::Filter>(d, p0, srcRB, count - i);
+}
+
+template <typename V> void downsample_3_2_vec(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const typename V::Type*>(src);
+    auto p1 = (const typename V::Type*)((const char*)p0 + srcRB);
+    auto d = static_cast<typename V::Type*>(dst);
+
+    int i = 0;
+    for (; i + V::N < count; i += V::N) {
+        auto a = V::Load(p0) + V::Load(p1);
+        auto b0 = V::Load(p0 + 1);
+        auto b1 = V::Load(p1 + 1);
+        auto b = b0 + b0 + b1 + b1;
+        auto c = V::Load(p0 + 2) + V::Load(p1 + 2);
+
+        auto sum = a + b + c;
+        V::Store(d, shift_right(sum, 3));
+        p0 += 2 * V::N;
+        p1 += 2 * V::N;
+        d += V::N;
+    }
+    downsample_3_2<typename V::Filter>(d, p0, srcRB, count - i);
+}
+
+template <typename V> void downsample_3_3_vec(void* dst, const void* src, size_t srcRB, int count) {
+    SkASSERT(count > 0);
+    auto p0 = static_cast<const typename V::Type*>(src);
+    auto p1 = (const typename V::Type*)((const char*)p0 + srcRB);
+    auto p2 = (const typename V::Type*)((const char*)p1 + srcRB);
+    auto d = static_cast<typename V::Type*>(dst);
+
+    int i = 0;
+    for (; i + V::N < count; i += V::N) {
+        auto a = add_121(V::Load(p0), V::Load(p1), V::Load(p2));
+        auto b = shift_left(add_121(V::Load(p0 + 1), V::Load(p1 + 1), V::Load(p2 + 1)), 1);
+        auto c = add_121(V::Load(p0 + 2), V::Load(p1 + 2), V::Load(p2 + 2));
+
+        auto sum = a + b + c;
+        V::Store(d, shift_right(sum, 4));
+        p0 += 2 * V::N;
+        p1 += 2 * V::N;
+        p2 += 2 * V::N;
+        d += V::N;
+    }
+    downsample_3_3<typename V::Filter>(d, p0, srcRB, count - i);
+}
 
 typedef void FilterProc(void*, const void* srcPtr, size_t srcRB, int count);
 
@@ -388,6 +538,7 @@ struct HQDownSampler : SkMipmapDownSampler {
     FilterProc* proc_3_3 = nullptr;
 
     void buildLevel(const SkPixmap& dst, const SkPixmap& src) override;
+    bool supportsRowBands() const override { return true; }
 };
 
 void HQDownSampler::buildLevel(const SkPixmap& dst, const SkPixmap& src) {
@@ -454,11 +605,11 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_8888>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8888>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8888>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8888>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8888>;
+            proc_2_2 = downsample_2_2_vec<ColorTypeVec_8888>;
+            proc_2_3 = downsample_2_3_vec<ColorTypeVec_8888>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8888>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8888>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8888>;
+            proc_3_2 = downsample_3_2_vec<ColorTypeVec_8888>;
+            proc_3_3 = downsample_3_3_vec<ColorTypeVec_8888>;
             break;
         case kRGB_565_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_565>;
@@ -486,22 +637,22 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_8>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_8>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_8>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_8>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_8>;
+            proc_2_2 = downsample_2_2_vec<ColorTypeVec_8>;
+            proc_2_3 = downsample_2_3_vec<ColorTypeVec_8>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_8>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_8>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_8>;
+            proc_3_2 = downsample_3_2_vec<ColorTypeVec_8>;
+            proc_3_3 = downsample_3_3_vec<ColorTypeVec_8>;
             break;
         case kRGBA_F16Norm_SkColorType:
         case kRGBA_F16_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_RGBA_F16>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_RGBA_F16>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_RGBA_F16>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_RGBA_F16>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_RGBA_F16>;
+            proc_2_2 = downsample_2_2_vec<ColorTypeVec_RGBA_F16>;
+            proc_2_3 = downsample_2_3_vec<ColorTypeVec_RGBA_F16>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_RGBA_F16>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_RGBA_F16>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_RGBA_F16>;
+            proc_3_2 = downsample_3_2_vec<ColorTypeVec_RGBA_F16>;
+            proc_3_3 = downsample_3_3_vec<ColorTypeVec_RGBA_F16>;
             break;
         case kR8G8_unorm_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_88>;
@@ -538,11 +689,11 @@ std::unique_ptr<SkMipmapDownSampler> SkMipmap::MakeDownSampler(const SkPixmap& r
             proc_1_2 = downsample_1_2<ColorTypeFilter_1010102>;
             proc_1_3 = downsample_1_3<ColorTypeFilter_1010102>;
             proc_2_1 = downsample_2_1<ColorTypeFilter_1010102>;
-            proc_2_2 = downsample_2_2<ColorTypeFilter_1010102>;
-            proc_2_3 = downsample_2_3<ColorTypeFilter_1010102>;
+            proc_2_2 = downsample_2_2_vec<ColorTypeVec_1010102>;
+            proc_2_3 = downsample_2_3_vec<ColorTypeVec_1010102>;
             proc_3_1 = downsample_3_1<ColorTypeFilter_1010102>;
-            proc_3_2 = downsample_3_2<ColorTypeFilter_1010102>;
-            proc_3_3 = downsample_3_3<ColorTypeFilter_1010102>;
+            proc_3_2 = downsample_3_2_vec<ColorTypeVec_1010102>;
+            proc_3_3 = downsample_3_3_vec<ColorTypeVec_1010102>;
             break;
         case kA16_float_SkColorType:
             proc_1_2 = downsample_1_2<ColorTypeFilter_Alpha_F16>;
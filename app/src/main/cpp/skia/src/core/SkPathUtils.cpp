@@ -15,6 +15,7 @@
 #include "include/core/SkScalar.h"
 #include "include/core/SkStrokeRec.h"
 #include "src/core/SkMatrixPriv.h"
+#include "src/core/SkStrokeCache.h"
 
 namespace skpathutils {
 
@@ -62,7 +63,26 @@ bool FillPathWithPaint(const SkPath& origSrc, const SkPaint& paint, SkPathBuilde
         pathStorage = builder->detach();
         srcPtr = &pathStorage;
     }
-    if (!rec.applyToPath(builder, *srcPtr)) {
+    bool useCache = false;
+    if (srcPtr == &origSrc && SkStrokeCache::CanCache(origSrc, rec)) {
+        // Strokes that are drawn again are made at a bucketed scale, so redraws at nearby scales
+        // can share the outline.
+        SkStrokeRec bucketed = rec;
+        bucketed.setResScale(SkStrokeCache::BucketResScale(rec.getResScale()));
+        if (SkStrokeCache::ShouldCache(origSrc, bucketed)) {
+            rec = bucketed;
+            useCache = true;
+        }
+    }
+    if (useCache) {
+        if (!SkStrokeCache::Find(origSrc, rec, builder)) {
+            if (rec.applyToPath(builder, origSrc)) {
+                SkStrokeCache::Add(origSrc, rec, builder->snapshot());
+            } else {
+                *builder = origSrc;
+            }
+        }
+    } else if (!rec.applyToPath(builder, *srcPtr)) {
         *builder = *srcPtr;
     }
 
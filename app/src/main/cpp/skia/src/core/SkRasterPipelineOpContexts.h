@@ -183,6 +183,23 @@ struct EvenlySpaced2StopGradientCtx {
     float bias[kRGBAChannels];
 };
 
+// A clamped two-stop linear or radial gradient, evaluated straight from the seeded device
+// coordinates: `matrix` maps them to gradient space, t is x (linear) or |xy| (radial), and the
+// color is premultiplied afterwards when `premul` is set.
+struct TwoStopGradientCtx {
+    float matrix[6];
+    float factor[kRGBAChannels];
+    float bias[kRGBAChannels];
+    bool  premul;
+};
+
+// Final gradient colors sampled at `scale + 1` evenly spaced t in [0,1], stored as interleaved
+// RGBA. One extra copy of the last entry follows so that every lookup can lerp to its neighbor.
+struct GradientLUTCtx {
+    const float* rgba;
+    float scale;
+};
+
 struct Conical2PtCtx {
     uint32_t fMask[kMaxStride_highp];
     float    fP0,
@@ -223,6 +240,13 @@ struct BinaryOpCtx {
     SkRPOffset src;
 };
 
+// Runs a sequence of SkSL ops that RP::NativeCodeBuilder has compiled into machine code. The
+// function reads and writes slots relative to `base`, and loads uniforms relative to `uniforms`.
+struct NativeCodeCtx {
+    void (*fn)(std::byte* base, const float* uniforms);
+    const float* uniforms;
+};
+
 struct TernaryOpCtx {
     SkRPOffset dst;
     SkRPOffset delta;
@@ -49,6 +49,7 @@
     M(evenly_spaced_gradient)                                         \
     M(gradient)                                                       \
     M(evenly_spaced_2_stop_gradient)                                  \
+    M(linear_2_stop_gradient) M(radial_2_stop_gradient)               \
     M(xy_to_unit_angle)                                               \
     M(xy_to_radius)                                                   \
     M(emboss)                                                         \
@@ -155,7 +156,8 @@
         M(cmpne_n_floats) M(cmpne_float)  M(cmpne_2_floats) M(cmpne_3_floats) M(cmpne_4_floats) \
     M(cmpne_imm_int)                                                                            \
         M(cmpne_n_ints)   M(cmpne_int)    M(cmpne_2_ints)   M(cmpne_3_ints)   M(cmpne_4_ints)   \
-    M(trace_line)         M(trace_var)    M(trace_enter)    M(trace_exit)     M(trace_scope)
+    M(trace_line)         M(trace_var)    M(trace_enter)    M(trace_exit)     M(trace_scope)    \
+    M(native_code)
 
 // `SK_RASTER_PIPELINE_OPS_HIGHP_ONLY` defines ops that are only available in highp; this subset
 // includes all of SkSL.
@@ -201,6 +203,7 @@
     M(accumulate)                                                              \
     M(perlin_noise)                                                            \
     M(mipmap_linear_init) M(mipmap_linear_update) M(mipmap_linear_finish)      \
+    M(gradient_lut)                                                            \
     M(xy_to_2pt_conical_strip)                                                 \
     M(xy_to_2pt_conical_focal_on_circle)                                       \
     M(xy_to_2pt_conical_well_behaved)                                          \
@@ -13,12 +13,15 @@
 #include "include/core/SkColor.h"
 #include "include/core/SkColorFilter.h"
 #include "include/core/SkData.h"
+#include "include/core/SkStream.h"
 #include "include/private/base/SkAlign.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMutex.h"
 #include "include/private/base/SkOnce.h"
+#include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/base/SkBuffer.h"
 #include "src/base/SkEnumBitMask.h"
 #include "src/base/SkNoDestructor.h"
 #include "src/core/SkBlenderBase.h"
@@ -62,6 +65,11 @@
 #include "src/sksl/transform/SkSLTransform.h"
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
 
 using namespace skia_private;
 
@@ -70,6 +78,8 @@ struct SkIPoint;
 
 constexpr bool kRPEnableLiveTrace = false;
 
+static std::atomic<SkRuntimeEffect::ProgramCache*> gProgramCache{nullptr};
+
 using ChildType = SkRuntimeEffect::ChildType;
 
 static bool init_uniform_type(const SkSL::Context& ctx,
@@ -220,6 +230,35 @@ const SkSL::RP::Program* SkRuntimeEffect::getRPProgram(SkSL::DebugTracePriv* deb
     // By using an SkOnce, we avoid thread hazards and behave in a conceptually const way, but we
     // can avoid the cost of invoking the RP code generator until it's actually needed.
     fCompileRPProgramOnce([&] {
+        // The persistent program cache is only consulted for untraced programs; traced programs
+        // carry debug info which is not serialized.
+        ProgramCache* programCache = gProgramCache.load(std::memory_order_acquire);
+        sk_sp<SkData> programKey;
+        if (programCache && !debugTrace && !kRPEnableLiveTrace) {
+            programKey = this->makeProgramCacheKey();
+            if (sk_sp<SkData> data = programCache->load(*programKey)) {
+                // Each entry starts with the source it was compiled from, so that an entry
+                // written for an effect whose key collides with this one is never used.
+                const std::string& source = this->source();
+                SkRBuffer buffer(data->data(), data->size());
+                uint32_t sourceLength;
+                const void* storedSource;
+                if (buffer.readU32(&sourceLength) && sourceLength == source.size() &&
+                    (storedSource = buffer.skip(sourceLength)) &&
+                    !memcmp(storedSource, source.data(), sourceLength)) {
+                    const_cast<SkRuntimeEffect*>(this)->fRPProgram =
+                            SkSL::RP::Program::Deserialize(data->bytes() + buffer.pos(),
+                                                           buffer.available(),
+                                                           SkToInt(fChildren.size()));
+                    if (fRPProgram &&
+                        fRPProgram->numUniforms() * sizeof(float) == this->uniformSize()) {
+                        return;
+                    }
+                    const_cast<SkRuntimeEffect*>(this)->fRPProgram = nullptr;
+                }
+            }
+        }
+
         // We generally do not run the inliner when an SkRuntimeEffect program is initially created,
         // because the final compile to native shader code will do this. However, in SkRP, there's
         // no additional compilation occurring, so we need to manually inline here if we want the
@@ -258,11 +297,100 @@ const SkSL::RP::Program* SkRuntimeEffect::getRPProgram(SkSL::DebugTracePriv* deb
                 SkDebugf("----- RP unsupported -----\n\n");
             }
         }
+
+        if (programKey && fRPProgram) {
+            const std::string& source = this->source();
+            SkDynamicMemoryWStream stream;
+            if (SkTFitsIn<uint32_t>(source.size()) && stream.write32(source.size()) &&
+                stream.write(source.data(), source.size()) && fRPProgram->serialize(&stream)) {
+                programCache->store(*programKey, *stream.detachAsData());
+            }
+        }
     });
 
     return fRPProgram.get();
 }
 
+sk_sp<SkData> SkRuntimeEffect::makeProgramCacheKey() const {
+    // fHash only covers 32 bits of the source, so the key also carries a 64-bit hash of it and
+    // its length. The flags capture everything else (the effect type and whether optimization is
+    // disabled) which influences the compiled program. Keys can still collide, so stored entries
+    // also hold the source, which getRPProgram compares before using an entry.
+    struct Key {
+        uint64_t sourceHash;
+        uint64_t sourceLength;
+        uint32_t hash;
+        uint32_t flags;
+    };
+    const Key key{SkChecksum::Hash64(this->source().c_str(), this->source().size(), fHash),
+                  this->source().size(),
+                  fHash,
+                  fFlags};
+    return SkData::MakeWithCopy(&key, sizeof(key));
+}
+
+void SkRuntimeEffect::SetProgramCache(ProgramCache* cache) {
+    gProgramCache.store(cache, std::memory_order_release);
+}
+
+namespace {
+
+std::atomic<uint64_t> gTempFileCount{0};
+
+class DirectoryProgramCache final : public SkRuntimeEffect::ProgramCache {
+public:
+    explicit DirectoryProgramCache(const char* directory) : fDirectory(directory) {}
+
+    sk_sp<SkData> load(const SkData& key) override {
+        return SkData::MakeFromFileName(this->pathForKey(key).c_str());
+    }
+
+    void store(const SkData& key, const SkData& data) override {
+        // Write to a file of our own and rename it into place, so that a concurrent load (in
+        // this process or another) never sees a partially written entry.
+        const SkString path = this->pathForKey(key);
+        const uint64_t tempID[] = {gTempFileCount.fetch_add(1, std::memory_order_relaxed),
+                                   (uint64_t)(uintptr_t)this,
+                                   (uint64_t)std::chrono::steady_clock::now()
+                                           .time_since_epoch().count()};
+        const SkString tempPath = SkStringPrintf(
+                "%s.%016" PRIx64 ".tmp", path.c_str(), SkChecksum::Hash64(tempID, sizeof(tempID)));
+        bool written;
+        {
+            SkFILEWStream stream(tempPath.c_str());
+            written = stream.isValid() && stream.write(data.data(), data.size());
+        }
+        if (!written || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+            std::remove(tempPath.c_str());
+        }
+    }
+
+private:
+    SkString pathForKey(const SkData& key) const {
+        SkString path = fDirectory;
+        if (!path.isEmpty() && !path.endsWith('/')) {
+            path.append("/");
+        }
+        for (size_t i = 0; i < key.size(); ++i) {
+            path.appendf("%02x", key.bytes()[i]);
+        }
+        path.append(".skrp");
+        return path;
+    }
+
+    const SkString fDirectory;
+};
+
+}  // namespace
+
+std::unique_ptr<SkRuntimeEffect::ProgramCache> SkRuntimeEffect::MakeDirectoryProgramCache(
+        const char* directory) {
+    if (!directory) {
+        return nullptr;
+    }
+    return std::make_unique<DirectoryProgramCache>(directory);
+}
+
 SkSpan<const float> SkRuntimeEffectPriv::UniformsAsSpan(
         SkSpan<const SkRuntimeEffect::Uniform> uniforms,
         sk_sp<const SkData> originalData,
@@ -470,9 +598,110 @@ SkSL::ProgramSettings SkRuntimeEffect::MakeSettings(const Options& options) {
 // in the IR generator would provide better errors messages (with locations).
 #define RETURN_FAILURE(...) return Result{nullptr, SkStringPrintf(__VA_ARGS__)}
 
+namespace {
+
+// A successfully created effect, along with the options which are not recorded on the effect
+// itself. The key hash is only used to find candidates; a hit is confirmed by comparing the full
+// source and options.
+struct CachedEffect {
+    sk_sp<SkRuntimeEffect> fEffect;
+    SkSL::ProgramKind fKind;
+    SkSL::Version fMaxVersionAllowed;
+    // Graphite may assign a stable key to an effect after it has been created. Such an effect is
+    // no longer handed out for the options it was created with.
+    uint32_t fStableKey;
+    bool fForceUnoptimized;
+    bool fAllowPrivateAccess;
+};
+
+constexpr int kDefaultEffectCacheLimit = 128;
+
+struct EffectCache {
+    SkMutex fMutex;
+    int fLimit = kDefaultEffectCacheLimit;
+    std::unique_ptr<SkLRUCache<uint64_t, CachedEffect>> fCache =
+            std::make_unique<SkLRUCache<uint64_t, CachedEffect>>(kDefaultEffectCacheLimit);
+};
+
+EffectCache& effect_cache() {
+    static SkNoDestructor<EffectCache> cache;
+    return *cache;
+}
+
+}  // namespace
+
+void SkRuntimeEffectPriv::SetStableKey(SkRuntimeEffect* effect, uint32_t stableKey) {
+    // The effect may be shared through the effect cache, which reads the key under its lock to
+    // stop handing the effect out for options without the key.
+    SkAutoMutexExclusive lock(effect_cache().fMutex);
+    SkASSERT(!effect->fStableKey);
+    SkASSERT(SkKnownRuntimeEffects::IsViableUserDefinedKnownRuntimeEffect(stableKey));
+    effect->fStableKey = stableKey;
+}
+
+void SkRuntimeEffectPriv::ResetStableKey(SkRuntimeEffect* effect) {
+    SkAutoMutexExclusive lock(effect_cache().fMutex);
+    effect->fStableKey = 0;
+}
+
+int SkRuntimeEffect::SetCacheLimit(int count) {
+    EffectCache& cache = effect_cache();
+    SkAutoMutexExclusive lock(cache.fMutex);
+    const int previous = cache.fLimit;
+    cache.fLimit = std::max(count, 0);
+    cache.fCache = cache.fLimit > 0
+                           ? std::make_unique<SkLRUCache<uint64_t, CachedEffect>>(cache.fLimit)
+                           : nullptr;
+    return previous;
+}
+
 SkRuntimeEffect::Result SkRuntimeEffect::MakeFromSource(SkString sksl,
                                                         const Options& options,
                                                         SkSL::ProgramKind kind) {
+    uint64_t key = SkChecksum::Hash64(sksl.c_str(), sksl.size());
+    key = SkChecksum::Hash64(&kind, sizeof(kind), key);
+    key = SkChecksum::Hash64(&options.forceUnoptimized, sizeof(options.forceUnoptimized), key);
+    key = SkChecksum::Hash64(&options.allowPrivateAccess, sizeof(options.allowPrivateAccess), key);
+    key = SkChecksum::Hash64(&options.fStableKey, sizeof(options.fStableKey), key);
+    key = SkChecksum::Hash64(&options.maxVersionAllowed, sizeof(options.maxVersionAllowed), key);
+    key = SkChecksum::Hash64(options.fName.data(), options.fName.size(), key);
+
+    EffectCache& cache = effect_cache();
+    {
+        SkAutoMutexExclusive lock(cache.fMutex);
+        const CachedEffect* found = cache.fCache ? cache.fCache->find(key) : nullptr;
+        if (found &&
+            found->fKind == kind &&
+            found->fMaxVersionAllowed == options.maxVersionAllowed &&
+            found->fForceUnoptimized == options.forceUnoptimized &&
+            found->fAllowPrivateAccess == options.allowPrivateAccess &&
+            found->fStableKey == options.fStableKey &&
+            found->fEffect->fStableKey == options.fStableKey &&
+            found->fEffect->fName.equals(options.fName.data(), options.fName.size()) &&
+            found->fEffect->source() == std::string_view(sksl.c_str(), sksl.size())) {
+            return Result{found->fEffect, SkString()};
+        }
+    }
+
+    Result result = MakeFromSourceUncached(sksl, options, kind);
+    if (result.effect) {
+        SkAutoMutexExclusive lock(cache.fMutex);
+        if (cache.fCache) {
+            cache.fCache->insert_or_update(key,
+                                           CachedEffect{result.effect,
+                                                        kind,
+                                                        options.maxVersionAllowed,
+                                                        options.fStableKey,
+                                                        options.forceUnoptimized,
+                                                        options.allowPrivateAccess});
+        }
+    }
+    return result;
+}
+
+SkRuntimeEffect::Result SkRuntimeEffect::MakeFromSourceUncached(const SkString& sksl,
+                                                                const Options& options,
+                                                                SkSL::ProgramKind kind) {
     SkSL::Compiler compiler;
     SkSL::ProgramSettings settings = MakeSettings(options);
     std::unique_ptr<SkSL::Program> program =
@@ -686,14 +915,25 @@ SkRuntimeEffect::Result SkRuntimeEffect::MakeForBlender(SkString sksl, const Opt
 sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
         SkRuntimeEffect::Result (*make)(SkString sksl, const SkRuntimeEffect::Options&),
         SkString sksl) {
+    // Effects read while deserializing are kept apart from the effect cache behind
+    // SkRuntimeEffect::Make*, so that SkRuntimeEffect::SetCacheLimit() doesn't affect them. The
+    // SkSL comes from the serialized data, so the cache is bounded and least recently used
+    // effects are evicted. A hit is confirmed by comparing the full source.
+    struct DeserializedEffect {
+        SkRuntimeEffect::Result (*fMake)(SkString, const SkRuntimeEffect::Options&);
+        sk_sp<SkRuntimeEffect> fEffect;
+    };
     static SkNoDestructor<SkMutex> mutex;
-    static SkNoDestructor<SkLRUCache<uint64_t, sk_sp<SkRuntimeEffect>>> cache(11 /*arbitrary*/);
+    static SkNoDestructor<SkLRUCache<uint64_t, DeserializedEffect>> cache(11 /*arbitrary*/);
 
-    uint64_t key = SkChecksum::Hash64(sksl.c_str(), sksl.size());
+    const uint64_t key = SkChecksum::Hash64(&make, sizeof(make),
+                                            SkChecksum::Hash64(sksl.c_str(), sksl.size()));
     {
         SkAutoMutexExclusive _(*mutex);
-        if (sk_sp<SkRuntimeEffect>* found = cache->find(key)) {
-            return *found;
+        if (const DeserializedEffect* found = cache->find(key);
+            found && found->fMake == make &&
+            found->fEffect->source() == std::string_view(sksl.c_str(), sksl.size())) {
+            return found->fEffect;
         }
     }
 
@@ -709,7 +949,7 @@ sk_sp<SkRuntimeEffect> SkMakeCachedRuntimeEffect(
 
     {
         SkAutoMutexExclusive _(*mutex);
-        cache->insert_or_update(key, effect);
+        cache->insert_or_update(key, {make, effect});
     }
     return effect;
 }
@@ -93,12 +93,9 @@ public:
         return effect.fStableKey;
     }
 
-    // This method is only used on user-defined known runtime effects
-    static void SetStableKey(SkRuntimeEffect* effect, uint32_t stableKey) {
-        SkASSERT(!effect->fStableKey);
-        SkASSERT(SkKnownRuntimeEffects::IsViableUserDefinedKnownRuntimeEffect(stableKey));
-        effect->fStableKey = stableKey;
-    }
+    // This method is only used on user-defined known runtime effects. It synchronizes with the
+    // effect cache, which may be sharing 'effect' with other threads.
+    static void SetStableKey(SkRuntimeEffect* effect, uint32_t stableKey);
 
     // This method is only used for Skia-internal known runtime effects
     static void SetStableKeyOnOptions(SkRuntimeEffect::Options* options, uint32_t stableKey) {
@@ -107,9 +104,7 @@ public:
         options->fStableKey = stableKey;
     }
 
-    static void ResetStableKey(SkRuntimeEffect* effect) {
-        effect->fStableKey = 0;
-    }
+    static void ResetStableKey(SkRuntimeEffect* effect);
 
     static const SkSL::Program& Program(const SkRuntimeEffect& effect) {
         return *effect.fBaseProgram;
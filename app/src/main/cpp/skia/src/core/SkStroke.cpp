@@ -16,7 +16,10 @@
 #include "include/core/SkSpan.h"
 #include "include/private/base/SkFloatingPoint.h"
 #include "include/private/base/SkMacros.h"
+#include "include/private/base/SkTArray.h"
 #include "include/private/base/SkTo.h"
+#include "src/base/SkUtils.h"
+#include "src/base/SkVx.h"
 #include "src/core/SkGeometry.h"
 #include "src/core/SkPathEnums.h"
 #include "src/core/SkPathPriv.h"
@@ -25,6 +28,8 @@
 
 #include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <optional>
 
 enum {
@@ -125,6 +130,11 @@ static bool set_normal_unitnormal(const SkVector& vec,
     return true;
 }
 
+static bool same_point(const SkPoint& a, const SkPoint& b) {
+    // Compare bits, so that -0 and 0 are told apart, since they can make different normals.
+    return sk_bit_cast<uint64_t>(a) == sk_bit_cast<uint64_t>(b);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 struct SkQuadConstruct {    // The state of the quad stroke under construction.
@@ -193,8 +203,17 @@ public:
     bool hasOnlyMoveTo() const { return 0 == fSegmentCount; }
     SkPoint moveToPt() const { return fFirstPt; }
 
+    // A line of the source path, with the unit normal set_normal_unitnormal() would compute for
+    // it, or (0, 0) if it would fail.
+    struct LineNormal {
+        SkPoint  fStart;
+        SkPoint  fEnd;
+        SkVector fUnitNormal;
+    };
+
     void moveTo(const SkPoint&);
-    void lineTo(const SkPoint&, const SkPath::Iter* iter = nullptr);
+    void lineTo(const SkPoint&, const SkPath::Iter* iter = nullptr,
+                const LineNormal* lineNormal = nullptr);
     void quadTo(const SkPoint&, const SkPoint&);
     void conicTo(const SkPoint&, const SkPoint&, SkScalar weight);
     void cubicTo(const SkPoint&, const SkPoint&, const SkPoint&);
@@ -303,7 +322,7 @@ private:
 
     void    finishContour(bool close, bool isLine);
     bool    preJoinTo(const SkPoint&, SkVector* normal, SkVector* unitNormal,
-                      bool isLine);
+                      bool isLine, const SkVector* precomputedUnitNormal = nullptr);
     void    postJoinTo(const SkPoint&, const SkVector& normal,
                        const SkVector& unitNormal);
 
@@ -313,10 +332,19 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 bool SkPathStroker::preJoinTo(const SkPoint& currPt, SkVector* normal,
-                              SkVector* unitNormal, bool currIsLine) {
+                              SkVector* unitNormal, bool currIsLine,
+                              const SkVector* precomputedUnitNormal) {
     SkASSERT(fSegmentCount >= 0);
 
-    if (!set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal, unitNormal)) {
+    bool hasNormal;
+    if (precomputedUnitNormal) {
+        *unitNormal = *precomputedUnitNormal;
+        unitNormal->scale(fRadius, normal);
+        hasNormal = !unitNormal->isZero();
+    } else {
+        hasNormal = set_normal_unitnormal(fPrevPt, currPt, fResScale, fRadius, normal, unitNormal);
+    }
+    if (!hasNormal) {
         if (SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper) {
             return false;
         }
@@ -481,7 +509,8 @@ static bool has_valid_tangent(const SkPath::Iter* iter) {
     return false;
 }
 
-void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
+void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter,
+                           const LineNormal* lineNormal) {
     bool teenyLine = SkPointPriv::EqualsWithinTolerance(fPrevPt, currPt, SK_ScalarNearlyZero * fInvResScale);
     if (SkStrokerPriv::CapFactory(SkPaint::kButt_Cap) == fCapper && teenyLine) {
         return;
@@ -491,7 +520,11 @@ void SkPathStroker::lineTo(const SkPoint& currPt, const SkPath::Iter* iter) {
     }
     SkVector    normal, unitNormal;
 
-    if (!this->preJoinTo(currPt, &normal, &unitNormal, true)) {
+    // Skipped teeny lines can leave fPrevPt short of where this line starts.
+    const SkVector* precomputedUnitNormal =
+            lineNormal && same_point(lineNormal->fStart, fPrevPt) ? &lineNormal->fUnitNormal
+                                                                  : nullptr;
+    if (!this->preJoinTo(currPt, &normal, &unitNormal, true, precomputedUnitNormal)) {
         return;
     }
     this->line_to(currPt, normal);
@@ -1427,6 +1460,73 @@ void SkStroke::setJoin(SkPaint::Join join) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+// Computes the unit normals of the lines of a line-only path, including the lines that close its
+// contours, in the order SkPath::Iter visits them, four lines at a time. Each matches what
+// set_normal_unitnormal() computes for its line one at a time: the direction is normalized in
+// double precision, and rounded to float.
+static void compute_line_normals(const SkPath& src, SkScalar scale,
+                                 skia_private::TArray<SkPathStroker::LineNormal>* lineNormals) {
+    SkASSERT(src.getSegmentMasks() == SkPath::kLine_SegmentMask);
+
+    lineNormals->reserve_exact(src.countVerbs());
+    SkPoint moveTo = {0, 0}, lastPt = {0, 0};
+    for (auto [verb, pts, w] : SkPathPriv::Iterate(src)) {
+        switch (verb) {
+            case SkPathVerb::kMove:
+                moveTo = lastPt = pts[0];
+                break;
+            case SkPathVerb::kLine:
+                lineNormals->push_back({pts[0], pts[1], {0, 0}});
+                lastPt = pts[1];
+                break;
+            case SkPathVerb::kClose:
+                if (lastPt != moveTo) {
+                    lineNormals->push_back({lastPt, moveTo, {0, 0}});
+                }
+                lastPt = moveTo;
+                break;
+            default:
+                SkUNREACHABLE;
+        }
+    }
+
+    auto computeFour = [scale](SkPathStroker::LineNormal lines[4]) {
+        const skvx::float4 x0 = {lines[0].fStart.fX, lines[1].fStart.fX,
+                                 lines[2].fStart.fX, lines[3].fStart.fX},
+                           y0 = {lines[0].fStart.fY, lines[1].fStart.fY,
+                                 lines[2].fStart.fY, lines[3].fStart.fY},
+                           x1 = {lines[0].fEnd.fX, lines[1].fEnd.fX,
+                                 lines[2].fEnd.fX, lines[3].fEnd.fX},
+                           y1 = {lines[0].fEnd.fY, lines[1].fEnd.fY,
+                                 lines[2].fEnd.fY, lines[3].fEnd.fY};
+        const skvx::double4 dx = skvx::cast<double>((x1 - x0) * scale),
+                            dy = skvx::cast<double>((y1 - y0) * scale);
+        const skvx::double4 mag = skvx::map([](double d) { return std::sqrt(d); },
+                                            dx * dx + dy * dy);
+        const skvx::double4 invMag = 1.0 / mag;
+        const skvx::float4 ux = skvx::cast<float>(dx * invMag),
+                           uy = skvx::cast<float>(dy * invMag);
+        // Like SkPoint::setNormalize(), give up on non-finite and zero-length results.
+        const skvx::int4 valid = (ux * 0 == 0) & (uy * 0 == 0) & ((ux != 0) | (uy != 0));
+        for (int i = 0; i < 4; ++i) {
+            // Rotated CCW, like set_normal_unitnormal().
+            lines[i].fUnitNormal = valid[i] ? SkVector{uy[i], -ux[i]} : SkVector{0, 0};
+        }
+    };
+
+    const int count = lineNormals->size();
+    int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        computeFour(lineNormals->data() + i);
+    }
+    if (i < count) {
+        SkPathStroker::LineNormal tail[4] = {};
+        std::copy(lineNormals->data() + i, lineNormals->data() + count, tail);
+        computeFour(tail);
+        std::copy(tail, tail + (count - i), lineNormals->data() + i);
+    }
+}
+
 void SkStroke::strokePath(const SkPath& src, SkPathBuilder* dst) const {
     SkASSERT(dst);
 
@@ -1460,6 +1560,14 @@ void SkStroke::strokePath(const SkPath& src, SkPathBuilder* dst) const {
     SkPathStroker   stroker(src, radius, fMiterLimit, this->getCap(), this->getJoin(),
                             fResScale, ignoreCenter);
 
+    // The normals of line-only paths, which are most of what gets stroked, are computed ahead of
+    // time in batches. The lines are matched up with the iterator's as they are stroked.
+    skia_private::STArray<32, SkPathStroker::LineNormal> lineNormals;
+    if (src.getSegmentMasks() == SkPath::kLine_SegmentMask) {
+        compute_line_normals(src, fResScale, &lineNormals);
+    }
+    int lineIndex = 0;
+
     SkPath::Iter iter(src, false);
     SkPathVerb   lastSegment = SkPathVerb::kMove;
     while (auto rec = iter.next()) {
@@ -1468,10 +1576,16 @@ void SkStroke::strokePath(const SkPath& src, SkPathBuilder* dst) const {
             case SkPathVerb::kMove:
                 stroker.moveTo(pts[0]);
                 break;
-            case SkPathVerb::kLine:
-                stroker.lineTo(pts[1], &iter);
+            case SkPathVerb::kLine: {
+                const SkPathStroker::LineNormal* lineNormal = nullptr;
+                if (lineIndex < lineNormals.size() &&
+                    same_point(lineNormals[lineIndex].fStart, pts[0]) &&
+                    same_point(lineNormals[lineIndex].fEnd, pts[1])) {
+                    lineNormal = &lineNormals[lineIndex++];
+                }
+                stroker.lineTo(pts[1], &iter, lineNormal);
                 lastSegment = SkPathVerb::kLine;
-                break;
+            } break;
             case SkPathVerb::kQuad:
                 stroker.quadTo(pts[1], pts[2]);
                 lastSegment = SkPathVerb::kQuad;
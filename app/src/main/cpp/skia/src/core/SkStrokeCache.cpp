@@ -0,0 +1,138 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/core/SkStrokeCache.h"
+
+#include "include/core/SkFourByteTag.h"
+#include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkStrokeRec.h"
+#include "include/core/SkTypes.h"
+#include "include/private/SkIDChangeListener.h"
+#include "include/private/base/SkFloatingPoint.h"
+#include "src/core/SkPathPriv.h"
+#include "src/core/SkResourceCache.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#define CHECK_LOCAL(localCache, localName, globalName, ...) \
+    ((localCache) ? localCache->localName(__VA_ARGS__) : SkResourceCache::globalName(__VA_ARGS__))
+
+namespace {
+static unsigned gStrokeKeyNamespaceLabel;
+
+// Paths with at least this many verbs are cached the first time they are stroked.
+constexpr int kMinVerbsToCacheFirstStroke = 128;
+
+// The key hashes of recently seen strokes, to recognize strokes that are drawn more than once. A
+// collision only makes a stroke cached one draw sooner or later.
+constexpr int kSightingSlots = 512;
+std::atomic<uint32_t> gSightings[kSightingSlots];
+
+uint64_t make_shared_id(uint32_t pathGenID) {
+    uint64_t sharedID = SkSetFourByteTag('s', 't', 'r', 'k');
+    return (sharedID << 32) | pathGenID;
+}
+
+struct StrokeKey : public SkResourceCache::Key {
+public:
+    StrokeKey(const SkPath& src, const SkStrokeRec& rec)
+        : fGenID(src.getGenerationID())
+        , fParams(static_cast<uint32_t>(src.getFillType())     |
+                  static_cast<uint32_t>(rec.getStyle()) <<  8  |
+                  static_cast<uint32_t>(rec.getCap())   << 16  |
+                  static_cast<uint32_t>(rec.getJoin())  << 24)
+        , fWidth(rec.getWidth())
+        , fMiter(rec.getMiter())
+        , fResScale(rec.getResScale())
+    {
+        this->init(&gStrokeKeyNamespaceLabel, make_shared_id(fGenID),
+                   sizeof(fGenID) + sizeof(fParams) + sizeof(fWidth) + sizeof(fMiter) +
+                   sizeof(fResScale));
+    }
+
+    uint32_t   fGenID;
+    uint32_t   fParams;
+    SkScalar   fWidth;
+    SkScalar   fMiter;
+    SkScalar   fResScale;
+};
+
+// Purges a path's outlines when it is modified or deleted.
+class StrokeInvalidator : public SkIDChangeListener {
+public:
+    explicit StrokeInvalidator(uint64_t sharedID) : fSharedID(sharedID) {}
+
+private:
+    void changed() override { SkResourceCache::PostPurgeSharedID(fSharedID); }
+
+    uint64_t fSharedID;
+};
+
+struct StrokeRec : public SkResourceCache::Rec {
+    StrokeRec(const StrokeKey& key, const SkPath& outline, sk_sp<SkIDChangeListener> invalidator)
+        : fKey(key), fOutline(outline), fInvalidator(std::move(invalidator)) {}
+    ~StrokeRec() override {
+        // The path no longer needs to tell us when it changes.
+        fInvalidator->markShouldDeregister();
+    }
+
+    StrokeKey                  fKey;
+    SkPath                     fOutline;
+    sk_sp<SkIDChangeListener>  fInvalidator;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override { return sizeof(*this) + fOutline.approximateBytesUsed(); }
+    const char* getCategory() const override { return "stroke"; }
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const StrokeRec& rec = static_cast<const StrokeRec&>(baseRec);
+        SkPathBuilder* result = static_cast<SkPathBuilder*>(contextData);
+
+        *result = rec.fOutline;
+        return true;
+    }
+};
+} // namespace
+
+bool SkStrokeCache::CanCache(const SkPath& src, const SkStrokeRec& rec) {
+    const SkStrokeRec::Style style = rec.getStyle();
+    return (style == SkStrokeRec::kStroke_Style || style == SkStrokeRec::kStrokeAndFill_Style) &&
+           !src.isVolatile() && !src.isEmpty();
+}
+
+SkScalar SkStrokeCache::BucketResScale(SkScalar resScale) {
+    const SkScalar bucketed = std::exp2(std::ceil(std::log2(resScale) * 4) * 0.25f);
+    return SkIsFinite(bucketed) && bucketed >= resScale ? bucketed : resScale;
+}
+
+bool SkStrokeCache::ShouldCache(const SkPath& src, const SkStrokeRec& rec) {
+    if (src.countVerbs() >= kMinVerbsToCacheFirstStroke) {
+        return true;
+    }
+    const uint32_t hash = StrokeKey(src, rec).hash();
+    return gSightings[hash % kSightingSlots].exchange(hash, std::memory_order_relaxed) == hash;
+}
+
+bool SkStrokeCache::Find(const SkPath& src, const SkStrokeRec& rec, SkPathBuilder* dst,
+                         SkResourceCache* localCache) {
+    StrokeKey key(src, rec);
+    return CHECK_LOCAL(localCache, find, Find, key, StrokeRec::Visitor, dst);
+}
+
+void SkStrokeCache::Add(const SkPath& src, const SkStrokeRec& rec, const SkPath& outline,
+                        SkResourceCache* localCache) {
+    StrokeKey key(src, rec);
+    auto invalidator = sk_make_sp<StrokeInvalidator>(key.getSharedID());
+    SkPathPriv::AddGenIDChangeListener(src, invalidator);
+    return CHECK_LOCAL(localCache, add, Add, new StrokeRec(key, outline, std::move(invalidator)));
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkStrokeCache_DEFINED
+#define SkStrokeCache_DEFINED
+
+#include "include/core/SkScalar.h"
+
+class SkPath;
+class SkPathBuilder;
+class SkResourceCache;
+class SkStrokeRec;
+
+/**
+ *  Caches the outlines of stroked paths in the SkResourceCache, keyed by the path's generation ID,
+ *  the stroke parameters, and the resolution scale rounded up to a bucket. Entries are purged when
+ *  the path they were made from is modified or deleted.
+ *
+ *  Only strokes that are drawn more than once, or of paths with many verbs, are worth the slightly
+ *  finer bucketed outline and the cache entry. Other strokes should use their exact scale.
+ */
+class SkStrokeCache {
+public:
+    /**
+     *  Returns true if the stroke of src with rec should be cached. Only strokes of non-volatile
+     *  paths are cached, since volatile paths are not expected to be drawn again.
+     */
+    static bool CanCache(const SkPath& src, const SkStrokeRec& rec);
+
+    /**
+     *  Returns the resolution scale to stroke with, in place of resScale, so that the outline can
+     *  be shared by draws at nearby scales. It is resScale rounded up to the next quarter octave,
+     *  so the outline is never coarser than a stroke at resScale would be.
+     */
+    static SkScalar BucketResScale(SkScalar resScale);
+
+    /**
+     *  Returns true if the stroke of src with rec should be bucketed and cached: src has many
+     *  verbs, or the same stroke was seen recently. Otherwise records this sighting of it and
+     *  returns false. rec's resolution scale should already have been bucketed, so that draws at
+     *  nearby scales count as the same stroke.
+     */
+    static bool ShouldCache(const SkPath& src, const SkStrokeRec& rec);
+
+    /**
+     *  On success, set dst to the cached outline of src stroked with rec, and return true. rec's
+     *  resolution scale should already have been bucketed with BucketResScale().
+     */
+    static bool Find(const SkPath& src, const SkStrokeRec& rec, SkPathBuilder* dst,
+                     SkResourceCache* localCache = nullptr);
+
+    /**
+     *  Add the outline of src stroked with rec to the cache.
+     */
+    static void Add(const SkPath& src, const SkStrokeRec& rec, const SkPath& outline,
+                    SkResourceCache* localCache = nullptr);
+};
+
+#endif
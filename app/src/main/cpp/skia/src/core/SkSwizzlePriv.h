@@ -29,7 +29,22 @@ namespace SkOpts {
                            RGB_to_BGR1,     // i.e. swap RB and insert an opaque alpha
                            gray_to_RGB1,    // i.e. expand to color channels + an opaque alpha
                            grayA_to_RGBA,   // i.e. expand to color channels
-                           grayA_to_rgbA;   // i.e. expand to color channels and premultiply
+                           grayA_to_rgbA,   // i.e. expand to color channels and premultiply
+                           RGB16_to_RGB1,   // i.e. keep the high bytes and insert an opaque alpha
+                           RGB16_to_BGR1,   // i.e. keep the high bytes, swap RB and insert alpha
+                           RGBA16_to_RGBA,  // i.e. keep the high bytes
+                           RGBA16_to_BGRA;  // i.e. keep the high bytes and swap RB
+
+    // Swizzle input into 565, truncating each channel like SkPack888ToRGB16().
+    using Swizzle_565_u8 = void (*)(uint16_t*, const uint8_t*, int);
+    extern Swizzle_565_u8 RGB_to_565,
+                          BGR_to_565,
+                          RGB16_to_565,    // i.e. keep the high bytes
+                          gray_to_565;
+
+    // Look up 8-bit indices in a 256-entry color table.
+    using Swizzle_8888_index = void (*)(uint32_t*, const uint8_t*, int, const uint32_t*);
+    extern Swizzle_8888_index index_to_8888;
 
     void Init_Swizzler();
 }  // namespace SkOpts
@@ -7,7 +7,12 @@
 
 #include "include/encode/SkEncoder.h"
 
+#include "include/core/SkImageInfo.h"
 #include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTemplates.h"
+#include "src/base/SkSafeMath.h"
+
+#include <algorithm>
 
 bool SkEncoder::encodeRows(int numRows) {
     SkASSERT(numRows > 0 && fCurrRow < fSrc.height());
@@ -15,6 +20,11 @@ bool SkEncoder::encodeRows(int numRows) {
         return false;
     }
 
+    if (!fSrc.addr() && !fBand.addr()) {
+        // This encoder was made for bands, and must be fed with encodeBand().
+        return false;
+    }
+
     if (fCurrRow + numRows > fSrc.height()) {
         numRows = fSrc.height() - fCurrRow;
     }
@@ -27,3 +37,50 @@ bool SkEncoder::encodeRows(int numRows) {
 
     return true;
 }
+
+bool SkEncoder::encodeBand(const SkPixmap& band) {
+    if (!band.addr() || band.height() <= 0 || fCurrRow + band.height() > fSrc.height() ||
+        band.width() != fSrc.width() || band.colorType() != fSrc.colorType() ||
+        band.alphaType() != fSrc.alphaType() || band.rowBytes() < band.info().minRowBytes()) {
+        return false;
+    }
+
+    fBand = band;
+    fBandTop = fCurrRow;
+    bool result = this->encodeRows(band.height());
+    fBand.reset();
+    return result;
+}
+
+bool SkEncoder::encodeBands(int bandHeight, const BandProducer& produceBand) {
+    if (bandHeight <= 0 || fCurrRow >= fSrc.height()) {
+        return false;
+    }
+    bandHeight = std::min(bandHeight, fSrc.height() - fCurrRow);
+
+    SkImageInfo bandInfo = fSrc.info().makeDimensions({fSrc.width(), bandHeight});
+    const size_t rowBytes = bandInfo.minRowBytes();
+    SkSafeMath safe;
+    const size_t bandBytes = safe.mul(rowBytes, bandHeight);
+    if (!safe.ok()) {
+        return false;
+    }
+    skia_private::AutoTMalloc<uint8_t> storage(bandBytes);
+
+    while (fCurrRow < fSrc.height()) {
+        const int height = std::min(bandHeight, fSrc.height() - fCurrRow);
+        SkPixmap band(bandInfo.makeDimensions({fSrc.width(), height}), storage.get(), rowBytes);
+        if (!produceBand(fCurrRow, band) || !this->encodeBand(band)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const void* SkEncoder::srcRow(int y) const {
+    if (fBand.addr()) {
+        SkASSERT(y >= fBandTop && y < fBandTop + fBand.height());
+        return fBand.addr(0, y - fBandTop);
+    }
+    return fSrc.addr(0, y);
+}
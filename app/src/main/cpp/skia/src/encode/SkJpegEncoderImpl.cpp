@@ -323,7 +323,9 @@ std::unique_ptr<SkEncoder> SkJpegEncoderImpl::MakeRGB(
         const SkPixmap& src,
         const SkJpegEncoder::Options& options,
         const SkJpegMetadataEncoder::SegmentList& metadataSegments) {
-    if (!SkPixmapIsValid(src)) {
+    // Encoders for bands are made with a pixmap that has no pixels.
+    if (!SkImageInfoIsValid(src.info()) ||
+        (src.addr() && src.rowBytes() < src.info().minRowBytes())) {
         return nullptr;
     }
     std::unique_ptr<SkJpegEncoderMgr> encoderMgr = SkJpegEncoderMgr::Make(dst);
@@ -368,8 +370,8 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
     } else {
         const size_t srcBytes = SkColorTypeBytesPerPixel(fSrc.colorType()) * fSrc.width();
         const size_t jpegSrcBytes = fEncoderMgr->cinfo()->input_components * fSrc.width();
-        const void* srcRow = fSrc.addr(0, fCurrRow);
         for (int i = 0; i < numRows; i++) {
+            const void* srcRow = this->srcRow(fCurrRow + i);
             JSAMPLE* jpegSrcRow = (JSAMPLE*)(const_cast<void*>(srcRow));
             if (fEncoderMgr->shouldUseColorXform()) {
                 sk_msan_assert_initialized(srcRow, SkTAddOffset<const void>(srcRow, srcBytes));
@@ -387,7 +389,6 @@ bool SkJpegEncoderImpl::onEncodeRows(int numRows) {
             }
 
             jpeg_write_scanlines(fEncoderMgr->cinfo(), &jpegSrcRow, 1);
-            srcRow = SkTAddOffset<const void>(srcRow, fSrc.rowBytes());
         }
     }
 
@@ -429,7 +430,9 @@ sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& op
     return nullptr;
 }
 
-std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+static std::unique_ptr<SkEncoder> make_rgb(SkWStream* dst,
+                                           const SkPixmap& src,
+                                           const Options& options) {
     SkJpegMetadataEncoder::SegmentList metadataSegments;
     SkJpegMetadataEncoder::AppendXMPStandard(metadataSegments, options.xmpMetadata);
     SkJpegMetadataEncoder::AppendICC(metadataSegments, options, src.colorSpace());
@@ -439,6 +442,19 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
     return SkJpegEncoderImpl::MakeRGB(dst, src, options, metadataSegments);
 }
 
+std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (!SkPixmapIsValid(src)) {
+        return nullptr;
+    }
+    return make_rgb(dst, src, options);
+}
+
+std::unique_ptr<SkEncoder> MakeForBands(SkWStream* dst,
+                                        const SkImageInfo& info,
+                                        const Options& options) {
+    return make_rgb(dst, SkPixmap(info, nullptr, info.minRowBytes()), options);
+}
+
 std::unique_ptr<SkEncoder> Make(SkWStream* dst,
                                 const SkYUVAPixmaps& src,
                                 const SkColorSpace* srcColorSpace,
@@ -166,6 +166,29 @@ SkPngEncoderBase::SkPngEncoderBase(TargetInfo targetInfo, const SkPixmap& src)
              || (fTargetInfo.fSrcRowInfo && fTargetInfo.fDstRowInfo));
 }
 
+bool SkPngEncoderBase::convertRow(int y, uint8_t* dst) const {
+    const void* srcRow = this->srcRow(y);
+    sk_msan_assert_initialized(srcRow,
+                               (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
+
+    if (fSrc.colorType() == kAlpha_8_SkColorType) {
+        // This is a special case where we store kAlpha_8 images as GrayAlpha in png.
+        transform_scanline_A8_to_GrayAlpha((char*)dst,
+                                           (const char*)srcRow,
+                                           fSrc.width(),
+                                           SkColorTypeBytesPerPixel(fSrc.colorType()));
+        return true;
+    }
+
+    SkASSERT(fSrc.width() == fTargetInfo.fSrcRowInfo->width());
+    return SkConvertPixels(fTargetInfo.fDstRowInfo.value(),
+                           (void*)dst,
+                           fTargetInfo.fDstRowSize,
+                           fTargetInfo.fSrcRowInfo.value(),
+                           srcRow,
+                           fTargetInfo.fSrcRowInfo->minRowBytes());
+}
+
 bool SkPngEncoderBase::onEncodeRows(int numRows) {
     // https://www.w3.org/TR/png-3/#11IHDR says that "zero is an invalid value"
     // for width and height.
@@ -182,26 +205,8 @@ bool SkPngEncoderBase::onEncodeRows(int numRows) {
             return false;
         }
 
-        const void* srcRow = fSrc.addr(0, fCurrRow);
-        sk_msan_assert_initialized(srcRow,
-                                   (const uint8_t*)srcRow + (fSrc.width() << fSrc.shiftPerPixel()));
-
-        if (fSrc.colorType() == kAlpha_8_SkColorType) {
-            // This is a special case where we store kAlpha_8 images as GrayAlpha in png.
-            transform_scanline_A8_to_GrayAlpha((char*)fStorage.get(),
-                                               (const char*)srcRow,
-                                               fSrc.width(),
-                                               SkColorTypeBytesPerPixel(fSrc.colorType()));
-        } else {
-            SkASSERT(fSrc.width() == fTargetInfo.fSrcRowInfo->width());
-            if (!SkConvertPixels(fTargetInfo.fDstRowInfo.value(),
-                                 (void*)fStorage.get(),
-                                 fTargetInfo.fDstRowSize,
-                                 fTargetInfo.fSrcRowInfo.value(),
-                                 srcRow,
-                                 fTargetInfo.fSrcRowInfo->minRowBytes())) {
-                return false;
-            }
+        if (!this->convertRow(fCurrRow, fStorage.get())) {
+            return false;
         }
 
         SkSpan<const uint8_t> rowToEncode(fStorage.get(), fTargetInfo.fDstRowSize);
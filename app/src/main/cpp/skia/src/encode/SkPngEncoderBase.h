@@ -57,6 +57,10 @@ protected:
 
     const TargetInfo& targetInfo() const { return fTargetInfo; }
 
+    // Converts row |y| of the source into |dst|, which must hold `fDstRowSize` bytes.
+    // This does not touch any encoder state, so it is safe to call from several threads.
+    bool convertRow(int y, uint8_t* dst) const;
+
 private:
     TargetInfo fTargetInfo;
     bool fFinishedEncoding = false;
@@ -14,6 +14,7 @@
 #include "include/core/SkColorType.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDataTable.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkPixmap.h"
 #include "include/core/SkRefCnt.h"
@@ -31,7 +32,9 @@
 #include "src/codec/SkPngPriv.h"
 #include "src/encode/SkImageEncoderFns.h"
 #include "src/encode/SkImageEncoderPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/encode/SkPngEncoderBase.h"
+#include "src/encode/SkZlibChunks.h"
 #include "src/image/SkImage_Base.h"
 
 #include <algorithm>
@@ -45,6 +48,7 @@
 
 #include <png.h>
 #include <pngconf.h>
+#include <zlib.h>
 
 class GrDirectContext;
 class SkImage;
@@ -440,12 +444,305 @@ bool SkPngEncoderImpl::onFinishEncoding() {
     return true;
 }
 
-namespace SkPngEncoder {
-std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    if (!SkPixmapIsValid(src)) {
-        return nullptr;
+////////////////////////////////////////////////////////////////////////////////////////////////////
+// Parallel encoding
+//
+// The image is split into bands of rows. Each band is converted, filtered and deflated on its
+// own as an SkZlibChunks::Chunk, primed with the last 32KB of the previous band's filtered data.
+
+namespace {
+
+// Roughly how much filtered data each band holds. Smaller bands give more parallelism, but
+// each one costs a sync flush and recomputes the rows used for its dictionary.
+constexpr size_t kBandBytes = 256 * 1024;
+
+constexpr int kFilterTypes[] = {
+        PNG_FILTER_VALUE_NONE, PNG_FILTER_VALUE_SUB, PNG_FILTER_VALUE_UP,
+        PNG_FILTER_VALUE_AVG, PNG_FILTER_VALUE_PAETH,
+};
+constexpr int kFilterFlags[] = {
+        PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVG, PNG_FILTER_PAETH,
+};
+
+struct PngRowLayout {
+    int    fWidth;
+    size_t fSrcBytesPerPixel;  // Of the rows produced by SkPngEncoderBase::convertRow().
+    size_t fBytesPerPixel;     // Of the rows written to the png, rounded up to a byte.
+    size_t fBytesPerSample;
+
+    size_t rowBytes() const { return fWidth * fBytesPerPixel; }
+    // Each filtered row starts with its filter type.
+    size_t filteredRowBytes() const { return this->rowBytes() + 1; }
+};
+
+// Applies the transforms that libpng applies to rows written by SkPngEncoderImpl::onEncodeRow:
+// png_set_filler() drops the last channel of opaque RGBA rows and png_set_swap() makes 16-bit
+// samples big endian.
+void to_png_row(const PngRowLayout& layout, const uint8_t* src, uint8_t* dst) {
+    for (int x = 0; x < layout.fWidth; ++x) {
+        if (layout.fBytesPerSample == 2) {
+            for (size_t i = 0; i < layout.fBytesPerPixel; i += 2) {
+                dst[i] = src[i + 1];
+                dst[i + 1] = src[i];
+            }
+        } else {
+            memcpy(dst, src, layout.fBytesPerPixel);
+        }
+        src += layout.fSrcBytesPerPixel;
+        dst += layout.fBytesPerPixel;
+    }
+}
+
+int paeth_predictor(int a, int b, int c) {
+    int p = a + b - c;
+    int pa = std::abs(p - a);
+    int pb = std::abs(p - b);
+    int pc = std::abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+// Writes |row| filtered with |filterType| into |dst|, and returns the sum of the absolute values
+// of the filtered bytes (as signed bytes), which is libpng's measure of how well a row will
+// compress. Stops early and returns a value larger than |limit| once the sum exceeds it.
+uint64_t filter_row(int filterType, const uint8_t* row, const uint8_t* prev, size_t rowBytes,
+                    size_t bpp, uint8_t* dst, uint64_t limit) {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < rowBytes; ++i) {
+        const int left = i >= bpp ? row[i - bpp] : 0;
+        const int up = prev[i];
+        const int upLeft = i >= bpp ? prev[i - bpp] : 0;
+        int predicted;
+        switch (filterType) {
+            case PNG_FILTER_VALUE_SUB:   predicted = left;                              break;
+            case PNG_FILTER_VALUE_UP:    predicted = up;                                break;
+            case PNG_FILTER_VALUE_AVG:   predicted = (left + up) >> 1;                  break;
+            case PNG_FILTER_VALUE_PAETH: predicted = paeth_predictor(left, up, upLeft); break;
+            default:                     predicted = 0;                                 break;
+        }
+        const uint8_t v = static_cast<uint8_t>(row[i] - predicted);
+        dst[i] = v;
+        sum += v < 128 ? v : 256 - v;
+        // Checking every byte would slow down the common case, checking once per pixel is
+        // enough to avoid most of the work on losing filters.
+        if (sum > limit && (i % bpp) == 0) {
+            return sum;
+        }
+    }
+    return sum;
+}
+
+// Filters |row| into |dst| (filter type byte first) with the cheapest of the allowed |filters|.
+// The choice only depends on the row and the row above it, never on earlier choices, so every
+// band makes the same choice for rows it recomputes to prime its dictionary.
+//
+// |hint| is the filter that won the previous row. It is tried first because neighboring rows
+// usually prefer the same filter, which lets filter_row() bail out early on the others.
+int filter_row_adaptive(int filters, int hint, const uint8_t* row, const uint8_t* prev,
+                        size_t rowBytes, size_t bpp, uint8_t* dst, uint8_t* scratch) {
+    int best = -1;
+    uint64_t bestSum = UINT64_MAX;
+    auto consider = [&](int index) {
+        if (!(filters & kFilterFlags[index])) {
+            return;
+        }
+        uint8_t* out = best < 0 ? dst + 1 : scratch;
+        uint64_t sum = filter_row(kFilterTypes[index], row, prev, rowBytes, bpp, out, bestSum);
+        // Break ties in favor of the lower filter type, regardless of the order they were
+        // tried in.
+        if (sum < bestSum || (sum == bestSum && index < best)) {
+            if (out == scratch) {
+                memcpy(dst + 1, scratch, rowBytes);
+            }
+            best = index;
+            bestSum = sum;
+        }
+    };
+    if (hint >= 0) {
+        consider(hint);
+    }
+    for (int i = 0; i < (int)std::size(kFilterTypes); ++i) {
+        if (i != hint) {
+            consider(i);
+        }
+    }
+    SkASSERT(best >= 0);
+    dst[0] = static_cast<uint8_t>(kFilterTypes[best]);
+    return best;
+}
+
+int zlib_strategy(int filters) {
+    // Matches libpng's default IDAT strategy.
+    return filters == PNG_FILTER_NONE ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+}
+
+struct PngBand {
+    int                 fFirstRow;
+    int                 fRowCount;
+    SkZlibChunks::Chunk fChunk;
+    bool                fSuccess = false;
+};
+
+// Returns true if png_write_end() would write anything besides IEND. The parallel encoder writes
+// its own IDAT chunks, which libpng does not track, so png_write_end() refuses to run after them
+// and the file has to be ended without it.
+bool has_chunks_after_idat(png_const_structrp pngPtr, png_inforp infoPtr) {
+    if (png_get_valid(pngPtr, infoPtr, PNG_INFO_tIME | PNG_INFO_eXIf)) {
+        return true;
+    }
+    png_textp texts;
+    int textCount = 0;
+    png_get_text(pngPtr, infoPtr, &texts, &textCount);
+    for (int i = 0; i < textCount; ++i) {
+        // png_write_info() marks the text chunks it has written.
+        if (texts[i].compression != PNG_TEXT_COMPRESSION_NONE_WR &&
+            texts[i].compression != PNG_TEXT_COMPRESSION_zTXt_WR) {
+            return true;
+        }
+    }
+    png_unknown_chunkp chunks;
+    const int chunkCount = png_get_unknown_chunks(pngPtr, infoPtr, &chunks);
+    for (int i = 0; i < chunkCount; ++i) {
+        if (chunks[i].location & PNG_AFTER_IDAT) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+bool SkPngEncoderImpl::canEncodeInParallel() const {
+    const size_t filteredRowBytes = this->targetInfo().fDstRowSize + 1;
+    const size_t rowsPerBand = std::max<size_t>(1, kBandBytes / filteredRowBytes);
+    return fCurrRow == 0 && (size_t)fSrc.height() > rowsPerBand &&
+           !has_chunks_after_idat(fEncoderMgr->pngPtr(), fEncoderMgr->infoPtr());
+}
+
+bool SkPngEncoderImpl::encodeInParallel(SkExecutor& executor, int filters, int zlibLevel) {
+    SkASSERT(this->canEncodeInParallel());
+    png_structp pngPtr = fEncoderMgr->pngPtr();
+    png_infop infoPtr = fEncoderMgr->infoPtr();
+
+    PngRowLayout layout;
+    layout.fWidth = fSrc.width();
+    layout.fSrcBytesPerPixel = this->targetInfo().fDstRowSize / fSrc.width();
+    layout.fBytesPerSample = png_get_bit_depth(pngPtr, infoPtr) == 16 ? 2 : 1;
+    layout.fBytesPerPixel = png_get_channels(pngPtr, infoPtr) * layout.fBytesPerSample;
+    // Either the rows are written as is, or the filler channel is dropped.
+    SkASSERT(layout.fBytesPerPixel == layout.fSrcBytesPerPixel ||
+             layout.fBytesPerPixel + layout.fBytesPerSample == layout.fSrcBytesPerPixel);
+    SkASSERT(png_get_rowbytes(pngPtr, infoPtr) == layout.rowBytes());
+
+    const size_t rowBytes = layout.rowBytes();
+    const size_t filteredRowBytes = layout.filteredRowBytes();
+    const int rowsPerBand = (int)std::max<size_t>(1, kBandBytes / filteredRowBytes);
+    // The number of rows before a band that have to be filtered again to rebuild the dictionary.
+    const int dictionaryRows =
+            (int)((SkZlibChunks::kWindowSize + filteredRowBytes - 1) / filteredRowBytes);
+    const int height = fSrc.height();
+    const int strategy = zlib_strategy(filters);
+
+    std::vector<PngBand> bands;
+    for (int y = 0; y < height; y += rowsPerBand) {
+        bands.push_back({y, std::min(rowsPerBand, height - y)});
     }
 
+    auto encodeBand = [&](int index) {
+        PngBand& band = bands[index];
+        const int firstRow = std::max(0, band.fFirstRow - dictionaryRows);
+        const int rowCount = band.fFirstRow + band.fRowCount - firstRow;
+
+        std::vector<uint8_t> filtered(rowCount * filteredRowBytes);
+        // Converted source row, the current and previous png rows, and filter scratch space.
+        std::vector<uint8_t> rows(this->targetInfo().fDstRowSize + 3 * rowBytes);
+        uint8_t* converted = rows.data();
+        uint8_t* curr = converted + this->targetInfo().fDstRowSize;
+        uint8_t* prev = curr + rowBytes;
+        uint8_t* scratch = prev + rowBytes;
+
+        // The first row of the image is filtered against a row of zeros.
+        if (firstRow > 0) {
+            if (!this->convertRow(firstRow - 1, converted)) {
+                return;
+            }
+            to_png_row(layout, converted, prev);
+        } else {
+            memset(prev, 0, rowBytes);
+        }
+
+        int hint = -1;
+        for (int i = 0; i < rowCount; ++i) {
+            if (!this->convertRow(firstRow + i, converted)) {
+                return;
+            }
+            to_png_row(layout, converted, curr);
+            hint = filter_row_adaptive(filters, hint, curr, prev, rowBytes,
+                                       layout.fBytesPerPixel, &filtered[i * filteredRowBytes],
+                                       scratch);
+            std::swap(curr, prev);
+        }
+
+        const size_t dictionarySize = (band.fFirstRow - firstRow) * filteredRowBytes;
+        const uint8_t* data = filtered.data() + dictionarySize;
+        const size_t size = filtered.size() - dictionarySize;
+        const bool isLast = index + 1 == (int)bands.size();
+        band.fSuccess = SkZlibChunks::Deflate(data, size, filtered.data(), dictionarySize,
+                                              zlibLevel, strategy, isLast, &band.fChunk);
+    };
+
+    {
+        SkTaskGroup taskGroup(executor);
+        taskGroup.batch((int)bands.size(), encodeBand);
+        taskGroup.wait();
+    }
+
+    // No more rows can be encoded, whether this succeeds or not.
+    fCurrRow = height;
+
+    std::vector<SkZlibChunks::Chunk> chunks;
+    for (PngBand& band : bands) {
+        if (!band.fSuccess) {
+            return false;
+        }
+        chunks.push_back(std::move(band.fChunk));
+    }
+    const auto zlibHeader = SkZlibChunks::Header(zlibLevel);
+    const auto zlibTrailer = SkZlibChunks::Trailer(chunks);
+
+    if (setjmp(png_jmpbuf(pngPtr))) {
+        return false;
+    }
+
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const std::vector<uint8_t>& deflated = chunks[i].fDeflated;
+        const bool isFirst = i == 0;
+        const bool isLast = i + 1 == chunks.size();
+        const size_t length = deflated.size() + (isFirst ? zlibHeader.size() : 0) +
+                              (isLast ? zlibTrailer.size() : 0);
+        png_write_chunk_start(pngPtr, (png_const_bytep)"IDAT", length);
+        if (isFirst) {
+            png_write_chunk_data(pngPtr, zlibHeader.data(), zlibHeader.size());
+        }
+        png_write_chunk_data(pngPtr, deflated.data(), deflated.size());
+        if (isLast) {
+            png_write_chunk_data(pngPtr, zlibTrailer.data(), zlibTrailer.size());
+        }
+        png_write_chunk_end(pngPtr);
+    }
+
+    // canEncodeInParallel() checked that png_write_end() would have written nothing but IEND.
+    SkASSERT(!has_chunks_after_idat(pngPtr, infoPtr));
+    png_write_chunk(pngPtr, (png_const_bytep)"IEND", nullptr, 0);
+    return true;
+}
+
+namespace SkPngEncoder {
+static std::unique_ptr<SkPngEncoderImpl> make_encoder(SkWStream* dst,
+                                                      const SkPixmap& src,
+                                                      const Options& options) {
     std::unique_ptr<SkPngEncoderMgr> encoderMgr = SkPngEncoderMgr::Make(dst);
     if (!encoderMgr) {
         return nullptr;
@@ -475,9 +772,35 @@ std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Optio
     return std::make_unique<SkPngEncoderImpl>(std::move(*targetInfo), std::move(encoderMgr), src);
 }
 
+std::unique_ptr<SkEncoder> Make(SkWStream* dst, const SkPixmap& src, const Options& options) {
+    if (!SkPixmapIsValid(src)) {
+        return nullptr;
+    }
+    return make_encoder(dst, src, options);
+}
+
+std::unique_ptr<SkEncoder> MakeForBands(SkWStream* dst,
+                                        const SkImageInfo& info,
+                                        const Options& options) {
+    if (!SkImageInfoIsValid(info)) {
+        return nullptr;
+    }
+    return make_encoder(dst, SkPixmap(info, nullptr, info.minRowBytes()), options);
+}
+
 bool Encode(SkWStream* dst, const SkPixmap& src, const Options& options) {
-    auto encoder = Make(dst, src, options);
-    return encoder.get() && encoder->encodeRows(src.height());
+    if (!SkPixmapIsValid(src)) {
+        return false;
+    }
+    auto encoder = make_encoder(dst, src, options);
+    if (!encoder) {
+        return false;
+    }
+    if (options.fExecutor && encoder->canEncodeInParallel()) {
+        return encoder->encodeInParallel(*options.fExecutor, (int)options.fFilterFlags,
+                                         std::min(std::max(0, options.fZLibLevel), 9));
+    }
+    return encoder->encodeRows(src.height());
 }
 
 sk_sp<SkData> Encode(GrDirectContext* ctx, const SkImage* img, const Options& options) {
@@ -14,6 +14,7 @@
 
 #include <memory>
 
+class SkExecutor;
 class SkPixmap;
 class SkPngEncoderMgr;
 template <typename T> class SkSpan;
@@ -25,6 +26,14 @@ public:
     SkPngEncoderImpl(TargetInfo targetInfo, std::unique_ptr<SkPngEncoderMgr>, const SkPixmap& src);
     ~SkPngEncoderImpl() override;
 
+    // Returns true if the image is large enough to be split into several bands of rows.
+    bool canEncodeInParallel() const;
+
+    // Encodes the whole image, filtering and compressing bands of rows concurrently on
+    // |executor|, then writes them as a single IDAT stream followed by IEND. Must be called
+    // before any rows have been encoded, and only if canEncodeInParallel() is true.
+    bool encodeInParallel(SkExecutor& executor, int filters, int zlibLevel);
+
 protected:
     bool onEncodeRow(SkSpan<const uint8_t> row) override;
     bool onFinishEncoding() override;
@@ -0,0 +1,96 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/encode/SkZlibChunks.h"
+
+#include "include/private/base/SkAssert.h"
+
+#include "zlib.h"  // NO_G3_REWRITE
+
+namespace SkZlibChunks {
+
+bool Deflate(const uint8_t* data,
+             size_t size,
+             const uint8_t* dictionary,
+             size_t dictionarySize,
+             int compressionLevel,
+             int strategy,
+             bool isLast,
+             Chunk* chunk) {
+    SkASSERT(chunk);
+    z_stream stream = {};
+    // Raw deflate; the zlib header and checksum are written around all of the chunks.
+    if (Z_OK != deflateInit2(&stream, compressionLevel, Z_DEFLATED, -MAX_WBITS, 8, strategy)) {
+        return false;
+    }
+    if (dictionarySize > kWindowSize) {
+        dictionary += dictionarySize - kWindowSize;
+        dictionarySize = kWindowSize;
+    }
+    if (dictionarySize > 0 &&
+        Z_OK != deflateSetDictionary(&stream, dictionary, (uInt)dictionarySize)) {
+        deflateEnd(&stream);
+        return false;
+    }
+
+    std::vector<uint8_t>* out = &chunk->fDeflated;
+    // Leave room for the sync flush marker.
+    out->resize(deflateBound(&stream, size) + 16);
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = (uInt)size;
+    stream.next_out = out->data();
+    stream.avail_out = (uInt)out->size();
+
+    const int flush = isLast ? Z_FINISH : Z_SYNC_FLUSH;
+    bool done = false;
+    while (!done) {
+        if (stream.avail_out == 0) {
+            size_t used = out->size();
+            out->resize(used * 2);
+            stream.next_out = out->data() + used;
+            stream.avail_out = (uInt)(out->size() - used);
+        }
+        int result = deflate(&stream, flush);
+        if (result == Z_STREAM_ERROR) {
+            deflateEnd(&stream);
+            return false;
+        }
+        done = isLast ? result == Z_STREAM_END : stream.avail_out != 0;
+    }
+    out->resize(stream.total_out);
+    deflateEnd(&stream);
+
+    chunk->fAdler = (uint32_t)adler32(adler32(0, nullptr, 0), data, (uInt)size);
+    chunk->fSize = size;
+    return true;
+}
+
+std::array<uint8_t, 2> Header(int compressionLevel) {
+    if (compressionLevel == Z_DEFAULT_COMPRESSION) {
+        compressionLevel = 6;
+    }
+    // CMF: deflate with a 32K window. FLG: the FLEVEL hint, with FCHECK making the header a
+    // multiple of 31.
+    const int flevel = compressionLevel < 2  ? 0
+                     : compressionLevel < 6  ? 1
+                     : compressionLevel == 6 ? 2
+                                             : 3;
+    std::array<uint8_t, 2> header = {0x78, (uint8_t)(flevel << 6)};
+    header[1] += 31 - ((header[0] << 8) | header[1]) % 31;
+    return header;
+}
+
+std::array<uint8_t, 4> Trailer(SkSpan<const Chunk> chunks) {
+    uLong adler = adler32(0, nullptr, 0);
+    for (const Chunk& chunk : chunks) {
+        adler = adler32_combine(adler, chunk.fAdler, (z_off_t)chunk.fSize);
+    }
+    return {(uint8_t)(adler >> 24), (uint8_t)(adler >> 16), (uint8_t)(adler >> 8),
+            (uint8_t)adler};
+}
+
+}  // namespace SkZlibChunks
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkZlibChunks_DEFINED
+#define SkZlibChunks_DEFINED
+
+#include "include/core/SkSpan.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Helpers for building a zlib stream (RFC 1950) out of chunks that are deflated independently,
+ * possibly on several threads. Each chunk is raw deflate data that ends with a sync flush (the
+ * last chunk ends the stream instead), so the chunks can simply be concatenated between
+ * Header() and Trailer(). Like pigz, each chunk can be primed with the data before it, so
+ * matches can still reach back across chunk boundaries.
+ */
+namespace SkZlibChunks {
+
+/** The size of the deflate window, and so the useful size of a dictionary. */
+inline constexpr size_t kWindowSize = 32 * 1024;
+
+struct Chunk {
+    std::vector<uint8_t> fDeflated;
+    uint32_t             fAdler = 1;
+    size_t               fSize = 0;
+};
+
+/** Deflates size bytes of data into chunk, primed with the last kWindowSize bytes (at most) of
+    dictionary. compressionLevel and strategy are as for zlib's deflateInit2(). May be called
+    from several threads at once. Returns false if zlib fails.
+ */
+bool Deflate(const uint8_t* data,
+             size_t size,
+             const uint8_t* dictionary,
+             size_t dictionarySize,
+             int compressionLevel,
+             int strategy,
+             bool isLast,
+             Chunk* chunk);
+
+/** The two byte zlib header, with the level hint that zlib itself would write. */
+std::array<uint8_t, 2> Header(int compressionLevel);
+
+/** The checksum of all of the chunks' data, in the order they are written. */
+std::array<uint8_t, 4> Trailer(SkSpan<const Chunk> chunks);
+
+}  // namespace SkZlibChunks
+
+#endif  // SkZlibChunks_DEFINED
@@ -352,6 +352,10 @@ void GrDirectContext::purgeUnlockedResources(GrPurgeResourceOptions opts) {
     fResourceCache->purgeUnlockedResources(opts);
     fResourceCache->purgeAsNeeded();
 
+    if (opts == GrPurgeResourceOptions::kAllResources) {
+        this->drawingManager()->purgePathRendererCaches();
+    }
+
     // The textBlob Cache doesn't actually hold any GPU resource but this is a convenient
     // place to purge stale blobs
     this->getTextBlobRedrawCoordinator()->purgeStaleBlobs();
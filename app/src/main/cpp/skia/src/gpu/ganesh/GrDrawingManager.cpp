@@ -94,6 +94,12 @@ void GrDrawingManager::freeGpuResources() {
     fSoftwarePathRenderer = nullptr;
 }
 
+void GrDrawingManager::purgePathRendererCaches() {
+    if (fPathRendererChain) {
+        fPathRendererChain->purgeCaches();
+    }
+}
+
 // MDB TODO: make use of the 'proxies' parameter.
 bool GrDrawingManager::flush(SkSpan<GrSurfaceProxy*> proxies,
                              SkSurfaces::BackendSurfaceAccess access,
@@ -68,6 +68,9 @@ public:
 
     void freeGpuResources();
 
+    // Drops the data that path renderers keep between draws, without destroying them.
+    void purgePathRendererCaches();
+
     // OpsTasks created at flush time are stored and handled different from the others.
     sk_sp<skgpu::ganesh::OpsTask> newOpsTask(GrSurfaceProxyView, sk_sp<GrArenas> arenas);
 
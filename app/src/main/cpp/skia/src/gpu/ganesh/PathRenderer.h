@@ -48,6 +48,12 @@ public:
 
     virtual const char* name() const = 0;
 
+    /**
+     * Drops any data that the renderer keeps between draws to speed up later ones. Called when
+     * the context purges its unlocked resources.
+     */
+    virtual void purgeCaches() {}
+
     /**
      * A caller may wish to use a path renderer to draw a path into the stencil buffer. However,
      * the path renderer itself may require use of the stencil buffer. Also a path renderer may
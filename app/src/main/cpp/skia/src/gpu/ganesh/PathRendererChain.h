@@ -64,6 +64,13 @@ public:
         return fTessellationPathRenderer;
     }
 
+    /** Calls purgeCaches() on every path renderer in the chain. */
+    void purgeCaches() {
+        for (const sk_sp<PathRenderer>& pathRenderer : fChain) {
+            pathRenderer->purgeCaches();
+        }
+    }
+
 private:
     static constexpr size_t kPreAllocCount = 8;
 
@@ -0,0 +1,391 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/gpu/ganesh/geometry/GrTriangulationCache.h"
+
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+
+#include "include/core/SkPath.h"
+#include "include/core/SkPathBuilder.h"
+#include "include/core/SkRect.h"
+#include "include/private/base/SkAssert.h"
+#include "include/private/base/SkTo.h"
+#include "src/base/SkArenaAlloc.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkTraceEvent.h"
+#include "src/gpu/BufferWriter.h"
+#include "src/gpu/ganesh/GrEagerVertexAllocator.h"
+#include "src/gpu/ganesh/geometry/GrTriangulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <utility>
+
+namespace {
+
+// Band boundaries must be exactly representable, so band indices stay well within a float's
+// mantissa.
+constexpr double kMaxBandIndex = 1 << 23;
+
+// Linearizes a path's contours exactly like GrTriangulator does before building its mesh.
+class Linearizer : private GrTriangulator {
+public:
+    static void Linearize(const SkPath& path, SkScalar tolerance, std::vector<SkPoint>* points,
+                          std::vector<uint32_t>* contourEnds, bool* isLinear) {
+        SkArenaAlloc alloc(kArenaDefaultChunkSize);
+        Linearizer linearizer(path, &alloc);
+
+        int contourCount = 0;
+        SkPath::Iter iter(path, false);
+        while (auto rec = iter.next()) {
+            contourCount += rec->fVerb == SkPathVerb::kMove;
+        }
+        std::unique_ptr<VertexList[]> contours(new VertexList[std::max(contourCount, 1)]);
+        linearizer.pathToContours(tolerance, SkRect::MakeEmpty(), contours.get(), isLinear);
+
+        for (int i = 0; i < contourCount; ++i) {
+            for (Vertex* v = contours[i].fHead; v; v = v->fNext) {
+                points->push_back(v->fPoint);
+            }
+            contourEnds->push_back(SkToU32(points->size()));
+        }
+    }
+
+private:
+    Linearizer(const SkPath& path, SkArenaAlloc* alloc) : GrTriangulator(path, alloc) {}
+};
+
+// GrTriangulator::PathToTriangles returns 0 both for a path that encloses no area and for one it
+// gave up on. A band clipped from a larger path is often empty, so the two are told apart here.
+class BandTriangulator : private GrTriangulator {
+public:
+    // Returns false if the path could not be triangulated. Otherwise, returns true and sets
+    // *count to the number of vertices written, which is 0 (with nothing allocated) if the path
+    // encloses no area.
+    static bool Triangulate(const SkPath& path, SkScalar tolerance,
+                            GrEagerVertexAllocator* vertexAllocator, int* count) {
+        SkArenaAlloc alloc(kArenaDefaultChunkSize);
+        BandTriangulator triangulator(path, &alloc);
+        bool isLinear;
+        auto [polys, success] = triangulator.pathToPolys(tolerance, SkRect::MakeEmpty(),
+                                                         &isLinear);
+        if (!success) {
+            return false;
+        }
+        const int64_t expected = CountPoints(polys, path.getFillType());
+        if (expected == 0) {
+            *count = 0;
+            return true;
+        }
+        // polysToTriangles also returns 0 if there are too many vertices or they can't be
+        // allocated.
+        *count = triangulator.polysToTriangles(polys, vertexAllocator);
+        return *count > 0;
+    }
+
+private:
+    BandTriangulator(const SkPath& path, SkArenaAlloc* alloc) : GrTriangulator(path, alloc) {}
+};
+
+// A stack of horizontal bands, each fHeight tall, with the first one starting at fFirst * fHeight.
+// fHeight is a power of two so the boundaries do not move as the path changes.
+struct BandGrid {
+    double fHeight;
+    double fFirst;
+    int fCount;
+
+    float boundary(int band) const { return static_cast<float>((fFirst + band) * fHeight); }
+
+    // The first and last bands whose closed extents include y.
+    std::pair<int, int> bandsAt(float y) const {
+        const double index = std::floor(y / fHeight);
+        const int last = std::min(static_cast<int>(index - fFirst), fCount - 1);
+        const int first = index == y / fHeight ? std::max(last - 1, 0) : last;
+        return {first, last};
+    }
+};
+
+// Returns the x where the line through p0 and p1 crosses y. The result does not depend on the
+// order of p0 and p1, so bands on either side of a boundary agree on it exactly.
+float crossing_at(SkPoint p0, SkPoint p1, float y) {
+    if (p1.fY < p0.fY) {
+        std::swap(p0, p1);
+    }
+    if (y <= p0.fY) {
+        return p0.fX;
+    }
+    if (y >= p1.fY) {
+        return p1.fX;
+    }
+    const float t = (y - p0.fY) / (p1.fY - p0.fY);
+    const float x = p0.fX + t * (p1.fX - p0.fX);
+    return std::clamp(x, std::min(p0.fX, p1.fX), std::max(p0.fX, p1.fX));
+}
+
+}  // namespace
+
+bool GrTriangulationCache::BandKey::operator==(const BandKey& that) const {
+    return fHash == that.fHash &&
+           fFillType == that.fFillType &&
+           fPoints == that.fPoints &&
+           fContourEnds == that.fContourEnds;
+}
+
+// The cache is bounded by bytes; the count limit only has to stay out of the way.
+GrTriangulationCache::GrTriangulationCache(size_t maxBytes)
+        : fMaxBytes(maxBytes)
+        , fBands(SK_MaxS32, this) {}
+
+GrTriangulationCache::~GrTriangulationCache() = default;
+
+size_t GrTriangulationCache::EntryBytes(const BandKey& key,
+                                        const sk_sp<GrThreadSafeCache::VertexData>& triangles) {
+    return sizeof(BandKey) +
+           key.fPoints.size() * sizeof(SkPoint) +
+           key.fContourEnds.size() * sizeof(uint32_t) +
+           (triangles ? triangles->size() : 0);
+}
+
+void GrTriangulationCache::PurgeBand::operator()(
+        void* context,
+        const BandKey& key,
+        const sk_sp<GrThreadSafeCache::VertexData>* triangles) const {
+    auto cache = static_cast<GrTriangulationCache*>(context);
+    cache->fMutex.assertHeld();
+    const size_t bytes = EntryBytes(key, *triangles);
+    SkASSERT(cache->fCachedBytes >= bytes);
+    cache->fCachedBytes -= bytes;
+}
+
+void GrTriangulationCache::purge() {
+    SkAutoMutexExclusive lock(fMutex);
+    // reset() does not call PurgeBand.
+    fBands.reset();
+    fCachedBytes = 0;
+}
+
+bool GrTriangulationCache::CanTriangulate(const SkPath& path) {
+    return path.isFinite() &&
+           !path.isInverseFillType() &&
+           path.countPoints() >= kMinPointCount;
+}
+
+GrTriangulationCache::Stats GrTriangulationCache::lastStats() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fLastStats;
+}
+
+#if defined(GPU_TEST_UTILS)
+int GrTriangulationCache::numCachedBands() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fBands.count();
+}
+
+size_t GrTriangulationCache::cachedBytes() const {
+    SkAutoMutexExclusive lock(fMutex);
+    return fCachedBytes;
+}
+#endif
+
+sk_sp<GrThreadSafeCache::VertexData> GrTriangulationCache::TriangulateBand(const BandKey& band,
+                                                                          SkScalar tolerance) {
+    SkPathBuilder builder(band.fFillType);
+    uint32_t start = 0;
+    for (uint32_t end : band.fContourEnds) {
+        builder.moveTo(band.fPoints[start]);
+        for (uint32_t i = start + 1; i < end; ++i) {
+            builder.lineTo(band.fPoints[i]);
+        }
+        builder.close();
+        start = end;
+    }
+
+    GrCpuVertexAllocator allocator;
+    int count;
+    if (!BandTriangulator::Triangulate(builder.detach(), tolerance, &allocator, &count)) {
+        // Cached as null, so the band is not attempted again.
+        return nullptr;
+    }
+    if (count == 0) {
+        return GrThreadSafeCache::MakeVertexData(nullptr, 0, sizeof(SkPoint));
+    }
+    return allocator.detachVertexData();
+}
+
+int GrTriangulationCache::pathToTriangles(const SkPath& path, SkScalar tolerance,
+                                          GrEagerVertexAllocator* vertexAllocator,
+                                          bool* isLinear) {
+    TRACE_EVENT0("skia.gpu", TRACE_FUNC);
+    SkASSERT(CanTriangulate(path));
+
+    std::vector<SkPoint> points;
+    std::vector<uint32_t> contourEnds;
+    Linearizer::Linearize(path, tolerance, &points, &contourEnds, isLinear);
+
+    auto triangulateWhole = [&]() {
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            fLastStats = {1, 0, 1};
+        }
+        return GrTriangulator::PathToTriangles(path, tolerance, SkRect::MakeEmpty(),
+                                               vertexAllocator, isLinear);
+    };
+
+    // Choose the bands.
+    const SkRect bounds = SkRect::BoundsOrEmpty(points);
+    const int targetCount = std::min(SkToInt(points.size()) / kPointsPerBand, kMaxBandCount);
+    if (targetCount < 2 || bounds.height() <= 0) {
+        return triangulateWhole();
+    }
+    BandGrid grid;
+    grid.fHeight = std::exp2(std::ceil(std::log2(double(bounds.height()) / targetCount)));
+    grid.fFirst = std::floor(bounds.fTop / grid.fHeight);
+    const double last = std::floor(bounds.fBottom / grid.fHeight);
+    if (std::abs(grid.fFirst) > kMaxBandIndex || std::abs(last) > kMaxBandIndex) {
+        return triangulateWhole();
+    }
+    grid.fCount = static_cast<int>(last - grid.fFirst) + 1;
+
+    // Clip every contour to each band it crosses. Points outside a band are projected onto the
+    // band's nearest boundary; only the points where the contour enters and leaves the band are
+    // kept, since the projected runs between them lie along the boundary and enclose nothing.
+    struct Band {
+        BandKey fKey;
+        uint32_t fContourStart = 0;
+        bool fTouched = false;
+    };
+    std::vector<Band> bands(grid.fCount);
+    for (Band& band : bands) {
+        band.fKey.fFillType = path.getFillType();
+    }
+    std::vector<int> touched;
+    auto append = [&](int index, SkPoint p) {
+        Band& band = bands[index];
+        if (!band.fTouched) {
+            band.fTouched = true;
+            band.fContourStart = SkToU32(band.fKey.fPoints.size());
+            touched.push_back(index);
+        }
+        if (band.fKey.fPoints.size() == band.fContourStart || band.fKey.fPoints.back() != p) {
+            band.fKey.fPoints.push_back(p);
+        }
+    };
+    auto clampToBand = [&](SkPoint p, SkPoint other, int index) {
+        const float top = grid.boundary(index), bottom = grid.boundary(index + 1);
+        if (p.fY < top) {
+            return SkPoint{crossing_at(p, other, top), top};
+        }
+        if (p.fY > bottom) {
+            return SkPoint{crossing_at(p, other, bottom), bottom};
+        }
+        return p;
+    };
+
+    uint32_t start = 0;
+    for (uint32_t end : contourEnds) {
+        for (uint32_t i = start; i < end; ++i) {
+            const SkPoint p0 = points[i],
+                          p1 = points[i + 1 < end ? i + 1 : start];
+            const int first = grid.bandsAt(std::min(p0.fY, p1.fY)).first,
+                      last = grid.bandsAt(std::max(p0.fY, p1.fY)).second;
+            for (int index = first; index <= last; ++index) {
+                append(index, clampToBand(p0, p1, index));
+                append(index, clampToBand(p1, p0, index));
+            }
+        }
+        for (int index : touched) {
+            Band& band = bands[index];
+            std::vector<SkPoint>& bandPoints = band.fKey.fPoints;
+            if (bandPoints.size() > band.fContourStart + 1 &&
+                bandPoints.back() == bandPoints[band.fContourStart]) {
+                bandPoints.pop_back();
+            }
+            if (bandPoints.size() < band.fContourStart + 3) {
+                bandPoints.resize(band.fContourStart);
+            } else {
+                band.fKey.fContourEnds.push_back(SkToU32(bandPoints.size()));
+            }
+            band.fTouched = false;
+        }
+        touched.clear();
+        start = end;
+    }
+
+    // Find or triangulate each band.
+    std::vector<sk_sp<GrThreadSafeCache::VertexData>> triangles(bands.size());
+    int reusedCount = 0;
+    int triangulatedCount = 0;
+    for (size_t i = 0; i < bands.size(); ++i) {
+        BandKey& key = bands[i].fKey;
+        if (key.fContourEnds.empty()) {
+            continue;
+        }
+        key.fHash = SkChecksum::Hash32(key.fPoints.data(), key.fPoints.size() * sizeof(SkPoint),
+                                       static_cast<uint32_t>(key.fFillType));
+        key.fHash = SkChecksum::Hash32(key.fContourEnds.data(),
+                                       key.fContourEnds.size() * sizeof(uint32_t),
+                                       key.fHash);
+        {
+            SkAutoMutexExclusive lock(fMutex);
+            if (sk_sp<GrThreadSafeCache::VertexData>* found = fBands.find(key)) {
+                triangles[i] = *found;
+                ++reusedCount;
+                continue;
+            }
+        }
+        triangles[i] = TriangulateBand(key, tolerance);
+        ++triangulatedCount;
+        SkAutoMutexExclusive lock(fMutex);
+        if (!fBands.find(key)) {
+            fCachedBytes += EntryBytes(key, triangles[i]);
+            fBands.insert(key, triangles[i]);
+            while (fCachedBytes > fMaxBytes && fBands.count() > 0) {
+                fBands.removeLeastRecentlyUsed();
+            }
+        }
+    }
+    // GrTriangulator gives up on some pathological inputs. A band can fail where the whole path
+    // does not, so fall back rather than drop the band's triangles. Empty bands are not null.
+    for (size_t i = 0; i < bands.size(); ++i) {
+        if (!bands[i].fKey.fContourEnds.empty() && !triangles[i]) {
+            return triangulateWhole();
+        }
+    }
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        fLastStats = {grid.fCount, reusedCount, triangulatedCount};
+    }
+
+    // Concatenate the bands' triangles.
+    int64_t count64 = 0;
+    for (const sk_sp<GrThreadSafeCache::VertexData>& data : triangles) {
+        if (data) {
+            SkASSERT(data->vertexSize() == sizeof(SkPoint));
+            count64 += data->numVertices();
+        }
+    }
+    if (count64 == 0 || count64 > SK_MaxS32) {
+        return 0;
+    }
+    const int count = SkToInt(count64);
+    skgpu::VertexWriter verts = vertexAllocator->lockWriter(sizeof(SkPoint), count);
+    if (!verts) {
+        SkDebugf("Could not allocate vertices\n");
+        return 0;
+    }
+    for (const sk_sp<GrThreadSafeCache::VertexData>& data : triangles) {
+        if (data) {
+            verts << skgpu::VertexWriter::Array(static_cast<const SkPoint*>(data->vertices()),
+                                                data->numVertices());
+        }
+    }
+    vertexAllocator->unlock(count);
+    return count;
+}
+
+#endif  // SK_ENABLE_OPTIMIZE_SIZE
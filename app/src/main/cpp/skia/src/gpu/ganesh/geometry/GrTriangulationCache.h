@@ -0,0 +1,121 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef GrTriangulationCache_DEFINED
+#define GrTriangulationCache_DEFINED
+
+#include "include/core/SkTypes.h"
+
+#if !defined(SK_ENABLE_OPTIMIZE_SIZE)
+
+#include "include/core/SkPathTypes.h"
+#include "include/core/SkPoint.h"
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkScalar.h"
+#include "include/private/base/SkMutex.h"
+#include "include/private/base/SkThreadAnnotations.h"
+#include "src/core/SkLRUCache.h"
+#include "src/gpu/ganesh/GrThreadSafeCache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class GrEagerVertexAllocator;
+class SkPath;
+
+/**
+ * Triangulates large paths as a stack of horizontal bands, each triangulated separately by
+ * GrTriangulator, and keeps the triangles of recently seen bands keyed by their linearized
+ * contents. When an animated path changes in only a few places, as a chart does from frame to
+ * frame, only the bands touched by the changed edges are triangulated again.
+ *
+ * The bands are aligned to a power-of-two grid in the path's coordinates, so they stay put while
+ * the path changes. Each band's contours are the path's contours clipped to the band, so the
+ * triangles of all the bands cover exactly the path's fill.
+ *
+ * The cache holds at most maxBytes of keys and triangles, evicting the least recently used bands
+ * first. The context empties it when it purges unlocked resources.
+ */
+class GrTriangulationCache : public SkRefCnt {
+public:
+    // Paths with fewer points are cheap enough to triangulate in one piece.
+    static constexpr int kMinPointCount = 256;
+    // Bands are sized to hold about this many linearized points.
+    static constexpr int kPointsPerBand = 128;
+    static constexpr int kMaxBandCount = 64;
+    static constexpr size_t kDefaultMaxBytes = 4 * 1024 * 1024;
+
+    explicit GrTriangulationCache(size_t maxBytes = kDefaultMaxBytes);
+    ~GrTriangulationCache() override;
+
+    // Should pathToTriangles be used for this path? Small paths are cheap to triangulate in one
+    // piece, and inverse fills depend on the clip, so they are left to GrTriangulator.
+    static bool CanTriangulate(const SkPath&);
+
+    // Triangulates the path like GrTriangulator::PathToTriangles, reusing the triangles of any
+    // band whose contents have not changed since they were last triangulated.
+    int pathToTriangles(const SkPath&, SkScalar tolerance, GrEagerVertexAllocator*,
+                        bool* isLinear);
+
+    // Drops every cached band.
+    void purge();
+
+    struct Stats {
+        int fBandCount = 0;
+        int fReusedBandCount = 0;
+        int fTriangulatedBandCount = 0;
+    };
+    // The bands used by the last call to pathToTriangles: how many were found in the cache, and
+    // how many had to be triangulated. Bands that no contour crosses are neither.
+    Stats lastStats() const;
+
+#if defined(GPU_TEST_UTILS)
+    int numCachedBands() const;
+    size_t cachedBytes() const;
+#endif
+
+private:
+    // The linearized contours of one band, and the key its triangles are cached under.
+    struct BandKey {
+        SkPathFillType fFillType;
+        std::vector<SkPoint> fPoints;
+        // fPoints[fContourEnds[i - 1]] to fPoints[fContourEnds[i]] are the points of contour i.
+        std::vector<uint32_t> fContourEnds;
+        uint32_t fHash = 0;
+
+        bool operator==(const BandKey&) const;
+        struct Hash {
+            uint32_t operator()(const BandKey& key) const { return key.fHash; }
+        };
+    };
+
+    // Returns the band's triangles, which hold no vertices if the band encloses no area, or null
+    // if GrTriangulator failed on it.
+    static sk_sp<GrThreadSafeCache::VertexData> TriangulateBand(const BandKey&,
+                                                                SkScalar tolerance);
+
+    static size_t EntryBytes(const BandKey&, const sk_sp<GrThreadSafeCache::VertexData>&);
+
+    // Keeps fCachedBytes up to date as bands are evicted.
+    struct PurgeBand {
+        void operator()(void* context,
+                        const BandKey& key,
+                        const sk_sp<GrThreadSafeCache::VertexData>* triangles) const;
+    };
+
+    const size_t fMaxBytes;
+    mutable SkMutex fMutex;
+    SkLRUCache<BandKey, sk_sp<GrThreadSafeCache::VertexData>, BandKey::Hash, PurgeBand> fBands
+            SK_GUARDED_BY(fMutex);
+    size_t fCachedBytes SK_GUARDED_BY(fMutex) = 0;
+    Stats fLastStats SK_GUARDED_BY(fMutex);
+};
+
+#endif  // SK_ENABLE_OPTIMIZE_SIZE
+
+#endif  // GrTriangulationCache_DEFINED
@@ -48,6 +48,7 @@
 #include "src/gpu/ganesh/geometry/GrAATriangulator.h"
 #include "src/gpu/ganesh/geometry/GrPathUtils.h"
 #include "src/gpu/ganesh/geometry/GrStyledShape.h"
+#include "src/gpu/ganesh/geometry/GrTriangulationCache.h"
 #include "src/gpu/ganesh/geometry/GrTriangulator.h"
 #include "src/gpu/ganesh/ops/GrMeshDrawOp.h"
 #include "src/gpu/ganesh/ops/GrOp.h"
@@ -217,10 +218,12 @@ public:
                             const SkMatrix& viewMatrix,
                             SkIRect devClipBounds,
                             GrAAType aaType,
-                            const GrUserStencilSettings* stencilSettings) {
+                            const GrUserStencilSettings* stencilSettings,
+                            sk_sp<GrTriangulationCache> triangulationCache) {
         return Helper::FactoryHelper<TriangulatingPathOp>(context, std::move(paint), shape,
                                                           viewMatrix, devClipBounds, aaType,
-                                                          stencilSettings);
+                                                          stencilSettings,
+                                                          std::move(triangulationCache));
     }
 
     const char* name() const override { return "TriangulatingPathOp"; }
@@ -239,14 +242,16 @@ public:
                         const SkMatrix& viewMatrix,
                         const SkIRect& devClipBounds,
                         GrAAType aaType,
-                        const GrUserStencilSettings* stencilSettings)
+                        const GrUserStencilSettings* stencilSettings,
+                        sk_sp<GrTriangulationCache> triangulationCache)
             : INHERITED(ClassID())
             , fHelper(processorSet, aaType, stencilSettings)
             , fColor(color)
             , fShape(shape)
             , fViewMatrix(viewMatrix)
             , fDevClipBounds(devClipBounds)
-            , fAntiAlias(GrAAType::kCoverage == aaType) {
+            , fAntiAlias(GrAAType::kCoverage == aaType)
+            , fTriangulationCache(std::move(triangulationCache)) {
         SkRect devBounds;
         viewMatrix.mapRect(&devBounds, shape.bounds());
         if (shape.inverseFilled()) {
@@ -299,12 +304,14 @@ private:
     }
 
     // Triangulate the provided 'shape' in the shape's coordinate space. 'tol' should already
-    // have been mapped back from device space.
+    // have been mapped back from device space. If there is a triangulation cache, large paths
+    // only re-triangulate the regions that changed since it last saw them.
     static int Triangulate(GrEagerVertexAllocator* allocator,
                            const SkMatrix& viewMatrix,
                            const GrStyledShape& shape,
                            const SkIRect& devClipBounds,
                            SkScalar tol,
+                           GrTriangulationCache* triangulationCache,
                            bool* isLinear) {
         SkRect clipBounds = SkRect::Make(devClipBounds);
 
@@ -318,6 +325,9 @@ private:
         SkPath path;
         shape.asPath(&path);
 
+        if (triangulationCache && GrTriangulationCache::CanTriangulate(path)) {
+            return triangulationCache->pathToTriangles(path, tol, allocator, isLinear);
+        }
         return GrTriangulator::PathToTriangles(path, tol, clipBounds, allocator, isLinear);
     }
 
@@ -363,7 +373,7 @@ private:
 
         bool isLinear;
         int vertexCount = Triangulate(&allocator, fViewMatrix, fShape, fDevClipBounds, tol,
-                                      &isLinear);
+                                      fTriangulationCache.get(), &isLinear);
         if (vertexCount == 0) {
             return;
         }
@@ -501,7 +511,7 @@ private:
 
         bool isLinear;
         int vertexCount = Triangulate(&allocator, fViewMatrix, fShape, fDevClipBounds, tol,
-                                      &isLinear);
+                                      fTriangulationCache.get(), &isLinear);
         if (vertexCount == 0) {
             return;
         }
@@ -574,6 +584,9 @@ private:
     SkMatrix       fViewMatrix;
     SkIRect        fDevClipBounds;
     bool           fAntiAlias;
+    // Only used for non-AA triangulation; the AA triangulator's coverage ramps would show seams
+    // between separately triangulated regions.
+    sk_sp<GrTriangulationCache> fTriangulationCache;
 
     GrSimpleMesh*  fMesh = nullptr;
     GrProgramInfo* fProgramInfo = nullptr;
@@ -606,7 +619,7 @@ GR_DRAW_OP_TEST_DEFINE(TriangulatingPathOp) {
     } while (!style.isSimpleFill());
     GrStyledShape shape(path, style);
     return TriangulatingPathOp::Make(context, std::move(paint), shape, viewMatrix, devClipBounds,
-                                     aaType, GrGetRandomStencil(random, context));
+                                     aaType, GrGetRandomStencil(random, context), nullptr);
 }
 
 #endif
@@ -616,7 +629,8 @@ GR_DRAW_OP_TEST_DEFINE(TriangulatingPathOp) {
 namespace skgpu::ganesh {
 
 TriangulatingPathRenderer::TriangulatingPathRenderer()
-    : fMaxVerbCount(GR_AA_TESSELLATOR_MAX_VERB_COUNT) {
+    : fMaxVerbCount(GR_AA_TESSELLATOR_MAX_VERB_COUNT)
+    , fTriangulationCache(sk_make_sp<GrTriangulationCache>()) {
 }
 
 PathRenderer::CanDrawPath TriangulatingPathRenderer::onCanDrawPath(
@@ -668,7 +682,8 @@ bool TriangulatingPathRenderer::onDrawPath(const DrawPathArgs& args) {
 
     GrOp::Owner op = TriangulatingPathOp::Make(
             args.fContext, std::move(args.fPaint), *args.fShape, *args.fViewMatrix,
-            *args.fClipConservativeBounds, args.fAAType, args.fUserStencilSettings);
+            *args.fClipConservativeBounds, args.fAAType, args.fUserStencilSettings,
+            fTriangulationCache);
     args.fSurfaceDrawContext->addDrawOp(args.fClip, std::move(op));
     return true;
 }
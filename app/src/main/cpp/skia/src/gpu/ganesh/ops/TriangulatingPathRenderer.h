@@ -12,7 +12,9 @@
 
 #if !defined(SK_ENABLE_OPTIMIZE_SIZE)
 
+#include "include/core/SkRefCnt.h"
 #include "src/gpu/ganesh/PathRenderer.h"
+#include "src/gpu/ganesh/geometry/GrTriangulationCache.h"
 
 class GrStyledShape;
 
@@ -27,10 +29,13 @@ public:
     TriangulatingPathRenderer();
 #if defined(GPU_TEST_UTILS)
     void setMaxVerbCount(int maxVerbCount) { fMaxVerbCount = maxVerbCount; }
+    GrTriangulationCache* triangulationCache() const { return fTriangulationCache.get(); }
 #endif
 
     const char* name() const override { return "Triangulating"; }
 
+    void purgeCaches() override { fTriangulationCache->purge(); }
+
 private:
     CanDrawPath onCanDrawPath(const CanDrawPathArgs&) const override;
 
@@ -41,6 +46,8 @@ private:
     bool onDrawPath(const DrawPathArgs&) override;
 
     int fMaxVerbCount;
+    // Reuses the triangles of unchanged regions when large, non-AA paths are re-triangulated.
+    sk_sp<GrTriangulationCache> fTriangulationCache;
 };
 
 }  // namespace skgpu::ganesh
@@ -28,6 +28,7 @@
 #include "src/gpu/tessellate/PatchWriter.h"
 #include "src/gpu/tessellate/WangsFormula.h"
 
+#include <algorithm>
 #include <utility>
 
 namespace skgpu::ganesh {
@@ -46,23 +47,55 @@ using CurveWriter = PatchWriter<VertexChunkPatchAllocator,
 void write_curve_patches(CurveWriter&& patchWriter,
                          const SkMatrix& shaderMatrix,
                          const PathTessellator::PathDrawList& pathDrawList) {
+    // Runs of consecutive quads or cubics are mapped into 'runPts' and written together, so the
+    // PatchWriter can evaluate Wang's formula for several curves at once.
+    static constexpr int kMaxRunLength = 64;
+    SkPoint runPts[3 * kMaxRunLength + 1];
+
     patchWriter.setShaderTransform(wangs_formula::VectorXform{shaderMatrix});
     for (auto [pathMatrix, path, color] : pathDrawList) {
         AffineMatrix m(pathMatrix);
         if (patchWriter.attribs() & PatchAttribs::kColor) {
             patchWriter.updateColorAttrib(color);
         }
+
+        SkPathVerb runVerb = SkPathVerb::kMove;
+        const SkPoint* runStart = nullptr;
+        int runLength = 0;
+        auto writeRun = [&]() {
+            const int ptsPerCurve = runVerb == SkPathVerb::kCubic ? 3 : 2;
+            while (runLength > 0) {
+                const int n = std::min(runLength, kMaxRunLength);
+                for (int i = 0; i <= n * ptsPerCurve; ++i) {
+                    runPts[i] = m.mapPoint(runStart[i]);
+                }
+                if (runVerb == SkPathVerb::kCubic) {
+                    patchWriter.writeCubicRun(runPts, n);
+                } else {
+                    patchWriter.writeQuadraticRun(runPts, n);
+                }
+                runStart += n * ptsPerCurve;
+                runLength -= n;
+            }
+            runVerb = SkPathVerb::kMove;
+        };
+
         for (auto [verb, pts, w] : SkPathPriv::Iterate(path)) {
             switch (verb) {
-                case SkPathVerb::kQuad: {
-                    auto [p0, p1] = m.map2Points(pts);
-                    auto p2 = m.map1Point(pts+2);
-
-                    patchWriter.writeQuadratic(p0, p1, p2);
+                case SkPathVerb::kQuad:
+                case SkPathVerb::kCubic: {
+                    const int ptsPerCurve = verb == SkPathVerb::kCubic ? 3 : 2;
+                    if (verb != runVerb || pts != runStart + runLength * ptsPerCurve) {
+                        writeRun();
+                        runVerb = verb;
+                        runStart = pts;
+                    }
+                    ++runLength;
                     break;
                 }
 
                 case SkPathVerb::kConic: {
+                    writeRun();
                     auto [p0, p1] = m.map2Points(pts);
                     auto p2 = m.map1Point(pts+2);
 
@@ -70,17 +103,12 @@ void write_curve_patches(CurveWriter&& patchWriter,
                     break;
                 }
 
-                case SkPathVerb::kCubic: {
-                    auto [p0, p1] = m.map2Points(pts);
-                    auto [p2, p3] = m.map2Points(pts+2);
-
-                    patchWriter.writeCubic(p0, p1, p2, p3);
+                default:
+                    writeRun();
                     break;
-                }
-
-                default: break;
             }
         }
+        writeRun();
     }
 }
 
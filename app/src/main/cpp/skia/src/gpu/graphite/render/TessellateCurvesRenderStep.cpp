@@ -158,14 +158,39 @@ void TessellateCurvesRenderStep::writeVertices(DrawWriter* dw,
     // provide a templated WritePatches function, the iterator could also be a template arg in
     // addition to PatchWriter's traits. Whatever pattern we choose will be based more on what's
     // best for the wedge and stroke case, which have more complex loops.
+    //
+    // Runs of consecutive quads or cubics share endpoints in the path's point storage, so they are
+    // written together, letting the writer evaluate Wang's formula for several curves at once.
+    SkPathVerb runVerb = SkPathVerb::kMove;
+    const SkPoint* runStart = nullptr;
+    int runLength = 0;
+    auto writeRun = [&]() {
+        if (runVerb == SkPathVerb::kCubic) {
+            writer.writeCubicRun(runStart, runLength);
+        } else if (runVerb == SkPathVerb::kQuad) {
+            writer.writeQuadraticRun(runStart, runLength);
+        }
+        runVerb = SkPathVerb::kMove;
+        runLength = 0;
+    };
     for (auto [verb, pts, w] : SkPathPriv::Iterate(path)) {
         switch (verb) {
-            case SkPathVerb::kQuad:  writer.writeQuadratic(pts); break;
-            case SkPathVerb::kConic: writer.writeConic(pts, *w); break;
-            case SkPathVerb::kCubic: writer.writeCubic(pts);     break;
-            default:                                             break;
+            case SkPathVerb::kQuad:
+            case SkPathVerb::kCubic: {
+                const int ptsPerCurve = verb == SkPathVerb::kCubic ? 3 : 2;
+                if (verb != runVerb || pts != runStart + runLength * ptsPerCurve) {
+                    writeRun();
+                    runVerb = verb;
+                    runStart = pts;
+                }
+                ++runLength;
+                break;
+            }
+            case SkPathVerb::kConic: writeRun(); writer.writeConic(pts, *w); break;
+            default:                 writeRun();                             break;
         }
     }
+    writeRun();
 }
 
 void TessellateCurvesRenderStep::writeUniformsAndTextures(const DrawParams& params,
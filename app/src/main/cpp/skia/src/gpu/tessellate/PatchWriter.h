@@ -393,18 +393,7 @@ public:
     // Write a cubic curve with its four control points.
     AI void writeCubic(float2 p0, float2 p1, float2 p2, float2 p3) {
         float n4 = wangs_formula::cubic_p4(kPrecision, p0, p1, p2, p3, fApproxTransform);
-        if constexpr (kDiscardFlatCurves) {
-            if (n4 <= 1.f) {
-                // This cubic only needs one segment (e.g. a line) but we're not filling space with
-                // fans or stroking, so nothing actually needs to be drawn.
-                return;
-            }
-        }
-        if (int numPatches = this->accountForCurve(n4)) {
-            this->chopAndWriteCubics(p0, p1, p2, p3, numPatches);
-        } else {
-            this->writeCubicPatch(p0, p1, p2, p3);
-        }
+        this->writeCubic(p0, p1, p2, p3, n4);
     }
     AI void writeCubic(const SkPoint pts[4]) {
         float4 p0p1 = float4::Load(pts);
@@ -412,6 +401,31 @@ public:
         this->writeCubic(p0p1.lo, p0p1.hi, p2p3.lo, p2p3.hi);
     }
 
+    // Write 'count' cubics that share endpoints, the way consecutive cubic verbs are stored in an
+    // SkPath: the i'th cubic's control points are pts[3i] through pts[3i + 3]. Wang's formula is
+    // evaluated for 4 cubics at a time, and the patches are identical to calling writeCubic() on
+    // each cubic in order.
+    void writeCubicRun(const SkPoint pts[], int count) {
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const SkPoint* batch = pts + 3*i;
+            float4 x[4], y[4];
+            for (int j = 0; j < 4; ++j) {
+                x[j] = {batch[j].fX, batch[j + 3].fX, batch[j + 6].fX, batch[j + 9].fX};
+                y[j] = {batch[j].fY, batch[j + 3].fY, batch[j + 6].fY, batch[j + 9].fY};
+            }
+            float4 n4 = wangs_formula::cubic_p4(kPrecision, x, y, fApproxTransform);
+            for (int k = 0; k < 4; ++k) {
+                float4 p0p1 = float4::Load(batch + 3*k);
+                float4 p2p3 = float4::Load(batch + 3*k + 2);
+                this->writeCubic(p0p1.lo, p0p1.hi, p2p3.lo, p2p3.hi, n4[k]);
+            }
+        }
+        for (; i < count; ++i) {
+            this->writeCubic(pts + 3*i);
+        }
+    }
+
     // Write a conic curve with three control points and 'w', with the last coord of the last
     // control point signaling a conic by being set to infinity.
     AI void writeConic(float2 p0, float2 p1, float2 p2, float w) {
@@ -440,18 +454,7 @@ public:
     // equivalent cubic.
     AI void writeQuadratic(float2 p0, float2 p1, float2 p2) {
         float n4 = wangs_formula::quadratic_p4(kPrecision, p0, p1, p2, fApproxTransform);
-        if constexpr (kDiscardFlatCurves) {
-            if (n4 <= 1.f) {
-                // This quad only needs one segment (e.g. a line) but we're not filling space with
-                // fans or stroking, so nothing actually needs to be drawn.
-                return;
-            }
-        }
-        if (int numPatches = this->accountForCurve(n4)) {
-            this->chopAndWriteQuads(p0, p1, p2, numPatches);
-        } else {
-            this->writeQuadPatch(p0, p1, p2);
-        }
+        this->writeQuadratic(p0, p1, p2, n4);
     }
     AI void writeQuadratic(const SkPoint pts[3]) {
         this->writeQuadratic(sk_bit_cast<float2>(pts[0]),
@@ -459,6 +462,33 @@ public:
                              sk_bit_cast<float2>(pts[2]));
     }
 
+    // Write 'count' quadratics that share endpoints, the way consecutive quad verbs are stored in
+    // an SkPath: the i'th quadratic's control points are pts[2i] through pts[2i + 2]. Wang's
+    // formula is evaluated for 4 quadratics at a time, and the patches are identical to calling
+    // writeQuadratic() on each quadratic in order.
+    void writeQuadraticRun(const SkPoint pts[], int count) {
+        int i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const SkPoint* batch = pts + 2*i;
+            float4 x[3], y[3];
+            for (int j = 0; j < 3; ++j) {
+                x[j] = {batch[j].fX, batch[j + 2].fX, batch[j + 4].fX, batch[j + 6].fX};
+                y[j] = {batch[j].fY, batch[j + 2].fY, batch[j + 4].fY, batch[j + 6].fY};
+            }
+            float4 n4 = wangs_formula::quadratic_p4(kPrecision, x, y, fApproxTransform);
+            for (int k = 0; k < 4; ++k) {
+                const SkPoint* quad = batch + 2*k;
+                this->writeQuadratic(sk_bit_cast<float2>(quad[0]),
+                                     sk_bit_cast<float2>(quad[1]),
+                                     sk_bit_cast<float2>(quad[2]),
+                                     n4[k]);
+            }
+        }
+        for (; i < count; ++i) {
+            this->writeQuadratic(pts + 2*i);
+        }
+    }
+
     // Write a line that is automatically converted into an equivalent cubic.
     AI void writeLine(float4 p0p1) {
         // No chopping needed, a line only ever requires one segment (the minimum required already).
@@ -509,6 +539,36 @@ public:
     }
 
 private:
+    // Writes a cubic or quadratic whose Wang's formula, raised to the 4th power, is already known.
+    AI void writeCubic(float2 p0, float2 p1, float2 p2, float2 p3, float n4) {
+        if constexpr (kDiscardFlatCurves) {
+            if (n4 <= 1.f) {
+                // This cubic only needs one segment (e.g. a line) but we're not filling space with
+                // fans or stroking, so nothing actually needs to be drawn.
+                return;
+            }
+        }
+        if (int numPatches = this->accountForCurve(n4)) {
+            this->chopAndWriteCubics(p0, p1, p2, p3, numPatches);
+        } else {
+            this->writeCubicPatch(p0, p1, p2, p3);
+        }
+    }
+    AI void writeQuadratic(float2 p0, float2 p1, float2 p2, float n4) {
+        if constexpr (kDiscardFlatCurves) {
+            if (n4 <= 1.f) {
+                // This quad only needs one segment (e.g. a line) but we're not filling space with
+                // fans or stroking, so nothing actually needs to be drawn.
+                return;
+            }
+        }
+        if (int numPatches = this->accountForCurve(n4)) {
+            this->chopAndWriteQuads(p0, p1, p2, numPatches);
+        } else {
+            this->writeQuadPatch(p0, p1, p2);
+        }
+    }
+
     AI void emitPatchAttribs(VertexWriter vertexWriter,
                              const JoinAttrib& join,
                              float explicitCurveType) {
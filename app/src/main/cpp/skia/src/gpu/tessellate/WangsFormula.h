@@ -127,6 +127,14 @@ public:
         return join(fC0 * vectors.x() + fC1 * vectors.y(),
                     fC0 * vectors.z() + fC1 * vectors.w());
     }
+    // Transforms N vectors stored as separate x and y coordinates, one vector per lane.
+    template<int N>
+    AI void transform(skvx::Vec<N,float>* x, skvx::Vec<N,float>* y) const {
+        skvx::Vec<N,float> tx = fC0.x() * *x + fC1.x() * *y;
+        skvx::Vec<N,float> ty = fC0.y() * *x + fC1.y() * *y;
+        *x = tx;
+        *y = ty;
+    }
 private:
     // First and second columns of 2x2 matrix
     skvx::float2 fC0;
@@ -152,6 +160,20 @@ AI float quadratic_p4(float precision,
                         vectorXform);
 }
 
+// Returns Wang's formula, raised to the 4th power, for N quadratic curves at once. x[i] and y[i]
+// hold the i'th control point of each curve, one curve per lane. Every lane goes through the same
+// float operations as the single-curve quadratic_p4(), so the results are bit-identical to it.
+template<int N>
+AI skvx::Vec<N,float> quadratic_p4(float precision,
+                                   const skvx::Vec<N,float> x[3],
+                                   const skvx::Vec<N,float> y[3],
+                                   const VectorXform& vectorXform = VectorXform()) {
+    skvx::Vec<N,float> vx = -2*x[1] + x[0] + x[2];
+    skvx::Vec<N,float> vy = -2*y[1] + y[0] + y[2];
+    vectorXform.transform(&vx, &vy);
+    return (vx*vx + vy*vy) * length_term_p2<2>(precision);
+}
+
 // Returns Wang's formula specialized for a quadratic curve.
 AI float quadratic(float precision,
                    const SkPoint pts[],
@@ -191,6 +213,23 @@ AI float cubic_p4(float precision,
                     vectorXform);
 }
 
+// Returns Wang's formula, raised to the 4th power, for N cubic curves at once. x[i] and y[i] hold
+// the i'th control point of each curve, one curve per lane. Every lane goes through the same float
+// operations as the single-curve cubic_p4(), so the results are bit-identical to it.
+template<int N>
+AI skvx::Vec<N,float> cubic_p4(float precision,
+                               const skvx::Vec<N,float> x[4],
+                               const skvx::Vec<N,float> y[4],
+                               const VectorXform& vectorXform = VectorXform()) {
+    skvx::Vec<N,float> v01x = -2*x[1] + x[0] + x[2];
+    skvx::Vec<N,float> v01y = -2*y[1] + y[0] + y[2];
+    skvx::Vec<N,float> v12x = -2*x[2] + x[1] + x[3];
+    skvx::Vec<N,float> v12y = -2*y[2] + y[1] + y[3];
+    vectorXform.transform(&v01x, &v01y);
+    vectorXform.transform(&v12x, &v12y);
+    return max(v01x*v01x + v01y*v01y, v12x*v12x + v12y*v12y) * length_term_p2<3>(precision);
+}
+
 // Returns Wang's formula specialized for a cubic curve.
 AI float cubic(float precision,
                const SkPoint pts[],
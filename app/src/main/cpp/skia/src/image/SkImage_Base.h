@@ -108,6 +108,12 @@ public:
     virtual bool getROPixels(GrDirectContext*, SkBitmap*,
                              CachingHint = kAllow_CachingHint) const = 0;
 
+    // Return a read-only, downscaled copy of the pixels with the dimensions of mip level
+    // scaleBucket (see SkMipmap::IsLevelSize), for images that can produce one more cheaply than
+    // the full-size pixels (e.g. by asking a codec to decode at a smaller size). Returns false if
+    // no such variant is available; callers should then fall back to getROPixels().
+    virtual bool getScaledROPixels(int scaleBucket, SkBitmap*) const { return false; }
+
     virtual sk_sp<SkImage> onMakeSubset(SkRecorder*, const SkIRect&, RequiredProperties) const = 0;
 
     virtual sk_sp<SkData> onRefEncoded() const { return nullptr; }
@@ -19,6 +19,7 @@
 #include "include/core/SkYUVAInfo.h"
 #include "src/core/SkBitmapCache.h"
 #include "src/core/SkCachedData.h"
+#include "src/core/SkMipmap.h"
 #include "src/core/SkNextID.h"
 #include "src/core/SkResourceCache.h"
 #include "src/core/SkYUVPlanesCache.h"
@@ -155,6 +156,52 @@ bool SkImage_Lazy::getROPixels(GrDirectContext* ctx, SkBitmap* bitmap,
     return true;
 }
 
+bool SkImage_Lazy::getScaledROPixels(int scaleBucket, SkBitmap* bitmap) const {
+    // Beyond this the variant would be smaller than a pixel for any supported image size.
+    static constexpr int kMaxScaleBucket = 30;
+    if (scaleBucket <= 0 || scaleBucket > kMaxScaleBucket) {
+        return false;
+    }
+
+    const float scale = 1.0f / (1 << scaleBucket);
+    SkISize dims;
+    {
+        ScopedGenerator generator(fSharedGenerator);
+        dims = generator->getScaledDimensions(scale);
+    }
+    // The variant stands in for a mip level, so it has to have that level's dimensions, give or
+    // take the rounding of the decoder's scaling.
+    if (!SkMipmap::IsLevelSize(this->dimensions(), scaleBucket, dims)) {
+        return false;
+    }
+
+    auto desc = SkBitmapCacheDesc::Make(this);
+    if (SkBitmapCache::FindVariant(desc, dims, bitmap)) {
+        SkASSERT(bitmap->isImmutable());
+        SkASSERT(bitmap->dimensions() == dims);
+        return true;
+    }
+    // If the full-size pixels are already decoded, the caller builds its mips from them. That
+    // is cheaper than decoding again, even at a smaller size.
+    SkBitmap fullSize;
+    if (SkBitmapCache::Find(desc, &fullSize)) {
+        return false;
+    }
+
+    SkPixmap pmap;
+    SkBitmapCache::RecPtr cacheRec =
+            SkBitmapCache::AllocVariant(desc, this->imageInfo().makeDimensions(dims), &pmap);
+    if (!cacheRec) {
+        return false;
+    }
+    if (!ScopedGenerator(fSharedGenerator)->getPixels(pmap)) {
+        return false;
+    }
+    SkBitmapCache::Add(std::move(cacheRec), bitmap);
+    this->notifyAddedToRasterCache();
+    return true;
+}
+
 sk_sp<SharedGenerator> SkImage_Lazy::generator() const {
     return fSharedGenerator;
 }
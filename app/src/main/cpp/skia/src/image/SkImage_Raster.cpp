@@ -21,6 +21,7 @@
 #include "include/core/SkSize.h"
 #include "include/core/SkTypes.h"
 #include "src/base/SkRectMemcpy.h"
+#include "src/core/SkImageFilter_Base.h"
 #include "src/core/SkImageInfoPriv.h"
 #include "src/core/SkImagePriv.h"
 #include "src/image/SkImage_Base.h"
@@ -137,6 +138,25 @@ static sk_sp<SkMipmap> copy_mipmaps(const SkBitmap& src, SkMipmap* srcMips) {
     return dst;
 }
 
+sk_sp<SkImage> SkImage_Raster::onMakeWithMipmaps(sk_sp<SkMipmap> mips) const {
+    // It's dangerous to have two SkBitmaps that share a SkPixelRef but have different SkMipmaps
+    // since various caches key on SkPixelRef's generation ID. Also, SkPixelRefs that back
+    // SkSurfaces are marked "temporarily immutable" and making an image that uses the same
+    // SkPixelRef can interact badly with SkSurface/SkImage copy-on-write. So we just always
+    // make a copy with a new ID.
+    static auto constexpr kCopyMode = SkCopyPixelsMode::kAlways_SkCopyPixelsMode;
+    sk_sp<SkImage> img = SkMakeImageFromRasterBitmap(fBitmap, kCopyMode);
+    auto imgRaster = static_cast<SkImage_Raster*>(img.get());
+    if (mips) {
+        imgRaster->fBitmap.fMips = std::move(mips);
+    } else {
+        imgRaster->fBitmap.fMips.reset(SkMipmap::Build(fBitmap.pixmap(), nullptr,
+                                                       /*computeContents=*/true,
+                                                       SkImageFilter_Base::GetExecutor()));
+    }
+    return img;
+}
+
 sk_sp<SkImage> SkImage_Raster::onMakeSubset(SkRecorder*,
                                             const SkIRect& subset,
                                             RequiredProperties requiredProperties) const {
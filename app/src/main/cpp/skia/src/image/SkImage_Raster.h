@@ -85,22 +85,7 @@ public:
 
     SkMipmap* onPeekMips() const override { return fBitmap.fMips.get(); }
 
-    sk_sp<SkImage> onMakeWithMipmaps(sk_sp<SkMipmap> mips) const override {
-        // It's dangerous to have two SkBitmaps that share a SkPixelRef but have different SkMipmaps
-        // since various caches key on SkPixelRef's generation ID. Also, SkPixelRefs that back
-        // SkSurfaces are marked "temporarily immutable" and making an image that uses the same
-        // SkPixelRef can interact badly with SkSurface/SkImage copy-on-write. So we just always
-        // make a copy with a new ID.
-        static auto constexpr kCopyMode = SkCopyPixelsMode::kAlways_SkCopyPixelsMode;
-        sk_sp<SkImage> img = SkMakeImageFromRasterBitmap(fBitmap, kCopyMode);
-        auto imgRaster = static_cast<SkImage_Raster*>(img.get());
-        if (mips) {
-            imgRaster->fBitmap.fMips = std::move(mips);
-        } else {
-            imgRaster->fBitmap.fMips.reset(SkMipmap::Build(fBitmap.pixmap(), nullptr));
-        }
-        return img;
-    }
+    sk_sp<SkImage> onMakeWithMipmaps(sk_sp<SkMipmap> mips) const override;
 
     SkImage_Base::Type type() const override { return SkImage_Base::Type::kRaster; }
 
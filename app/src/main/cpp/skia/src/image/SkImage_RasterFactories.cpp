@@ -107,7 +107,8 @@ sk_sp<SkImage> MakeWithFilter(sk_sp<SkImage> src,
         return nullptr;
     }
 
-    sk_sp<skif::Backend> backend = skif::MakeRasterBackend({}, src->colorType());
+    sk_sp<skif::Backend> backend = skif::MakeRasterBackend(
+            {}, src->colorType(), SkImageFilter_Base::RasterBlurOptions());
     return as_IFB(filter)->makeImageWithFilter(std::move(backend),
                                                std::move(src),
                                                subset,
@@ -3540,6 +3540,47 @@ HIGHP_STAGE(evenly_spaced_2_stop_gradient,
     a = mad(t, c->factor[3], c->bias[3]);
 }
 
+SI void two_stop_gradient(const SkRasterPipelineContexts::TwoStopGradientCtx* c, F t,
+                          F* r, F* g, F* b, F* a) {
+    // NaN t (e.g. from a degenerate matrix) maps to the first stop, like clamp_x_1 would.
+    t = if_then_else(t > 0.0f, min(t, 1.0f), F0);
+    *r = mad(t, c->factor[0], c->bias[0]);
+    *g = mad(t, c->factor[1], c->bias[1]);
+    *b = mad(t, c->factor[2], c->bias[2]);
+    *a = mad(t, c->factor[3], c->bias[3]);
+    if (c->premul) {
+        *r = *r * *a;
+        *g = *g * *a;
+        *b = *b * *a;
+    }
+}
+
+HIGHP_STAGE(linear_2_stop_gradient, const SkRasterPipelineContexts::TwoStopGradientCtx* c) {
+    const float* m = c->matrix;
+    F t = mad(r,m[0], mad(g,m[1], m[2]));
+    two_stop_gradient(c, t, &r, &g, &b, &a);
+}
+
+HIGHP_STAGE(radial_2_stop_gradient, const SkRasterPipelineContexts::TwoStopGradientCtx* c) {
+    const float* m = c->matrix;
+    F X = mad(r,m[0], mad(g,m[1], m[2])),
+      Y = mad(r,m[3], mad(g,m[4], m[5]));
+    two_stop_gradient(c, sqrt_(X*X + Y*Y), &r, &g, &b, &a);
+}
+
+HIGHP_STAGE(gradient_lut, const SkRasterPipelineContexts::GradientLUTCtx* c) {
+    F t = if_then_else(r > 0.0f, min(r, 1.0f), F0) * c->scale;
+    U32 ix = trunc_(t);
+    F  fx = t - cast(ix);
+
+    U32 lo = ix * 4,
+        hi = lo + 4;
+    r = lerp(gather(c->rgba, lo    ), gather(c->rgba, hi    ), fx);
+    g = lerp(gather(c->rgba, lo + 1), gather(c->rgba, hi + 1), fx);
+    b = lerp(gather(c->rgba, lo + 2), gather(c->rgba, hi + 2), fx);
+    a = lerp(gather(c->rgba, lo + 3), gather(c->rgba, hi + 3), fx);
+}
+
 HIGHP_STAGE(xy_to_unit_angle, NoCtx) {
     F X = r,
       Y = g;
@@ -3910,6 +3951,10 @@ HIGHP_TAIL_STAGE(set_base_pointer, std::byte* p) {
     base = p;
 }
 
+HIGHP_TAIL_STAGE(native_code, SkRasterPipelineContexts::NativeCodeCtx* ctx) {
+    ctx->fn(base, ctx->uniforms);
+}
+
 // All control flow stages used by SkSL maintain some state in the common registers:
 //   r: condition mask
 //   g: loop mask
@@ -6641,6 +6686,36 @@ LOWP_STAGE_GP(evenly_spaced_2_stop_gradient,
                    &r,&g,&b,&a);
 }
 
+// Unlike evenly_spaced_2_stop_gradient, these stages produce the final color directly. They don't
+// dither; when the paint asks for it, the blitter appends its own dither stage afterwards.
+SI void two_stop_gradient(const SkRasterPipelineContexts::TwoStopGradientCtx* c, F t,
+                          U16* r, U16* g, U16* b, U16* a) {
+    t = clamp_01_(t);
+    F R = mad(t, c->factor[0], c->bias[0]),
+      G = mad(t, c->factor[1], c->bias[1]),
+      B = mad(t, c->factor[2], c->bias[2]),
+      A = mad(t, c->factor[3], c->bias[3]);
+    if (c->premul) {
+        R = R * A;
+        G = G * A;
+        B = B * A;
+    }
+    round_F_to_U16(R, G, B, A, r,g,b,a);
+}
+
+LOWP_STAGE_GP(linear_2_stop_gradient, const SkRasterPipelineContexts::TwoStopGradientCtx* c) {
+    const float* m = c->matrix;
+    F t = mad(x,m[0], mad(y,m[1], m[2]));
+    two_stop_gradient(c, t, &r, &g, &b, &a);
+}
+
+LOWP_STAGE_GP(radial_2_stop_gradient, const SkRasterPipelineContexts::TwoStopGradientCtx* c) {
+    const float* m = c->matrix;
+    F X = mad(x,m[0], mad(y,m[1], m[2])),
+      Y = mad(x,m[3], mad(y,m[4], m[5]));
+    two_stop_gradient(c, sqrt_(X*X + Y*Y), &r, &g, &b, &a);
+}
+
 LOWP_STAGE_GP(bilerp_clamp_8888, const SkRasterPipelineContexts::GatherCtx* ctx) {
     // Quantize sample point and transform into lerp coordinates converting them to 16.16 fixed
     // point number.
@@ -9,6 +9,7 @@
 #include "include/core/SkPathTypes.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
+#include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
 #include "include/pathops/SkPathOps.h"
 #include "include/private/base/SkTArray.h"
@@ -17,6 +18,7 @@
 #include "src/base/SkArenaAlloc.h"
 #include "src/core/SkPathEnums.h"
 #include "src/core/SkPathPriv.h"
+#include "src/core/SkTaskGroup.h"
 #include "src/pathops/SkOpContour.h"
 #include "src/pathops/SkOpEdgeBuilder.h"
 #include "src/pathops/SkOpSegment.h"
@@ -25,7 +27,15 @@
 #include "src/pathops/SkPathOpsTypes.h"
 #include "src/pathops/SkPathWriter.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <numeric>
+#include <vector>
+
+// Unions of at least this many paths are resolved in clusters, see resolveUnionBatch().
+static constexpr int kMinBatchUnionCount = 16;
+// Halves of a cluster with at least this many paths are unioned on separate threads.
+static constexpr size_t kMinParallelUnionCount = 256;
 
 static bool one_contour(const SkPath& path) {
     SkSTArenaAlloc<256> allocator;
@@ -123,6 +133,148 @@ bool SkOpBuilder::FixWinding(SkPath* path) {
     return true;
 }
 
+// Bounds that only share an edge still count, so that the shared edge is merged away.
+static bool bounds_touch(const SkRect& a, const SkRect& b) {
+    return a.fLeft <= b.fRight && b.fLeft <= a.fRight &&
+           a.fTop <= b.fBottom && b.fTop <= a.fBottom;
+}
+
+static int find_cluster(std::vector<int>* parents, int index) {
+    while ((*parents)[index] != index) {
+        (*parents)[index] = (*parents)[(*parents)[index]];
+        index = (*parents)[index];
+    }
+    return index;
+}
+
+/* Unions the indexed paths by splitting them in half along the longer side of their bounds,
+   so that each Op combines neighbors and the intermediate paths stay small. Halves whose
+   results do not touch are appended instead. The result has an even-odd fill. */
+static bool union_hierarchically(const SkPath paths[], SkSpan<int> indices, SkExecutor* executor,
+                                 SkPath* result) {
+    if (indices.size() == 1) {
+        const SkPath& path = paths[indices[0]];
+        if (path.isConvex()) {
+            *result = path;
+            result->setFillType(SkPathFillType::kEvenOdd);
+            return true;
+        }
+        return Simplify(path, result);
+    }
+    SkRect bounds = paths[indices[0]].getBounds();
+    for (int index : indices) {
+        bounds.join(paths[index].getBounds());
+    }
+    bool splitX = bounds.width() >= bounds.height();
+    auto center = [&](int index) {
+        const SkRect& r = paths[index].getBounds();
+        return splitX ? r.centerX() : r.centerY();
+    };
+    size_t half = indices.size() / 2;
+    std::nth_element(indices.begin(), indices.begin() + half, indices.end(),
+                     [&](int a, int b) { return center(a) < center(b); });
+    SkPath first, second;
+    bool firstResolved, secondResolved;
+    if (executor && indices.size() >= kMinParallelUnionCount) {
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.add([&] {
+            firstResolved = union_hierarchically(paths, indices.first(half), executor, &first);
+        });
+        secondResolved = union_hierarchically(paths, indices.subspan(half), executor, &second);
+        taskGroup.wait();
+    } else {
+        firstResolved = union_hierarchically(paths, indices.first(half), nullptr, &first);
+        secondResolved = firstResolved &&
+                         union_hierarchically(paths, indices.subspan(half), nullptr, &second);
+    }
+    if (!firstResolved || !secondResolved) {
+        return false;
+    }
+    if (!bounds_touch(first.getBounds(), second.getBounds())) {
+        *result = first;
+        result->addPath(second);
+        return true;
+    }
+    return Op(first, second, kUnion_SkPathOp, result);
+}
+
+/* Unions many paths without one global intersection pass. Paths are grouped into clusters
+   whose bounds touch; clusters are disjoint, so each is resolved on its own and the results
+   are appended. */
+bool SkOpBuilder::resolveUnionBatch(SkPath* result, SkExecutor* executor) {
+    int count = fPathRefs.size();
+    std::vector<int> order;
+    order.reserve(count);
+    for (int index = 0; index < count; ++index) {
+        if (!fPathRefs[index].isEmpty()) {
+            order.push_back(index);
+        }
+    }
+    std::sort(order.begin(), order.end(), [this](int a, int b) {
+        return fPathRefs[a].getBounds().fLeft < fPathRefs[b].getBounds().fLeft;
+    });
+
+    // Sweep from left to right, comparing each path with those whose bounds reach it.
+    std::vector<int> parents(count);
+    std::iota(parents.begin(), parents.end(), 0);
+    std::vector<int> active;
+    for (int index : order) {
+        const SkRect& bounds = fPathRefs[index].getBounds();
+        active.erase(std::remove_if(active.begin(), active.end(), [&](int other) {
+            return fPathRefs[other].getBounds().fRight < bounds.fLeft;
+        }), active.end());
+        for (int other : active) {
+            if (bounds_touch(bounds, fPathRefs[other].getBounds())) {
+                parents[find_cluster(&parents, other)] = find_cluster(&parents, index);
+            }
+        }
+        active.push_back(index);
+    }
+
+    // Number the clusters in the order the paths were added, so the result is deterministic.
+    std::vector<int> clusterOf(count, -1);
+    std::vector<std::vector<int>> clusters;
+    for (int index = 0; index < count; ++index) {
+        if (fPathRefs[index].isEmpty()) {
+            continue;
+        }
+        int& cluster = clusterOf[find_cluster(&parents, index)];
+        if (cluster < 0) {
+            cluster = clusters.size();
+            clusters.emplace_back();
+        }
+        clusters[cluster].push_back(index);
+    }
+
+    int clusterCount = clusters.size();
+    std::vector<SkPath> clusterPaths(clusterCount);
+    std::unique_ptr<bool[]> resolved(new bool[clusterCount]);
+    auto resolveCluster = [&](int cluster) {
+        resolved[cluster] = union_hierarchically(fPathRefs.data(), SkSpan(clusters[cluster]),
+                                                 executor, &clusterPaths[cluster]);
+    };
+    if (executor && clusterCount > 1) {
+        SkTaskGroup taskGroup(*executor);
+        taskGroup.batch(clusterCount, resolveCluster);
+        taskGroup.wait();
+    } else {
+        for (int cluster = 0; cluster < clusterCount; ++cluster) {
+            resolveCluster(cluster);
+        }
+    }
+
+    SkPath sum;
+    sum.setFillType(SkPathFillType::kEvenOdd);
+    for (int cluster = 0; cluster < clusterCount; ++cluster) {
+        if (!resolved[cluster]) {
+            return false;
+        }
+        sum.addPath(clusterPaths[cluster]);
+    }
+    *result = sum;
+    return true;
+}
+
 void SkOpBuilder::add(const SkPath& path, SkPathOp op) {
     if (fOps.empty() && op != kUnion_SkPathOp) {
         fPathRefs.push_back() = SkPath();
@@ -141,8 +293,29 @@ void SkOpBuilder::reset() {
    paths with union ops could be locally resolved and still improve over doing the
    ops one at a time. */
 bool SkOpBuilder::resolve(SkPath* result) {
+    return this->resolve(result, nullptr);
+}
+
+bool SkOpBuilder::resolve(SkPath* result, SkExecutor* executor) {
     SkPath original = *result;
     int count = fOps.size();
+    if (count >= kMinBatchUnionCount) {
+        bool batchUnion = true;
+        for (int index = 0; index < count; ++index) {
+            if (kUnion_SkPathOp != fOps[index] || fPathRefs[index].isInverseFillType()) {
+                batchUnion = false;
+                break;
+            }
+        }
+        if (batchUnion) {
+            bool success = this->resolveUnionBatch(result, executor);
+            reset();
+            if (!success) {
+                *result = original;
+            }
+            return success;
+        }
+    }
     bool allUnion = true;
     SkPathFirstDirection firstDir = SkPathFirstDirection::kUnknown;
     for (int index = 0; index < count; ++index) {
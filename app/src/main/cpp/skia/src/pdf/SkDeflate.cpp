@@ -7,16 +7,23 @@
 
 #include "src/pdf/SkDeflate.h"
 
+#include "include/core/SkExecutor.h"
 #include "include/private/base/SkAssert.h"
 #include "include/private/base/SkDebug.h"
 #include "include/private/base/SkMalloc.h"
+#include "include/private/base/SkSemaphore.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTo.h"
 #include "src/core/SkTraceEvent.h"
+#include "src/encode/SkZlibChunks.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
 
 #include "zlib.h"  // NO_G3_REWRITE
 
@@ -73,11 +80,17 @@ struct SkDeflateWStream::Impl {
     unsigned char fInBuffer[SKDEFLATEWSTREAM_INPUT_BUFFER_SIZE];
     size_t fInBufferIndex;
     z_stream fZStream;
+
+    // Set when an engine compresses the whole input in finalize().
+    const SkDeflateEngine* fEngine;
+    int fCompressionLevel;
+    std::optional<SkDynamicMemoryWStream> fInput;
 };
 
 SkDeflateWStream::SkDeflateWStream(SkWStream* out,
                                    int compressionLevel,
-                                   bool gzip)
+                                   bool gzip,
+                                   const SkDeflateEngine* engine)
     : fImpl(std::make_unique<SkDeflateWStream::Impl>()) {
 
     // There has existed at some point at least one zlib implementation which thought it was being
@@ -85,12 +98,19 @@ SkDeflateWStream::SkDeflateWStream(SkWStream* out,
     // for the no-compression level which should always be deterministically pass-through.
     // Users should instead consider the zero compression level broken and handle it themselves.
     SkASSERT(compressionLevel != 0);
+    SkASSERT(!(gzip && engine));
 
     fImpl->fOut = out;
     fImpl->fInBufferIndex = 0;
+    fImpl->fEngine = gzip ? nullptr : engine;
+    fImpl->fCompressionLevel = compressionLevel;
     if (!fImpl->fOut) {
         return;
     }
+    if (fImpl->fEngine) {
+        fImpl->fInput.emplace();
+        return;
+    }
     fImpl->fZStream.next_in = nullptr;
     fImpl->fZStream.zalloc = &skia_alloc_func;
     fImpl->fZStream.zfree = &skia_free_func;
@@ -109,6 +129,14 @@ void SkDeflateWStream::finalize() {
     if (!fImpl->fOut) {
         return;
     }
+    if (fImpl->fInput) {
+        sk_sp<SkData> input = fImpl->fInput->detachAsData();
+        fImpl->fEngine->compress(input->data(), input->size(), fImpl->fCompressionLevel,
+                                 fImpl->fOut);
+        fImpl->fInput.reset();
+        fImpl->fOut = nullptr;
+        return;
+    }
     do_deflate(Z_FINISH, &fImpl->fZStream, fImpl->fOut, fImpl->fInBuffer,
                fImpl->fInBufferIndex);
     (void)deflateEnd(&fImpl->fZStream);
@@ -120,6 +148,9 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
     if (!fImpl->fOut) {
         return false;
     }
+    if (fImpl->fInput) {
+        return fImpl->fInput->write(void_buffer, len);
+    }
     const char* buffer = (const char*)void_buffer;
     while (len > 0) {
         size_t tocopy =
@@ -141,5 +172,97 @@ bool SkDeflateWStream::write(const void* void_buffer, size_t len) {
 }
 
 size_t SkDeflateWStream::bytesWritten() const {
+    if (fImpl->fEngine) {
+        return fImpl->fInput ? fImpl->fInput->bytesWritten() : 0;
+    }
     return fImpl->fZStream.total_in + fImpl->fInBufferIndex;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+constexpr size_t kParallelChunkSize = 128 * 1024;
+
+// Shared with the helper tasks, which may outlive compress() if they start after every chunk
+// has been claimed; they only read fData after claiming a chunk.
+struct ParallelDeflate {
+    const uint8_t* fData;
+    size_t fLength;
+    int fCompressionLevel;
+    int fChunkCount;
+    std::atomic<int> fNextChunk{0};
+    std::vector<SkZlibChunks::Chunk> fChunks;
+    SkSemaphore fChunksDone;
+
+    // Returns false once every chunk has been claimed.
+    bool compressNextChunk() {
+        int index = fNextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (index >= fChunkCount) {
+            return false;
+        }
+        size_t start = index * kParallelChunkSize;
+        size_t length = std::min(kParallelChunkSize, fLength - start);
+        bool last = index == fChunkCount - 1;
+        SkDEBUGCODE(bool ok =) SkZlibChunks::Deflate(fData + start, length, fData, start,
+                                                     fCompressionLevel, Z_DEFAULT_STRATEGY,
+                                                     last, &fChunks[index]);
+        SkASSERT(ok);
+        fChunksDone.signal();
+        return true;
+    }
+};
+
+class ParallelEngine final : public SkDeflateEngine {
+public:
+    explicit ParallelEngine(SkExecutor* executor) : fExecutor(executor) {}
+
+    size_t compress(const void* data,
+                    size_t length,
+                    int compressionLevel,
+                    SkWStream* out) const override {
+        TRACE_EVENT0("skia", TRACE_FUNC);
+        SkASSERT(compressionLevel != 0);
+        SkASSERT(compressionLevel <= 9 && compressionLevel >= -1);
+
+        auto state = std::make_shared<ParallelDeflate>();
+        state->fData = static_cast<const uint8_t*>(data);
+        state->fLength = length;
+        state->fCompressionLevel = compressionLevel;
+        state->fChunkCount = std::max(1, SkToInt((length + kParallelChunkSize - 1) /
+                                                 kParallelChunkSize));
+        state->fChunks.resize(state->fChunkCount);
+
+        if (fExecutor) {
+            for (int i = 1; i < state->fChunkCount; ++i) {
+                fExecutor->add([state]() {
+                    while (state->compressNextChunk()) {}
+                });
+            }
+        }
+        while (state->compressNextChunk()) {}
+        for (int i = 0; i < state->fChunkCount; ++i) {
+            state->fChunksDone.wait();
+        }
+
+        auto header = SkZlibChunks::Header(compressionLevel);
+        auto trailer = SkZlibChunks::Trailer(state->fChunks);
+        out->write(header.data(), header.size());
+        size_t written = header.size() + trailer.size();
+        for (const SkZlibChunks::Chunk& chunk : state->fChunks) {
+            out->write(chunk.fDeflated.data(), chunk.fDeflated.size());
+            written += chunk.fDeflated.size();
+        }
+        out->write(trailer.data(), trailer.size());
+        return written;
+    }
+
+private:
+    SkExecutor* fExecutor;
+};
+
+}  // namespace
+
+std::unique_ptr<SkDeflateEngine> SkDeflateEngine::MakeParallel(SkExecutor* executor) {
+    return std::make_unique<ParallelEngine>(executor);
+}
@@ -14,6 +14,36 @@
 
 #include <memory>
 
+class SkExecutor;
+
+/**
+  * Compresses a whole buffer into a zlib stream (RFC 1950). Engines trade
+  * memory for speed: unlike SkDeflateWStream's own zlib path they need all of
+  * the input at once. compress() may be called from several threads at once.
+  */
+class SkDeflateEngine {
+public:
+    virtual ~SkDeflateEngine() = default;
+
+    /** Write the compressed data to out.
+
+        @param compressionLevel as for SkDeflateWStream, but not 0.
+        @return the number of compressed bytes written.
+     */
+    virtual size_t compress(const void* data,
+                            size_t length,
+                            int compressionLevel,
+                            SkWStream* out) const = 0;
+
+    /** Cuts the data into fixed-size chunks that are deflated independently,
+        each primed with the 32KB of data before it, and stitches them into a
+        single stream. Chunks are compressed on the executor (which may be
+        nullptr) and on the calling thread, so this may be called from a task
+        running on the same executor. The output does not depend on the
+        executor. */
+    static std::unique_ptr<SkDeflateEngine> MakeParallel(SkExecutor*);
+};
+
 /**
   * Wrap a stream in this class to compress the information written to
   * this stream using the Deflate algorithm.
@@ -32,10 +62,14 @@ public:
         a wrapper, documented in RFC 1952, around a deflate stream."
         gzip adds a header with a magic number to the beginning of the
         stream, allowing a client to identify a gzip file.
+
+        @param engine if not nullptr, the input is collected and compressed
+        by the engine in finalize(). Engines do not write gzip files.
      */
     SkDeflateWStream(SkWStream*,
                      int compressionLevel,
-                     bool gzip = false);
+                     bool gzip = false,
+                     const SkDeflateEngine* engine = nullptr);
 
     /** The destructor calls finalize(). */
     ~SkDeflateWStream() override;
@@ -91,6 +91,45 @@ SkColor get_neighbor_avg_color(const SkPixmap& bm, int xOrig, int yOrig) {
 
 enum class SkPDFStreamFormat { DCT, Flate, Uncompressed };
 
+// Images with at least this many bytes of samples are deflated in parallel chunks when the
+// document has an executor, whichever deflater it uses for other streams.
+constexpr size_t kParallelDeflateMinBytes = 1 << 20;
+
+// Where the samples of an image stream are written.
+class ImageSampleStream {
+public:
+    ImageSampleStream(SkPDFDocument* doc, SkWStream* out, size_t sampleBytes) : fStream(out) {
+        SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
+        if (compressionLevel == SkPDF::Metadata::CompressionLevel::None) {
+            fFormat = SkPDFStreamFormat::Uncompressed;
+            return;
+        }
+        fFormat = SkPDFStreamFormat::Flate;
+        const SkDeflateEngine* engine = doc->deflateEngine();
+        if (doc->executor() && sampleBytes >= kParallelDeflateMinBytes) {
+            fParallelEngine = SkDeflateEngine::MakeParallel(doc->executor());
+            engine = fParallelEngine.get();
+        }
+        fDeflate.emplace(out, SkToInt(compressionLevel), false, engine);
+        fStream = &*fDeflate;
+    }
+
+    SkWStream* stream() const { return fStream; }
+    SkPDFStreamFormat format() const { return fFormat; }
+
+    void finalize() {
+        if (fDeflate) {
+            fDeflate->finalize();
+        }
+    }
+
+private:
+    SkWStream* fStream;
+    SkPDFStreamFormat fFormat;
+    std::unique_ptr<SkDeflateEngine> fParallelEngine;
+    std::optional<SkDeflateWStream> fDeflate;
+};
+
 template <typename T>
 void emit_image_stream(SkPDFDocument* doc,
                        SkPDFIndirectReference ref,
@@ -99,7 +138,9 @@ void emit_image_stream(SkPDFDocument* doc,
                        SkPDFUnion&& colorSpace,
                        SkPDFIndirectReference sMask,
                        size_t length,
-                       SkPDFStreamFormat format) {
+                       SkPDFStreamFormat format,
+                       int colorTransform = 0,
+                       bool invertedCMYK = false) {
     if (!ref) {
         return;
     }
@@ -118,24 +159,25 @@ void emit_image_stream(SkPDFDocument* doc,
         case SkPDFStreamFormat::Uncompressed: break;
     }
     if (format == SkPDFStreamFormat::DCT) {
-        pdfDict.insertInt("ColorTransform", 0);
+        pdfDict.insertInt("ColorTransform", colorTransform);
+    }
+    if (invertedCMYK) {
+        // Adobe writes CMYK JPEGs with 0 meaning full ink coverage.
+        std::unique_ptr<SkPDFArray> decode = SkPDFMakeArray();
+        for (int i = 0; i < 4; ++i) {
+            decode->appendInt(1);
+            decode->appendInt(0);
+        }
+        pdfDict.insertObject("Decode", std::move(decode));
     }
     pdfDict.insertInt("Length", length);
     doc->emitStream(pdfDict, std::move(writeStream), ref);
 }
 
 size_t do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectReference ref) {
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
-    SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
-                             ? SkPDFStreamFormat::Uncompressed
-                             : SkPDFStreamFormat::Flate;
     SkDynamicMemoryWStream buffer;
-    SkWStream* stream = &buffer;
-    std::optional<SkDeflateWStream> deflateWStream;
-    if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(&buffer, SkToInt(compressionLevel));
-        stream = &*deflateWStream;
-    }
+    ImageSampleStream samples(doc, &buffer, (size_t)pm.width() * pm.height());
+    SkWStream* stream = samples.stream();
     if (kAlpha_8_SkColorType == pm.colorType()) {
         SkASSERT(pm.rowBytes() == (size_t)pm.width());
         stream->write(pm.addr8(), pm.width() * pm.height());
@@ -158,14 +200,12 @@ size_t do_deflated_alpha(const SkPixmap& pm, SkPDFDocument* doc, SkPDFIndirectRe
         }
         stream->write(byteBuffer, dst - byteBuffer);
     }
-    if (deflateWStream) {
-        deflateWStream->finalize();
-    }
+    samples.finalize();
 
     size_t length = SkToInt(buffer.bytesWritten());
     emit_image_stream(doc, ref, [&buffer](SkWStream* stream) { buffer.writeToAndReset(stream); },
                       pm.info().dimensions(), SkPDFUnion::Name("DeviceGray"),
-                      SkPDFIndirectReference(), length, format);
+                      SkPDFIndirectReference(), length, samples.format());
     return length;
 }
 
@@ -204,19 +244,13 @@ size_t do_deflated_image(const SkPixmap& pm,
                          SkPDFDocument* doc,
                          bool isOpaque,
                          SkPDFIndirectReference ref) {
-    SkPDF::Metadata::CompressionLevel compressionLevel = doc->metadata().fCompressionLevel;
-    SkPDFStreamFormat format = compressionLevel == SkPDF::Metadata::CompressionLevel::None
-                             ? SkPDFStreamFormat::Uncompressed
-                             : SkPDFStreamFormat::Flate;
     SkDynamicMemoryWStream dynamic;
     SkNullWStream writeOnly;
     SkWStream* buffer = ref ? static_cast<SkWStream*>(&dynamic) : &writeOnly;
-    SkWStream* stream = buffer;
-    std::optional<SkDeflateWStream> deflateWStream;
-    if (format == SkPDFStreamFormat::Flate) {
-        deflateWStream.emplace(buffer, SkToInt(compressionLevel));
-        stream = &*deflateWStream;
-    }
+    int sampleChannels = pm.colorType() == kAlpha_8_SkColorType ||
+                         pm.colorType() == kGray_8_SkColorType ? 1 : 3;
+    ImageSampleStream samples(doc, buffer, (size_t)pm.width() * pm.height() * sampleChannels);
+    SkWStream* stream = samples.stream();
     SkPDFUnion colorSpace = SkPDFUnion::Name("DeviceGray");
     int channels;
     switch (pm.colorType()) {
@@ -258,9 +292,7 @@ size_t do_deflated_image(const SkPixmap& pm,
             }
             stream->write(byteBuffer, dst - byteBuffer);
     }
-    if (deflateWStream) {
-        deflateWStream->finalize();
-    }
+    samples.finalize();
 
     if (pm.colorSpace()) {
         skcms_ICCProfile iccProfile;
@@ -277,7 +309,8 @@ size_t do_deflated_image(const SkPixmap& pm,
         sMask = doc->reserveRef();
     }
     emit_image_stream(doc, ref, [&dynamic](SkWStream* stream) { dynamic.writeToAndReset(stream); },
-                      pm.info().dimensions(), std::move(colorSpace), sMask, length, format);
+                      pm.info().dimensions(), std::move(colorSpace), sMask, length,
+                      samples.format());
     if (!isOpaque) {
         length += do_deflated_alpha(pm, doc, sMask);
     }
@@ -305,15 +338,20 @@ size_t do_jpeg(sk_sp<SkData> data, SkColorSpace* imageColorSpace, SkPDFDocument*
     SkEncodedOrigin exifOrientation = codec->getOrigin();
 
     bool yuv = jpegColorType == SkEncodedInfo::kYUV_Color;
-    bool goodColorType = yuv || jpegColorType == SkEncodedInfo::kGray_Color;
+    bool ycck = jpegColorType == SkEncodedInfo::kYCCK_Color;
+    // The DCTDecode filter handles CMYK data, so it is embedded as is rather than decoded.
+    bool cmyk = ycck || jpegColorType == SkEncodedInfo::kInvertedCMYK_Color;
+    bool goodColorType = yuv || cmyk || jpegColorType == SkEncodedInfo::kGray_Color;
     if (jpegSize != size  // Safety check.
             || !goodColorType
             || kTopLeft_SkEncodedOrigin != exifOrientation) {
         return 0;
     }
 
-    int channels = yuv ? 3 : 1;
-    SkPDFUnion colorSpace = yuv ? SkPDFUnion::Name("DeviceRGB") : SkPDFUnion::Name("DeviceGray");
+    int channels = cmyk ? 4 : yuv ? 3 : 1;
+    SkPDFUnion colorSpace = cmyk ? SkPDFUnion::Name("DeviceCMYK")
+                          : yuv  ? SkPDFUnion::Name("DeviceRGB")
+                                 : SkPDFUnion::Name("DeviceGray");
 
     if (sk_sp<SkData> encodedIccProfileData = encodedInfo.profileData();
         encodedIccProfileData && !icc_channel_mismatch(encodedInfo.profile(), channels))
@@ -336,7 +374,8 @@ size_t do_jpeg(sk_sp<SkData> data, SkColorSpace* imageColorSpace, SkPDFDocument*
     emit_image_stream(doc, ref,
                       [&data](SkWStream* dst) { dst->write(data->data(), data->size()); },
                       jpegSize, std::move(colorSpace),
-                      SkPDFIndirectReference(), SkToInt(data->size()), SkPDFStreamFormat::DCT);
+                      SkPDFIndirectReference(), SkToInt(data->size()), SkPDFStreamFormat::DCT,
+                      ycck ? 1 : 0, cmyk);
     return data->size();
 }
 
@@ -397,6 +436,35 @@ size_t serialize_image(const SkImage* img,
 
 } // namespace
 
+SkPDFImageContentKey SkPDFMakeImageContentKey(const SkImage* img) {
+    // Raster pixels are copied into the key. Larger images are still written once per SkImage
+    // through fPDFBitmapMap; they just aren't matched against other SkImages.
+    static constexpr size_t kMaxCopiedPixelBytes = 256 * 1024;
+
+    SkPDFImageContentKey key;
+    if (!img) {
+        return key;
+    }
+    key.fInfo = img->imageInfo();
+    if (sk_sp<SkData> encoded = img->refEncodedData()) {
+        key.fData = std::move(encoded);
+        key.fEncoded = true;
+    } else if (SkPixmap pm; img->peekPixels(&pm) && pm.rowBytes() == pm.info().minRowBytes() &&
+                            pm.computeByteSize() <= kMaxCopiedPixelBytes) {
+        key.fData = SkData::MakeWithCopy(pm.addr(), pm.computeByteSize());
+    } else {
+        return key;
+    }
+    const int32_t header[] = {key.fInfo.width(),
+                              key.fInfo.height(),
+                              key.fInfo.colorType(),
+                              key.fInfo.alphaType(),
+                              key.fEncoded};
+    key.fHash = SkChecksum::Hash32(key.fData->data(), key.fData->size(),
+                                   SkChecksum::Hash32(header, sizeof(header)));
+    return key;
+}
+
 size_t SkPDFSerializeImageSize(const SkImage* img, SkPDFDocument* doc, int encodingQuality) {
     return serialize_image(img, encodingQuality, doc, SkPDFIndirectReference());
 }
@@ -7,7 +7,9 @@
 #ifndef SkPDFBitmap_DEFINED
 #define SkPDFBitmap_DEFINED
 
+#include "include/core/SkColorSpace.h"
 #include "include/core/SkData.h"
+#include "include/core/SkImageInfo.h"
 #include "include/core/SkRefCnt.h"
 #include "src/core/SkChecksum.h"
 
@@ -42,4 +44,38 @@ struct SkPDFIccProfileKey {
     };
 };
 
+/**
+ *  Identifies an image by its contents rather than by its SkImage, so that the same picture
+ *  decoded twice, or drawn from two SkImages, is written as one Image XObject.
+ *  fData holds the encoded image if there is one, otherwise a copy of the raster pixels; it never
+ *  keeps the SkImage itself alive.
+ */
+struct SkPDFImageContentKey {
+    sk_sp<SkData> fData;
+    SkImageInfo fInfo;
+    bool fEncoded = false;
+    uint32_t fHash = 0;
+
+    bool operator==(const SkPDFImageContentKey& that) const {
+        return fHash == that.fHash && fEncoded == that.fEncoded &&
+               fInfo.dimensions() == that.fInfo.dimensions() &&
+               fInfo.colorType() == that.fInfo.colorType() &&
+               fInfo.alphaType() == that.fInfo.alphaType() &&
+               SkColorSpace::Equals(fInfo.colorSpace(), that.fInfo.colorSpace()) &&
+               fData->equals(that.fData.get());
+    }
+    bool operator!=(const SkPDFImageContentKey& rhs) const { return !(*this == rhs); }
+
+    struct Hash {
+        uint32_t operator()(const SkPDFImageContentKey& k) const { return k.fHash; }
+    };
+};
+
+/**
+ *  Returns the content key of an image, or a key with no fData if the contents
+ *  can not be read without decoding or reading back the image, or if the image
+ *  is not encoded and its pixels are too large to be worth copying.
+ */
+SkPDFImageContentKey SkPDFMakeImageContentKey(const SkImage* img);
+
 #endif  // SkPDFBitmap_DEFINED
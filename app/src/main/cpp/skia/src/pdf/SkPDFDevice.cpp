@@ -1027,7 +1027,10 @@ void SkPDFDevice::internalDrawGlyphRun(
                 // there are less than 512 bytes in the UTF-16,
                 // and the mapping matches or can be added.
                 // UTF-16 uses at most 2x space of UTF-8; 64 code points seems enough.
-                if (!toUnicode && fontUnichar <= 0 && c.fTextByteLength < 256) {
+                // Page shards render concurrently, so they can't agree on the mapping; they
+                // fall back to ActualText instead.
+                if (!toUnicode && fontUnichar <= 0 && c.fTextByteLength < 256 &&
+                    !fDocument->isPageShard()) {
                     SkString* unicodes = glyphToUnicodeEx.find(gid);
                     if (!unicodes) {
                         glyphToUnicodeEx.set(gid, SkString(c.fUtf8Text, c.fTextByteLength));
@@ -1061,7 +1064,8 @@ void SkPDFDevice::internalDrawGlyphRun(
                     continue;
                 }
             } else {
-                if (!clipStackBounds.intersects(glyphBounds)) {
+                if (!clipStackBounds.intersects(glyphBounds) ||
+                    this->cs().quickReject(glyphBounds)) {
                     continue;  // reject glyphs as out of bounds
                 }
             }
@@ -1836,8 +1840,18 @@ void SkPDFDevice::internalDrawImageRect(SkKeyedImage imageSubset,
     SkPDFIndirectReference pdfimage = pdfimagePtr ? *pdfimagePtr : SkPDFIndirectReference();
     if (!pdfimagePtr) {
         SkASSERT(imageSubset);
-        pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
-                                       fDocument->metadata().fEncodingQuality);
+        SkPDFImageContentKey contentKey = SkPDFMakeImageContentKey(imageSubset.image().get());
+        SkPDFIndirectReference* contentPtr =
+                contentKey.fData ? fDocument->fPDFImageContentMap.find(contentKey) : nullptr;
+        if (contentPtr) {
+            pdfimage = *contentPtr;
+        } else {
+            pdfimage = SkPDFSerializeImage(imageSubset.image().get(), fDocument,
+                                           fDocument->metadata().fEncodingQuality);
+            if (contentKey.fData) {
+                fDocument->addImageContent(std::move(contentKey), pdfimage);
+            }
+        }
         SkASSERT((key != SkBitmapKey{{0, 0, 0, 0}, 0}));
         fDocument->fPDFBitmapMap.set(key, pdfimage);
     }
@@ -9,8 +9,10 @@
 
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
+#include "include/core/SkExecutor.h"
 #include "include/core/SkImageInfo.h"
 #include "include/core/SkMatrix.h"
+#include "include/core/SkPicture.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkSize.h"
 #include "include/core/SkStream.h"
@@ -27,6 +29,7 @@
 #include "src/core/SkAdvancedTypefaceMetrics.h"
 #include "src/core/SkTHash.h"
 #include "src/pdf/SkBitmapKey.h"
+#include "src/pdf/SkDeflate.h"
 #include "src/pdf/SkPDFBitmap.h"
 #include "src/pdf/SkPDFDevice.h"
 #include "src/pdf/SkPDFDocumentPriv.h"
@@ -43,6 +46,7 @@
 #include <algorithm>
 #include <atomic>
 #include <cstddef>
+#include <cstring>
 #include <new>
 #include <utility>
 
@@ -50,6 +54,8 @@
 #include "include/docs/SkPDFJpegHelpers.h"
 #endif
 
+using namespace skia_private;
+
 // For use in SkCanvas::drawAnnotation
 const char* SkPDFGetElemIdKey() {
     static constexpr char key[] = "PDF_Node_Key";
@@ -233,6 +239,30 @@ static void reset_object(T* dst, Args&&... args) {
     new (dst) T(std::forward<Args>(args)...);
 }
 
+// A recorded page, rendered by its own page shard on the executor.
+struct SkPDFDocument::PendingPage {
+    sk_sp<SkPDFDocument> fShard;
+    sk_sp<SkPicture> fPicture;
+    SkSize fSize;
+    size_t fPageIndex;
+    // Set by the shard, before signaling fRendered.
+    std::unique_ptr<SkPDFDict> fPage;
+    SkSemaphore fRendered;
+};
+
+// Rendered pages hold all of their objects in memory until the pages before them are written.
+static constexpr size_t kMaxPendingPages = 16;
+
+static std::unique_ptr<SkDeflateEngine> make_deflate_engine(const SkPDF::Metadata& metadata) {
+    switch (metadata.fDeflater) {
+        case SkPDF::Metadata::kZlib_Deflater:
+            return nullptr;
+        case SkPDF::Metadata::kParallel_Deflater:
+            return SkDeflateEngine::MakeParallel(metadata.fExecutor);
+    }
+    SkUNREACHABLE;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 SkPDFDocument::SkPDFDocument(SkWStream* stream, SkPDF::Metadata metadata)
@@ -241,9 +271,27 @@ SkPDFDocument::SkPDFDocument(SkWStream* stream, SkPDF::Metadata metadata)
     , fRasterScale(fMetadata.fRasterDPI / SK_ScalarDefaultRasterDPI)
     , fInverseRasterScale(SK_ScalarDefaultRasterDPI / fMetadata.fRasterDPI)
     , fExecutor(fMetadata.fExecutor)
+    , fDeflateEngine(make_deflate_engine(fMetadata))
     , fStructTree(fMetadata.fStructureElementTreeRoot, fMetadata.fOutline)
+    , fConcurrentPages(fMetadata.fConcurrentPageRendering && fExecutor &&
+                       !fMetadata.fStructureElementTreeRoot)
 {}
 
+static SkPDF::Metadata page_shard_metadata(const SkPDF::Metadata& metadata) {
+    SkPDF::Metadata shardMetadata = metadata;
+    // A shard already runs on the executor, and tagged documents are never sharded.
+    shardMetadata.fExecutor = nullptr;
+    shardMetadata.fStructureElementTreeRoot = nullptr;
+    shardMetadata.fConcurrentPageRendering = false;
+    return shardMetadata;
+}
+
+SkPDFDocument::SkPDFDocument(SkPDFDocument* parent)
+    : SkPDFDocument(nullptr, page_shard_metadata(parent->fMetadata))
+{
+    fParent = parent;
+}
+
 SkPDFDocument::~SkPDFDocument() {
     // subclasses of SkDocument must call close() in their destructors.
     this->close();
@@ -257,11 +305,23 @@ SkPDFIndirectReference SkPDFDocument::emit(const SkPDFObject& object, SkPDFIndir
 }
 
 SkWStream* SkPDFDocument::beginObject(SkPDFIndirectReference ref) SK_REQUIRES(fMutex) {
+    if (fParent) {
+        // The parent renumbers the object when it writes the page, see commitPage().
+        SkASSERT(!fDeferredRefRecorder && fDeferredStream.bytesWritten() == 0);
+        fDeferredObjects.push_back(SkPDFDeferredObject{ref, nullptr, {}});
+        fDeferredRefRecorder.emplace(&fDeferredStream, &fDeferredObjects.back().fRefs);
+        return &fDeferredStream;
+    }
     begin_indirect_object(&fOffsetMap, ref, this->getStream());
     return this->getStream();
 }
 
 void SkPDFDocument::endObject() SK_REQUIRES(fMutex) {
+    if (fParent) {
+        fDeferredRefRecorder.reset();
+        fDeferredObjects.back().fData = fDeferredStream.detachAsData();
+        return;
+    }
     end_indirect_object(this->getStream());
 }
 
@@ -270,7 +330,7 @@ static SkSize operator*(SkSize u, SkScalar s) { return SkSize{u.width() * s, u.h
 
 SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
-    if (fPages.empty()) {
+    if (fPages.empty() && fPendingPages.empty()) {
         // if this is the first page if the document.
         {
             SkAutoMutexExclusive autoMutexAcquire(fMutex);
@@ -289,6 +349,18 @@ SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
             fXMP = SkPDFMetadata::MakeXMPObject(fMetadata, fUUID, fUUID, this);
         }
     }
+    if (fConcurrentPages) {
+        // The recorded page is rendered on the executor in onEndPage().
+        fRecordedPageSize = SkSize{width, height};
+        return fPageRecorder.beginRecording(width, height);
+    }
+    this->startPage(width, height);
+    reset_object(&fCanvas, fPageDevice);
+    fCanvas.scale(fRasterScale, fRasterScale);
+    return &fCanvas;
+}
+
+void SkPDFDocument::startPage(SkScalar width, SkScalar height) {
     // By scaling the page at the device level, we will create bitmap layer
     // devices at the rasterized scale, not the 72dpi scale.  Bitmap layer
     // devices are created when saveLayer is called with an ImageFilter;  see
@@ -300,10 +372,7 @@ SkCanvas* SkPDFDocument::onBeginPage(SkScalar width, SkScalar height) {
     initialTransform.setScaleTranslate(fInverseRasterScale, -fInverseRasterScale,
                                        0, fInverseRasterScale * pageSize.height());
     fPageDevice = sk_make_sp<SkPDFDevice>(pageSize, this, initialTransform);
-    reset_object(&fCanvas, fPageDevice);
-    fCanvas.scale(fRasterScale, fRasterScale);
     fPageRefs.push_back(this->reserveRef());
-    return &fCanvas;
 }
 
 static void populate_link_annotation(SkPDFDict* annotation, const SkRect& r) {
@@ -372,8 +441,25 @@ std::unique_ptr<SkPDFArray> SkPDFDocument::getAnnotations() {
 }
 
 void SkPDFDocument::onEndPage() {
+    if (fConcurrentPages) {
+        auto page = std::make_unique<PendingPage>();
+        page->fShard = sk_sp<SkPDFDocument>(new SkPDFDocument(this));
+        page->fPicture = fPageRecorder.finishRecordingAsPicture();
+        page->fSize = fRecordedPageSize;
+        page->fPageIndex = fPages.size() + fPendingPages.size();
+        PendingPage* pagePtr = page.get();
+        fPendingPages.push_back(std::move(page));
+        fExecutor->add([pagePtr]() { pagePtr->fShard->renderPageShard(pagePtr); });
+        this->commitPendingPages(kMaxPendingPages);
+        return;
+    }
     SkASSERT(!fCanvas.imageInfo().dimensions().isZero());
     reset_object(&fCanvas);
+    fPages.emplace_back(this->finishPage(this->currentPageIndex()));
+    this->checkpointFonts();
+}
+
+std::unique_ptr<SkPDFDict> SkPDFDocument::finishPage(size_t pageIndex) {
     SkASSERT(fPageDevice);
 
     auto page = SkPDFMakeDict("Page");
@@ -394,16 +480,21 @@ void SkPDFDocument::onEndPage() {
     page->insertRef("Contents", SkPDFStreamOut(nullptr, std::move(pageContent), this));
     // The StructParents unique identifier for each page is just its
     // 0-based page index.
-    page->insertInt("StructParents", SkToInt(this->currentPageIndex()));
+    page->insertInt("StructParents", SkToInt(pageIndex));
 
     // Tabs is PDF 1.5, but setting it checks an accessibility box.
     page->insertName("Tabs", "S");
 
-    fPages.emplace_back(std::move(page));
     fPageDevice = nullptr;
+    return page;
 }
 
 void SkPDFDocument::onAbort() {
+    // Page shards may still be rendering on the executor.
+    for (const std::unique_ptr<PendingPage>& page : fPendingPages) {
+        page->fRendered.wait();
+    }
+    fPendingPages.clear();
     this->waitForJobs();
 }
 
@@ -556,6 +647,19 @@ const SkMatrix& SkPDFDocument::currentPageTransform() const {
     return fPageDevice->initialTransform();
 }
 
+void SkPDFDocument::addImageContent(SkPDFImageContentKey key, SkPDFIndirectReference ref) {
+    // Keys hold their bytes until the document is closed, even after the SkImages that they came
+    // from are gone, so the total is bounded.
+    static constexpr size_t kMaxImageContentBytes = 32 * 1024 * 1024;
+    SkASSERT(key.fData);
+    const size_t size = key.fData->size();
+    if (size > kMaxImageContentBytes - fPDFImageContentBytes) {
+        return;
+    }
+    fPDFImageContentBytes += size;
+    fPDFImageContentMap.set(std::move(key), ref);
+}
+
 SkPDFStructTree::Mark SkPDFDocument::createMarkForElemId(int elemId) {
     // If the mark isn't on a page (like when emitting a Type3 glyph)
     // return a temporary mark not attached to the page or a structure element.
@@ -593,6 +697,18 @@ static std::vector<const SkPDFFont*> get_fonts(const SkPDFDocument& canon) {
     return fonts;
 }
 
+void SkPDFDocument::checkpointFonts() {
+    int checkpointPages = fMetadata.fFontSubsetCheckpointPages;
+    if (checkpointPages <= 0 || fPages.size() % SkToSizeT(checkpointPages) != 0) {
+        return;
+    }
+    for (const SkPDFFont* f : get_fonts(*this)) {
+        f->emitSubset(this);
+    }
+    // Glyphs drawn on later pages go into new fonts, with new references.
+    fStrikes.foreach([](sk_sp<SkPDFStrike>* strike) { (*strike)->fFontMap.reset(); });
+}
+
 SkString SkPDFDocument::nextFontSubsetTag() {
     // PDF 32000-1:2008 Section 9.6.4 FontSubsets "The tag shall consist of six uppercase letters"
     // "followed by a plus sign" "different subsets in the same PDF file shall have different tags."
@@ -612,6 +728,7 @@ SkString SkPDFDocument::nextFontSubsetTag() {
 
 void SkPDFDocument::onClose(SkWStream* stream) {
     SkASSERT(fCanvas.imageInfo().dimensions().isZero());
+    this->commitPendingPages(0);
     if (fPages.empty()) {
         this->waitForJobs();
         return;
@@ -685,6 +802,217 @@ void SkPDFDocument::waitForJobs() {
      }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+// Maps the object numbers of a page shard to the object numbers of its parent.
+using RefMap = THashMap<int, SkPDFIndirectReference>;
+
+// The shard's canonical objects that the document already has are replaced by the document's.
+template <typename Map>
+static void alias_canonical_objects(const Map& shardMap, const Map& docMap, RefMap* refs) {
+    shardMap.foreach([&](const auto& key, const SkPDFIndirectReference& ref) {
+        if (const SkPDFIndirectReference* existing = docMap.find(key)) {
+            refs->set(ref.fValue, *existing);
+        }
+    });
+}
+
+static void alias_canonical_object(SkPDFIndirectReference shardRef,
+                                   SkPDFIndirectReference docRef,
+                                   RefMap* refs) {
+    if (shardRef && docRef) {
+        refs->set(shardRef.fValue, docRef);
+    }
+}
+
+// The remaining ones that are written with the page become canonical in the document.
+template <typename Map, typename CopyKey>
+static void adopt_canonical_objects(const Map& shardMap,
+                                    Map* docMap,
+                                    const RefMap& refs,
+                                    CopyKey copyKey) {
+    shardMap.foreach([&](const auto& key, const SkPDFIndirectReference& ref) {
+        const SkPDFIndirectReference* adopted = refs.find(ref.fValue);
+        if (adopted && !docMap->find(key)) {
+            docMap->set(copyKey(key), *adopted);
+        }
+    });
+}
+
+template <typename Map>
+static void adopt_canonical_objects(const Map& shardMap, Map* docMap, const RefMap& refs) {
+    adopt_canonical_objects(shardMap, docMap, refs, [](const auto& key) { return key; });
+}
+
+static void adopt_canonical_object(SkPDFIndirectReference shardRef,
+                                   SkPDFIndirectReference* docRef,
+                                   const RefMap& refs) {
+    if (shardRef && !*docRef) {
+        if (const SkPDFIndirectReference* adopted = refs.find(shardRef.fValue)) {
+            *docRef = *adopted;
+        }
+    }
+}
+
+static size_t ref_text_length(SkPDFIndirectReference ref) {
+    size_t length = strlen("0 0 R");
+    for (int value = ref.fValue; value >= 10; value /= 10) {
+        length++;
+    }
+    return length;
+}
+
+static void write_deferred_object(const SkPDFDeferredObject& object,
+                                  const RefMap& refs,
+                                  SkWStream* stream) {
+    const char* data = static_cast<const char*>(object.fData->data());
+    size_t written = 0;
+    for (const SkPDFAutoRecordRefs::Ref& ref : object.fRefs) {
+        SkASSERT(ref.fOffset >= written);
+        stream->write(data + written, ref.fOffset - written);
+        if (const SkPDFIndirectReference* mapped = refs.find(ref.fRef.fValue)) {
+            stream->writeDecAsText(mapped->fValue);
+            stream->writeText(" 0 R");
+        } else {
+            SkDEBUGFAIL("Page shard refers to an object it never wrote.");
+            stream->writeText("null");
+        }
+        written = ref.fOffset + ref_text_length(ref.fRef);
+    }
+    SkASSERT(written <= object.fData->size());
+    stream->write(data + written, object.fData->size() - written);
+}
+
+void SkPDFDocument::renderPageShard(PendingPage* page) {
+    SkASSERT(this->isPageShard());
+    this->startPage(page->fSize.width(), page->fSize.height());
+    {
+        SkCanvas canvas(fPageDevice);
+        canvas.scale(fRasterScale, fRasterScale);
+        page->fPicture->playback(&canvas);
+    }
+    page->fPage = this->finishPage(page->fPageIndex);
+    page->fPicture = nullptr;
+    page->fRendered.signal();
+}
+
+void SkPDFDocument::commitPendingPages(size_t maxPendingPages) {
+    // Pages are written in order, so a page that is done waits for the pages before it.
+    while (!fPendingPages.empty()) {
+        PendingPage* page = fPendingPages.front().get();
+        if (fPendingPages.size() > maxPendingPages) {
+            page->fRendered.wait();
+        } else if (!page->fRendered.try_wait()) {
+            break;
+        }
+        this->commitPage(page);
+        fPendingPages.pop_front();
+    }
+}
+
+void SkPDFDocument::commitPage(PendingPage* pendingPage) {
+    SkPDFDocument* shard = pendingPage->fShard.get();
+    std::unique_ptr<SkPDFDict> page = std::move(pendingPage->fPage);
+    SkASSERT(page && shard->fPageRefs.size() == 1);
+
+    // Every number is assigned here, on the calling thread and in page order, so the
+    // output does not depend on how the pages were scheduled.
+    RefMap refs;
+    SkPDFIndirectReference pageRef = this->reserveRef();
+    refs.set(shard->fPageRefs.front().fValue, pageRef);
+
+    // Fonts are written when the document is closed; only the glyphs they use are merged now.
+    for (const SkPDFFont* font : get_fonts(*shard)) {
+        sk_sp<SkPDFStrike> strike = SkPDFStrike::Adopt(this, font->strike());
+        refs.set(font->indirectReference().fValue, strike->mergeFont(*font)->indirectReference());
+    }
+
+    alias_canonical_objects(shard->fImageShaderMap, fImageShaderMap, &refs);
+    alias_canonical_objects(shard->fGradientPatternMap, fGradientPatternMap, &refs);
+    alias_canonical_objects(shard->fPDFBitmapMap, fPDFBitmapMap, &refs);
+    alias_canonical_objects(shard->fICCProfileMap, fICCProfileMap, &refs);
+    alias_canonical_objects(shard->fPDFImageContentMap, fPDFImageContentMap, &refs);
+    alias_canonical_objects(shard->fStrokeGSMap, fStrokeGSMap, &refs);
+    alias_canonical_objects(shard->fFillGSMap, fFillGSMap, &refs);
+    alias_canonical_object(shard->fInvertFunction, fInvertFunction, &refs);
+    alias_canonical_object(shard->fNoSmaskGraphicState, fNoSmaskGraphicState, &refs);
+
+    // Find the objects that the page still refers to.
+    THashMap<int, const SkPDFDeferredObject*> deferredObjects;
+    for (const SkPDFDeferredObject& object : shard->fDeferredObjects) {
+        deferredObjects.set(object.fRef.fValue, &object);
+    }
+    std::vector<SkPDFIndirectReference> pending;
+    page->remapRefs([&pending](SkPDFIndirectReference ref) {
+        pending.push_back(ref);
+        return ref;
+    });
+    std::vector<const SkPDFDeferredObject*> objects;
+    THashSet<int> visited;
+    while (!pending.empty()) {
+        SkPDFIndirectReference ref = pending.back();
+        pending.pop_back();
+        if (refs.find(ref.fValue) || visited.contains(ref.fValue)) {
+            continue;
+        }
+        visited.add(ref.fValue);
+        if (const SkPDFDeferredObject* const* object = deferredObjects.find(ref.fValue)) {
+            objects.push_back(*object);
+            for (const SkPDFAutoRecordRefs::Ref& child : (*object)->fRefs) {
+                pending.push_back(child.fRef);
+            }
+        }
+    }
+    std::sort(objects.begin(), objects.end(),
+              [](const SkPDFDeferredObject* u, const SkPDFDeferredObject* v) {
+                  return u->fRef.fValue < v->fRef.fValue;
+              });
+    for (const SkPDFDeferredObject* object : objects) {
+        refs.set(object->fRef.fValue, this->reserveRef());
+    }
+
+    adopt_canonical_objects(shard->fImageShaderMap, &fImageShaderMap, refs);
+    adopt_canonical_objects(shard->fGradientPatternMap, &fGradientPatternMap, refs,
+                            SkPDFGradientShader::CloneKey);
+    adopt_canonical_objects(shard->fPDFBitmapMap, &fPDFBitmapMap, refs);
+    adopt_canonical_objects(shard->fICCProfileMap, &fICCProfileMap, refs);
+    shard->fPDFImageContentMap.foreach([&](const SkPDFImageContentKey& key,
+                                           const SkPDFIndirectReference& ref) {
+        const SkPDFIndirectReference* adopted = refs.find(ref.fValue);
+        if (adopted && !fPDFImageContentMap.find(key)) {
+            this->addImageContent(key, *adopted);
+        }
+    });
+    adopt_canonical_objects(shard->fStrokeGSMap, &fStrokeGSMap, refs);
+    adopt_canonical_objects(shard->fFillGSMap, &fFillGSMap, refs);
+    adopt_canonical_object(shard->fInvertFunction, &fInvertFunction, refs);
+    adopt_canonical_object(shard->fNoSmaskGraphicState, &fNoSmaskGraphicState, refs);
+
+    {
+        SkAutoMutexExclusive lock(fMutex);
+        for (const SkPDFDeferredObject* object : objects) {
+            SkWStream* stream = this->beginObject(*refs.find(object->fRef.fValue));
+            write_deferred_object(*object, refs, stream);
+            this->endObject();
+        }
+    }
+
+    page->remapRefs([&refs](SkPDFIndirectReference ref) {
+        const SkPDFIndirectReference* mapped = refs.find(ref.fValue);
+        SkASSERT(mapped);
+        return mapped ? *mapped : SkPDFIndirectReference{0};
+    });
+    fPages.push_back(std::move(page));
+    fPageRefs.push_back(pageRef);
+    this->checkpointFonts();
+
+    for (SkPDFNamedDestination& dest : shard->fNamedDestinations) {
+        SkASSERT(dest.fPage == shard->fPageRefs.front());
+        dest.fPage = pageRef;
+        fNamedDestinations.push_back(std::move(dest));
+    }
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 void SkPDF::SetNodeId(SkCanvas* canvas, int elemId) {
@@ -10,10 +10,12 @@
 #include "include/core/SkCanvas.h"
 #include "include/core/SkData.h"
 #include "include/core/SkDocument.h"
+#include "include/core/SkPictureRecorder.h"
 #include "include/core/SkPoint.h"
 #include "include/core/SkRect.h"
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkSize.h"
 #include "include/core/SkSpan.h"  // IWYU pragma: keep
 #include "include/core/SkStream.h"
 #include "include/core/SkString.h"
@@ -35,15 +37,19 @@
 #include <cstddef>
 #include <cstdint>
 #include <atomic>
+#include <deque>
+#include <optional>
 #include <vector>
 #include <memory>
 
+class SkDeflateEngine;
 class SkDescriptor;
 class SkExecutor;
 class SkPDFDevice;
 struct SkAdvancedTypefaceMetrics;
 struct SkBitmapKey;
 class SkMatrix;
+class SkPicture;
 
 namespace SkPDFGradientShader {
 struct Key;
@@ -92,6 +98,15 @@ struct SkPDFLink {
 };
 
 
+// An object serialized by a page shard (see SkPDFDocument::isPageShard()), waiting to be
+// renumbered and written to the document.
+struct SkPDFDeferredObject {
+    SkPDFIndirectReference fRef;
+    sk_sp<SkData> fData;
+    std::vector<SkPDFAutoRecordRefs::Ref> fRefs;
+};
+
+
 /** Concrete implementation of SkDocument that creates PDF files. This
     class does not produced linearized or optimized PDFs; instead it
     it attempts to use a minimum amount of RAM. */
@@ -129,6 +144,10 @@ public:
 
     const SkPDF::Metadata& metadata() const { return fMetadata; }
 
+    // True if this document renders a single page for another document.
+    // See SkPDF::Metadata::fConcurrentPageRendering.
+    bool isPageShard() const { return fParent != nullptr; }
+
     SkPDFIndirectReference getPage(size_t pageIndex) const;
     bool hasCurrentPage() const { return bool(fPageDevice); }
     SkPDFIndirectReference currentPage() const {
@@ -156,6 +175,8 @@ public:
     SkString nextFontSubsetTag();
 
     SkExecutor* executor() const { return fExecutor; }
+    // Returns nullptr if streams should be deflated with SkDeflateWStream's zlib path.
+    const SkDeflateEngine* deflateEngine() const { return fDeflateEngine.get(); }
     void incrementJobCount();
     void signalJobComplete();
     size_t currentPageIndex() { return fPages.size(); }
@@ -163,6 +184,10 @@ public:
 
     const SkMatrix& currentPageTransform() const;
 
+    // Adds `key` to fPDFImageContentMap, unless the keys already there hold as many bytes as the
+    // document is willing to keep until it is closed.
+    void addImageContent(SkPDFImageContentKey key, SkPDFIndirectReference ref);
+
     // Canonicalized objects
     skia_private::THashMap<SkPDFImageShaderKey,
                            SkPDFIndirectReference,
@@ -174,12 +199,19 @@ public:
     skia_private::THashMap<SkPDFIccProfileKey,
                            SkPDFIndirectReference,
                            SkPDFIccProfileKey::Hash> fICCProfileMap;
+    skia_private::THashMap<SkPDFImageContentKey,
+                           SkPDFIndirectReference,
+                           SkPDFImageContentKey::Hash> fPDFImageContentMap;
+    size_t fPDFImageContentBytes = 0;
     skia_private::THashMap<SkTypefaceID, std::unique_ptr<SkAdvancedTypefaceMetrics>> fTypefaceMetrics;
     skia_private::THashMap<SkTypefaceID, std::vector<SkString>> fType1GlyphNames;
     skia_private::THashMap<SkTypefaceID, std::vector<SkUnichar>> fToUnicodeMap;
     skia_private::THashMap<SkTypefaceID, skia_private::THashMap<SkGlyphID, SkString>> fToUnicodeMapEx;
     skia_private::THashMap<SkTypefaceID, SkPDFIndirectReference> fFontDescriptors;
     skia_private::THashMap<SkTypefaceID, SkPDFIndirectReference> fType3FontDescriptors;
+    skia_private::THashMap<SkPDFFontSubsetKey,
+                           SkPDFIndirectReference,
+                           SkPDFFontSubsetKey::Hash> fFontSubsets;
     skia_private::THashTable<sk_sp<SkPDFStrike>, const SkDescriptor&, SkPDFStrike::Traits> fStrikes;
     skia_private::THashMap<SkPDFStrokeGraphicState,
                            SkPDFIndirectReference,
@@ -193,6 +225,8 @@ public:
     std::vector<SkPDFNamedDestination> fNamedDestinations;
 
 private:
+    struct PendingPage;
+
     SkPDFOffsetMap fOffsetMap;
     SkCanvas fCanvas;
     std::vector<std::unique_ptr<SkPDFDict>> fPages;
@@ -209,6 +243,7 @@ private:
     const SkScalar fRasterScale;
     const SkScalar fInverseRasterScale;
     SkExecutor *const fExecutor;
+    const std::unique_ptr<SkDeflateEngine> fDeflateEngine;
 
     // For tagged PDFs.
     SkPDFStructTree fStructTree;
@@ -216,9 +251,33 @@ private:
     SkMutex fMutex;
     SkSemaphore fSemaphore;
 
+    // For concurrent page rendering: pages that have been recorded but not yet
+    // written, in page order.
+    const bool fConcurrentPages;
+    SkPictureRecorder fPageRecorder;
+    SkSize fRecordedPageSize = {0, 0};
+    std::deque<std::unique_ptr<PendingPage>> fPendingPages;
+
+    // For page shards: the document the page is rendered for, and the objects
+    // serialized so far.
+    SkPDFDocument* fParent = nullptr;
+    std::vector<SkPDFDeferredObject> fDeferredObjects;
+    SkDynamicMemoryWStream fDeferredStream;
+    std::optional<SkPDFAutoRecordRefs> fDeferredRefRecorder;
+
+    explicit SkPDFDocument(SkPDFDocument* parent);
+
     void waitForJobs();
     SkWStream* beginObject(SkPDFIndirectReference);
     void endObject();
+
+    // Writes out the fonts used so far, see SkPDF::Metadata::fFontSubsetCheckpointPages.
+    void checkpointFonts();
+    void startPage(SkScalar width, SkScalar height);
+    std::unique_ptr<SkPDFDict> finishPage(size_t pageIndex);
+    void renderPageShard(PendingPage*);
+    void commitPendingPages(size_t maxPendingPages);
+    void commitPage(PendingPage*);
 };
 
 #endif  // SkPDFDocumentPriv_DEFINED
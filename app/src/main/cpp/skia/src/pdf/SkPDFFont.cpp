@@ -42,6 +42,7 @@
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkBitmaskEnum.h"
+#include "src/core/SkChecksum.h"
 #include "src/core/SkDescriptor.h"
 #include "src/core/SkDevice.h"
 #include "src/core/SkGlyph.h"
@@ -211,6 +212,17 @@ sk_sp<SkPDFStrike> SkPDFStrike::Make(SkPDFDocument* doc, const SkFont& font, con
 
 }
 
+sk_sp<SkPDFStrike> SkPDFStrike::Adopt(SkPDFDocument* doc, const SkPDFStrike& strike) {
+    SkASSERT(strike.fDoc != doc);
+    if (sk_sp<SkPDFStrike>* existing = doc->fStrikes.find(strike.fPath.fStrikeSpec.descriptor())) {
+        return *existing;
+    }
+    sk_sp<SkPDFStrike> adopted(
+            new SkPDFStrike(strike.fPath, strike.fImage, strike.fHasMaskFilter, doc));
+    doc->fStrikes.set(adopted);
+    return adopted;
+}
+
 SkPDFStrike::SkPDFStrike(SkPDFStrikeSpec path, SkPDFStrikeSpec image, bool hasMaskFilter,
                          SkPDFDocument* doc)
     : fPath(std::move(path))
@@ -228,6 +240,12 @@ uint32_t SkPDFStrike::Traits::Hash(const SkDescriptor& descriptor) {
     return descriptor.getChecksum();
 }
 
+uint32_t SkPDFFontSubsetKey::Hash::operator()(const SkPDFFontSubsetKey& k) const {
+    uint32_t hash = SkChecksum::Hash32(k.fGlyphs.data(), k.fGlyphs.size() * sizeof(SkGlyphID),
+                                       k.fTypefaceID);
+    return SkChecksum::Mix(hash ^ ((uint32_t)k.fType << 16 | k.fEmSize));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // class SkPDFFont
 ///////////////////////////////////////////////////////////////////////////////
@@ -394,6 +412,22 @@ SkPDFFont* SkPDFStrike::getFontResource(const SkGlyph* glyph) {
     return fFontMap.set(subsetCode, SkPDFFont(this, firstNonZeroGlyph, lastGlyph, type, ref));
 }
 
+SkPDFFont* SkPDFStrike::mergeFont(const SkPDFFont& font) {
+    // Fonts are keyed the same way as in getFontResource(), so the glyph encoding is the same
+    // even if the first glyph each document saw chose a different font type.
+    SkGlyphID subsetCode = font.multiByteGlyphs() ? 0 : font.firstGlyphID();
+    SkPDFFont* merged = fFontMap.find(subsetCode);
+    if (!merged) {
+        merged = fFontMap.set(subsetCode, SkPDFFont(this, font.firstGlyphID(), font.lastGlyphID(),
+                                                    font.getType(), fDoc->reserveRef()));
+    }
+    SkASSERT(merged->multiByteGlyphs() == font.multiByteGlyphs());
+    font.glyphUsage().getSetValues([merged](size_t gid) {
+        merged->noteGlyphUsage(SkToU16(gid));
+    });
+    return merged;
+}
+
 SkPDFFont::SkPDFFont(const SkPDFStrike* strike,
                      SkGlyphID firstGlyphID,
                      SkGlyphID lastGlyphID,
@@ -448,48 +482,64 @@ static void emit_subset_type0(const SkPDFFont& font, SkPDFDocument* doc) {
     const SkAdvancedTypefaceMetrics& metrics = *metricsPtr;
     SkASSERT(can_embed(metrics));
     SkAdvancedTypefaceMetrics::FontType type = font.getType();
-
-    auto descriptor = SkPDFMakeDict("FontDescriptor");
     uint16_t emSize = SkToU16(SkScalarRoundToInt(font.strike().fPath.fUnitsPerEM));
-    SkPDFFont::PopulateCommonFontDescriptor(descriptor.get(), metrics, emSize, 0);
-
-    int ttcIndex;
-    std::unique_ptr<SkStreamAsset> fontAsset = typeface.openStream(&ttcIndex);
-    size_t fontSize = fontAsset ? fontAsset->getLength() : 0;
-    if (0 == fontSize) {
-        SkDebugf("Error: (SkTypeface)(%p)::openStream() returned "
-                 "empty stream (%p) when identified as kType1CID_Font "
-                 "or kTrueType_Font.\n", &typeface, fontAsset.get());
-    } else if (type == SkAdvancedTypefaceMetrics::kTrueType_Font) {
-        sk_sp<SkData> subsetFontData;
-        if (can_subset(metrics)) {
-            SkASSERT(font.firstGlyphID() == 1);
-            subsetFontData = SkPDFSubsetFont(typeface, font.glyphUsage());
-        }
-        std::unique_ptr<SkStreamAsset> subsetFontAsset;
-        if (subsetFontData) {
-            subsetFontAsset = SkMemoryStream::Make(std::move(subsetFontData));
+
+    // Fonts with the same glyphs (for example, from different font checkpoints) share the
+    // descriptor and the embedded font program.
+    bool subset = type == SkAdvancedTypefaceMetrics::kTrueType_Font && can_subset(metrics);
+    SkPDFFontSubsetKey subsetKey = {typeface.uniqueID(), type, emSize, {}};
+    if (subset) {
+        font.glyphUsage().getSetValues([&subsetKey](size_t gid) {
+            subsetKey.fGlyphs.push_back(SkToU16(gid));
+        });
+    }
+    SkPDFIndirectReference descriptorRef;
+    if (SkPDFIndirectReference* shared = doc->fFontSubsets.find(subsetKey)) {
+        descriptorRef = *shared;
+    } else {
+        auto descriptor = SkPDFMakeDict("FontDescriptor");
+        SkPDFFont::PopulateCommonFontDescriptor(descriptor.get(), metrics, emSize, 0);
+
+        int ttcIndex;
+        std::unique_ptr<SkStreamAsset> fontAsset = typeface.openStream(&ttcIndex);
+        size_t fontSize = fontAsset ? fontAsset->getLength() : 0;
+        if (0 == fontSize) {
+            SkDebugf("Error: (SkTypeface)(%p)::openStream() returned "
+                     "empty stream (%p) when identified as kType1CID_Font "
+                     "or kTrueType_Font.\n", &typeface, fontAsset.get());
+        } else if (type == SkAdvancedTypefaceMetrics::kTrueType_Font) {
+            sk_sp<SkData> subsetFontData;
+            if (subset) {
+                SkASSERT(font.firstGlyphID() == 1);
+                subsetFontData = SkPDFSubsetFont(typeface, font.glyphUsage());
+            }
+            std::unique_ptr<SkStreamAsset> subsetFontAsset;
+            if (subsetFontData) {
+                subsetFontAsset = SkMemoryStream::Make(std::move(subsetFontData));
+            } else {
+                // If subsetting fails, fall back to original font data.
+                subsetFontAsset = std::move(fontAsset);
+            }
+            std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
+            streamDict->insertInt("Length1", subsetFontAsset->getLength());
+            descriptor->insertRef("FontFile2",
+                                  SkPDFStreamOut(std::move(streamDict), std::move(subsetFontAsset),
+                                                 doc, SkPDFSteamCompressionEnabled::Yes));
+        } else if (type == SkAdvancedTypefaceMetrics::kType1CID_Font) {
+            std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
+            streamDict->insertName("Subtype", "CIDFontType0C");
+            descriptor->insertRef("FontFile3",
+                                  SkPDFStreamOut(std::move(streamDict), std::move(fontAsset),
+                                                 doc, SkPDFSteamCompressionEnabled::Yes));
         } else {
-            // If subsetting fails, fall back to original font data.
-            subsetFontAsset = std::move(fontAsset);
+            SkASSERT(false);
         }
-        std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
-        streamDict->insertInt("Length1", subsetFontAsset->getLength());
-        descriptor->insertRef("FontFile2",
-                              SkPDFStreamOut(std::move(streamDict), std::move(subsetFontAsset),
-                                             doc, SkPDFSteamCompressionEnabled::Yes));
-    } else if (type == SkAdvancedTypefaceMetrics::kType1CID_Font) {
-        std::unique_ptr<SkPDFDict> streamDict = SkPDFMakeDict();
-        streamDict->insertName("Subtype", "CIDFontType0C");
-        descriptor->insertRef("FontFile3",
-                              SkPDFStreamOut(std::move(streamDict), std::move(fontAsset),
-                                             doc, SkPDFSteamCompressionEnabled::Yes));
-    } else {
-        SkASSERT(false);
+        descriptorRef = doc->emit(*descriptor);
+        doc->fFontSubsets.set(std::move(subsetKey), descriptorRef);
     }
 
     auto newCIDFont = SkPDFMakeDict("Font");
-    newCIDFont->insertRef("FontDescriptor", doc->emit(*descriptor));
+    newCIDFont->insertRef("FontDescriptor", descriptorRef);
     newCIDFont->insertName("BaseFont", metrics.fPostScriptName);
 
     switch (type) {
@@ -9,6 +9,7 @@
 
 #include "include/core/SkRefCnt.h"
 #include "include/core/SkScalar.h"
+#include "include/core/SkTypeface.h"
 #include "include/core/SkTypes.h"
 #include "src/base/SkUTF.h"
 #include "src/core/SkAdvancedTypefaceMetrics.h"
@@ -37,6 +38,26 @@ public:
     const SkScalar fUnitsPerEM;
 };
 
+/** Identifies the embedded font program of a font subset, so that fonts with the same
+ *  glyphs can share it.
+ */
+struct SkPDFFontSubsetKey {
+    SkTypefaceID fTypefaceID;
+    SkAdvancedTypefaceMetrics::FontType fType;
+    uint16_t fEmSize;
+    // Empty if the whole font program is embedded.
+    std::vector<SkGlyphID> fGlyphs;
+
+    bool operator==(const SkPDFFontSubsetKey& that) const {
+        return fTypefaceID == that.fTypefaceID && fType == that.fType &&
+               fEmSize == that.fEmSize && fGlyphs == that.fGlyphs;
+    }
+
+    struct Hash {
+        uint32_t operator()(const SkPDFFontSubsetKey& k) const;
+    };
+};
+
 class SkPDFStrike : public SkRefCnt {
 public:
     /** Make or return an existing SkPDFStrike, canonicalizing for resource de-duplication.
@@ -44,6 +65,11 @@ public:
      */
     static sk_sp<SkPDFStrike> Make(SkPDFDocument* doc, const SkFont&, const SkPaint&);
 
+    /** Make or return the SkPDFStrike in |doc| that matches |strike|, which belongs to
+     *  another SkPDFDocument.
+     */
+    static sk_sp<SkPDFStrike> Adopt(SkPDFDocument* doc, const SkPDFStrike& strike);
+
     const SkPDFStrikeSpec fPath;
     const SkPDFStrikeSpec fImage;
     const bool fHasMaskFilter;
@@ -56,6 +82,12 @@ public:
      */
     SkPDFFont* getFontResource(const SkGlyph* glyph);
 
+    /** Get the font resource that encodes the same glyphs as |font|, which belongs to
+     *  a strike in another SkPDFDocument, and add the glyphs used by |font| to it.
+     *  The returned SkPDFFont is owned by the SkPDFStrike.
+     */
+    SkPDFFont* mergeFont(const SkPDFFont& font);
+
     struct Traits {
         static const SkDescriptor& GetKey(const sk_sp<SkPDFStrike>& strike);
         static uint32_t Hash(const SkDescriptor& descriptor);
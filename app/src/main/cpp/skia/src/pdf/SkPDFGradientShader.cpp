@@ -923,6 +923,12 @@ static SkPDFGradientShader::Key clone_key(const SkPDFGradientShader::Key& k) {
     return clone;
 }
 
+SkPDFGradientShader::Key SkPDFGradientShader::CloneKey(const Key& k) {
+    Key clone = clone_key(k);
+    clone.fHash = k.fHash;
+    return clone;
+}
+
 static SkPDFIndirectReference create_smask_graphic_state(SkPDFDocument* doc,
                                                      const SkPDFGradientShader::Key& state) {
     SkASSERT(state.fType != SkShaderBase::GradientType::kNone);
@@ -70,5 +70,8 @@ inline bool operator==(const Key& u, const Key& v) {
 }
 inline bool operator!=(const Key& u, const Key& v) { return !(u == v); }
 
+// Returns a deep copy of the key, including its hash.
+Key CloneKey(const Key&);
+
 }  // namespace SkPDFGradientShader
 #endif  // SkPDFGradientShader_DEFINED
@@ -11,14 +11,18 @@
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTemplates.h"
 #include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkResourceCache.h"
 #include "src/pdf/SkPDFGlyphUse.h"
 
 #include "hb.h"  // NO_G3_REWRITE
 #include "hb-subset.h"  // NO_G3_REWRITE
 
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace {
 
@@ -103,10 +107,70 @@ sk_sp<SkData> subset_harfbuzz(const SkTypeface& typeface, const SkPDFGlyphUse& g
     return to_data(std::move(result));
 }
 
+static unsigned gSubsetFontKeyNamespaceLabel;
+
+struct SubsetFontKey : public SkResourceCache::Key {
+public:
+    SubsetFontKey(SkTypefaceID typefaceID, const std::vector<SkGlyphID>& glyphs)
+            : fTypefaceID(typefaceID)
+            , fGlyphCount(SkToU32(glyphs.size()))
+            , fGlyphHash(SkChecksum::Hash32(glyphs.data(), glyphs.size() * sizeof(SkGlyphID))) {
+        this->init(&gSubsetFontKeyNamespaceLabel, 0,
+                   sizeof(fTypefaceID) + sizeof(fGlyphCount) + sizeof(fGlyphHash));
+    }
+
+    SkTypefaceID fTypefaceID;
+    uint32_t fGlyphCount;
+    uint32_t fGlyphHash;
+};
+
+struct SubsetFontRec : public SkResourceCache::Rec {
+    SubsetFontRec(const SubsetFontKey& key, std::vector<SkGlyphID> glyphs, sk_sp<SkData> subset)
+            : fKey(key), fGlyphs(std::move(glyphs)), fSubset(std::move(subset)) {}
+
+    SubsetFontKey fKey;
+    std::vector<SkGlyphID> fGlyphs;
+    sk_sp<SkData> fSubset;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fGlyphs.size() * sizeof(SkGlyphID) + fSubset->size();
+    }
+    const char* getCategory() const override { return "pdf-font-subset"; }
+
+    struct Query {
+        const std::vector<SkGlyphID>* fGlyphs;
+        sk_sp<SkData> fResult;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const SubsetFontRec& rec = static_cast<const SubsetFontRec&>(baseRec);
+        Query* query = static_cast<Query*>(contextData);
+        // A hash collision; the stale entry is dropped and replaced by the caller's subset.
+        if (rec.fGlyphs != *query->fGlyphs) {
+            return false;
+        }
+        query->fResult = rec.fSubset;
+        return true;
+    }
+};
+
 }  // namespace
 
 sk_sp<SkData> SkPDFSubsetFont(const SkTypeface& typeface, const SkPDFGlyphUse& glyphUsage) {
-    return subset_harfbuzz(typeface, glyphUsage);
+    std::vector<SkGlyphID> glyphs;
+    glyphUsage.getSetValues([&glyphs](size_t gid) { glyphs.push_back(SkToU16(gid)); });
+
+    SubsetFontKey key(typeface.uniqueID(), glyphs);
+    SubsetFontRec::Query query{&glyphs, nullptr};
+    if (SkResourceCache::Find(key, SubsetFontRec::Visitor, &query)) {
+        return query.fResult;
+    }
+    sk_sp<SkData> subset = subset_harfbuzz(typeface, glyphUsage);
+    if (subset) {
+        SkResourceCache::Add(new SubsetFontRec(key, std::move(glyphs), subset));
+    }
+    return subset;
 }
 
 #else
@@ -10,7 +10,8 @@ class SkPDFGlyphUse;
 class SkTypeface;
 
 /** Subset the typeface's data to only include the glyphs used.
- *  The glyph ids will remain the same.
+ *  The glyph ids will remain the same. Results are cached by typeface and
+ *  glyph set, so documents that use the same glyphs share the work.
  *
  *  @return The subset font data, or nullptr if it cannot be subset.
  */
@@ -294,6 +294,9 @@ void SkPDFUnion::emitObject(SkWStream* stream) const {
             return;
         case Type::kRef:
             SkASSERT(fIntValue >= 0);
+            if (SkPDFAutoRecordRefs* recorder = SkPDFAutoRecordRefs::Find(stream)) {
+                recorder->record(stream->bytesWritten(), SkPDFIndirectReference{fIntValue});
+            }
             stream->writeDecAsText(fIntValue);
             stream->writeText(" 0 R");  // Generation number is always 0.
             return;
@@ -302,6 +305,14 @@ void SkPDFUnion::emitObject(SkWStream* stream) const {
     }
 }
 
+void SkPDFUnion::remapRefs(const SkPDFRefRemapper& remap) {
+    if (fType == Type::kRef) {
+        fIntValue = remap(SkPDFIndirectReference{fIntValue}).fValue;
+    } else if (fType == Type::kObject) {
+        fObject->remapRefs(remap);
+    }
+}
+
 SkPDFUnion SkPDFUnion::Int(int32_t value) {
     return SkPDFUnion(Type::kInt, value);
 }
@@ -391,6 +402,12 @@ void SkPDFArray::emitObject(SkWStream* stream) const {
     stream->writeText("]");
 }
 
+void SkPDFArray::remapRefs(const SkPDFRefRemapper& remap) {
+    for (SkPDFUnion& value : fValues) {
+        value.remapRefs(remap);
+    }
+}
+
 void SkPDFOptionalArray::emitObject(SkWStream* stream) const {
     if (this->size() == 1) {
         this->values()[0].emitObject(stream);
@@ -479,6 +496,12 @@ void SkPDFDict::emitObject(SkWStream* stream) const {
     stream->writeText(">>");
 }
 
+void SkPDFDict::remapRefs(const SkPDFRefRemapper& remap) {
+    for (std::pair<SkPDFUnion, SkPDFUnion>& record : fRecords) {
+        record.second.remapRefs(remap);
+    }
+}
+
 size_t SkPDFDict::size() const { return fRecords.size(); }
 
 void SkPDFDict::reserve(int n) {
@@ -551,7 +574,31 @@ void SkPDFDict::insertUnion(const char key[], SkPDFUnion&& value) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+static thread_local SkPDFAutoRecordRefs* gRefRecorder = nullptr;
 
+SkPDFAutoRecordRefs::SkPDFAutoRecordRefs(const SkWStream* stream, std::vector<Ref>* refs)
+    : fStream(stream)
+    , fRefs(refs)
+    , fPrevious(gRefRecorder) {
+    SkASSERT(stream && refs);
+    gRefRecorder = this;
+}
+
+SkPDFAutoRecordRefs::~SkPDFAutoRecordRefs() {
+    SkASSERT(gRefRecorder == this);
+    gRefRecorder = fPrevious;
+}
+
+SkPDFAutoRecordRefs* SkPDFAutoRecordRefs::Find(const SkWStream* stream) {
+    for (SkPDFAutoRecordRefs* recorder = gRefRecorder; recorder; recorder = recorder->fPrevious) {
+        if (recorder->fStream == stream) {
+            return recorder;
+        }
+    }
+    return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
 static void serialize_stream(SkPDFDict* origDict,
                              SkStreamAsset* stream,
@@ -570,9 +617,15 @@ static void serialize_stream(SkPDFDict* origDict,
         stream->getLength() > kMinimumSavings)
     {
         SkDynamicMemoryWStream compressedData;
-        SkDeflateWStream deflateWStream(&compressedData,SkToInt(doc->metadata().fCompressionLevel));
-        SkStreamCopy(&deflateWStream, stream);
-        deflateWStream.finalize();
+        int compressionLevel = SkToInt(doc->metadata().fCompressionLevel);
+        const SkDeflateEngine* engine = doc->deflateEngine();
+        if (const void* data = engine ? stream->getMemoryBase() : nullptr) {
+            engine->compress(data, stream->getLength(), compressionLevel, &compressedData);
+        } else {
+            SkDeflateWStream deflateWStream(&compressedData, compressionLevel, false, engine);
+            SkStreamCopy(&deflateWStream, stream);
+            deflateWStream.finalize();
+        }
         if (stream->getLength() > compressedData.bytesWritten() + kMinimumSavings) {
             tmp = compressedData.detachAsStream();
             stream = tmp.get();
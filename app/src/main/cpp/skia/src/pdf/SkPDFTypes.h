@@ -66,6 +66,11 @@ public:
      */
     virtual void emitObject(SkWStream* stream) const = 0;
 
+    /** Replaces every indirect reference held by this object, or by any object
+     *  it owns, with the result of |remap|.
+     */
+    virtual void remapRefs(const SkPDFRefRemapper& remap) {}
+
     virtual ~SkPDFObject() = default;
 
 private:
@@ -90,6 +95,7 @@ public:
 
     // The SkPDFObject interface.
     void emitObject(SkWStream* stream) const override;
+    void remapRefs(const SkPDFRefRemapper& remap) override;
 
     /** The size of the array.
      */
@@ -169,6 +175,7 @@ public:
 
     // The SkPDFObject interface.
     void emitObject(SkWStream* stream) const override;
+    void remapRefs(const SkPDFRefRemapper& remap) override;
 
     /** The size of the dictionary.
      */
@@ -211,6 +218,37 @@ static inline std::unique_ptr<SkPDFDict> SkPDFMakeDict(const char* type = nullpt
     return std::make_unique<SkPDFDict>(type);
 }
 
+/** \class SkPDFAutoRecordRefs
+
+    While in scope, records where each indirect reference written to |stream|
+    by this thread starts. This lets objects be serialized before their final
+    object numbers are known, and renumbered when they are copied into the
+    document.
+*/
+class SkPDFAutoRecordRefs {
+public:
+    struct Ref {
+        size_t fOffset;  // Offset of the "N 0 R" text in the stream.
+        SkPDFIndirectReference fRef;
+    };
+
+    SkPDFAutoRecordRefs(const SkWStream* stream, std::vector<Ref>* refs);
+    ~SkPDFAutoRecordRefs();
+
+    /** Returns the recorder for |stream| on this thread, or nullptr. */
+    static SkPDFAutoRecordRefs* Find(const SkWStream* stream);
+
+    void record(size_t offset, SkPDFIndirectReference ref) { fRefs->push_back({offset, ref}); }
+
+private:
+    const SkWStream* fStream;
+    std::vector<Ref>* fRefs;
+    SkPDFAutoRecordRefs* fPrevious;
+
+    SkPDFAutoRecordRefs(const SkPDFAutoRecordRefs&) = delete;
+    SkPDFAutoRecordRefs& operator=(const SkPDFAutoRecordRefs&) = delete;
+};
+
 enum class SkPDFSteamCompressionEnabled : bool {
     No = false,
     Yes = true,
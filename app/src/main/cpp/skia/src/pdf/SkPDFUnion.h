@@ -9,12 +9,15 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 class SkPDFObject;
 class SkWStream;
 struct SkPDFIndirectReference;
 
+using SkPDFRefRemapper = std::function<SkPDFIndirectReference(SkPDFIndirectReference)>;
+
 /**
    A SkPDFUnion is a non-virtualized implementation of the
    non-compound, non-specialized PDF Object types: Name, String,
@@ -76,6 +79,10 @@ public:
         corresponding virtuals. */
     void emitObject(SkWStream*) const;
 
+    /** Replaces the indirect reference held by this value, or by any object
+        it owns, with the result of |remap|. */
+    void remapRefs(const SkPDFRefRemapper& remap);
+
     bool isName() const;
 
 private:
@@ -22,20 +22,30 @@ namespace SkShaders {
 MatrixRec::MatrixRec(const SkMatrix& ctm) : fCTM(ctm) {}
 
 std::optional<MatrixRec> MatrixRec::apply(const SkStageRec& rec, const SkMatrix& postInv) const {
-    SkMatrix total = fPendingLocalMatrix;
+    SkMatrix total;
+    std::optional<MatrixRec> result = this->applyDeferred(rec, postInv, &total);
+    if (result.has_value()) {
+        // appendMatrix is a no-op if total worked out to identity.
+        rec.fPipeline->appendMatrix(rec.fAlloc, total);
+    }
+    return result;
+}
+
+std::optional<MatrixRec> MatrixRec::applyDeferred(const SkStageRec& rec,
+                                                  const SkMatrix& postInv,
+                                                  SkMatrix* total) const {
+    *total = fPendingLocalMatrix;
     if (!fCTMApplied) {
-        total = SkMatrix::Concat(fCTM, total);
+        *total = SkMatrix::Concat(fCTM, *total);
     }
-    if (auto inv = total.invert()) {
-        total = SkMatrix::Concat(postInv, *inv);
+    if (auto inv = total->invert()) {
+        *total = SkMatrix::Concat(postInv, *inv);
     } else {
         return {};
     }
     if (!fCTMApplied) {
         rec.fPipeline->append(SkRasterPipelineOp::seed_shader);
     }
-    // appendMatrix is a no-op if total worked out to identity.
-    rec.fPipeline->appendMatrix(rec.fAlloc, total);
     return MatrixRec{fCTM,
                      fTotalLocalMatrix,
                      /*pendingLocalMatrix=*/SkMatrix::I(),
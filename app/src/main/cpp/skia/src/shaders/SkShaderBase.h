@@ -75,6 +75,16 @@ public:
     [[nodiscard]] std::optional<MatrixRec> apply(const SkStageRec& rec,
                                                  const SkMatrix& postInv = {}) const;
 
+    /**
+     * Like apply(), but the matrix is returned in 'total' instead of being appended, so that
+     * the caller can fold it into its own stages. Only the coordinate seeding (if any) is
+     * appended; the caller is responsible for applying 'total' to the seeded coordinates, e.g.
+     * with SkRasterPipeline::appendMatrix().
+     */
+    [[nodiscard]] std::optional<MatrixRec> applyDeferred(const SkStageRec& rec,
+                                                         const SkMatrix& postInv,
+                                                         SkMatrix* total) const;
+
     /**
      * FP matrices work differently than SkRasterPipeline. The starting coordinates provided to the
      * root SkShader's FP are already in local space. So we never apply the inverse CTM. This
@@ -35,9 +35,11 @@
 #include "src/core/SkRasterPipelineOpList.h"
 #include "src/core/SkReadBuffer.h"
 #include "src/core/SkWriteBuffer.h"
+#include "src/shaders/gradients/SkGradientLUTCache.h"
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <optional>
 #include <utility>
 
@@ -489,6 +491,44 @@ void SkGradientBaseShader::AppendGradientFillStages(SkRasterPipeline* p,
     p->append(SkRasterPipelineOp::gradient, ctx);
 }
 
+// Interpolation spaces whose colors are converted to an SkColorSpace by dedicated stages.
+static bool is_css_color_space(SkGradientShader::Interpolation::ColorSpace cs) {
+    using ColorSpace = SkGradientShader::Interpolation::ColorSpace;
+    switch (cs) {
+        case ColorSpace::kLab:
+        case ColorSpace::kOKLab:
+        case ColorSpace::kOKLabGamutMap:
+        case ColorSpace::kLCH:
+        case ColorSpace::kOKLCH:
+        case ColorSpace::kOKLCHGamutMap:
+        case ColorSpace::kHSL:
+        case ColorSpace::kHWB:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static SkColorSpaceXformSteps intermediate_to_dst_steps(bool colorIsPremul,
+                                                        bool colorsAreOpaque,
+                                                        const SkColorSpace* intermediateColorSpace,
+                                                        const SkColorSpace* dstColorSpace) {
+    // See comments in GrGradientShader.cpp about the decisions here.
+    if (!dstColorSpace) {
+        dstColorSpace = sk_srgb_singleton();
+    }
+    SkAlphaType intermediateAlphaType = colorIsPremul ? kPremul_SkAlphaType : kUnpremul_SkAlphaType;
+    // TODO(skbug.com/40044213): Get dst alpha type correctly
+    SkAlphaType dstAlphaType = kPremul_SkAlphaType;
+
+    if (colorsAreOpaque) {
+        intermediateAlphaType = dstAlphaType = kUnpremul_SkAlphaType;
+    }
+
+    return SkColorSpaceXformSteps(
+            intermediateColorSpace, intermediateAlphaType, dstColorSpace, dstAlphaType);
+}
+
 void SkGradientBaseShader::AppendInterpolatedToDstStages(SkRasterPipeline* p,
                                                          SkArenaAlloc* alloc,
                                                          bool colorsAreOpaque,
@@ -541,21 +581,171 @@ void SkGradientBaseShader::AppendInterpolatedToDstStages(SkRasterPipeline* p,
     }
 
     // Now transform from intermediate to destination color space.
-    // See comments in GrGradientShader.cpp about the decisions here.
-    if (!dstColorSpace) {
-        dstColorSpace = sk_srgb_singleton();
+    alloc->make<SkColorSpaceXformSteps>(intermediate_to_dst_steps(
+                 colorIsPremul, colorsAreOpaque, intermediateColorSpace, dstColorSpace))
+            ->apply(p);
+}
+
+// Clamped two-stop linear and radial gradients are by far the most common gradients. When their
+// colors need no conversion beyond premul, a single stage maps the seeded device coordinates
+// straight to the final color. Returns false if the gradient does not qualify; nothing has been
+// appended in that case.
+static bool append_two_stop_gradient(const SkGradientBaseShader* shader,
+                                     const SkStageRec& rec,
+                                     const SkMatrix& total,
+                                     const SkColor4fXformer& xformedColors) {
+    if (xformedColors.fColors.size() != 2 || xformedColors.fPositions ||
+        shader->getTileMode() != SkTileMode::kClamp || total.hasPerspective() ||
+        is_css_color_space(shader->fInterpolation.fColorSpace)) {
+        return false;
     }
-    SkAlphaType intermediateAlphaType = colorIsPremul ? kPremul_SkAlphaType : kUnpremul_SkAlphaType;
-    // TODO(skbug.com/40044213): Get dst alpha type correctly
-    SkAlphaType dstAlphaType = kPremul_SkAlphaType;
 
-    if (colorsAreOpaque) {
-        intermediateAlphaType = dstAlphaType = kUnpremul_SkAlphaType;
+    SkRasterPipelineOp op;
+    switch (shader->asGradient()) {
+        case SkShaderBase::GradientType::kLinear:
+            op = SkRasterPipelineOp::linear_2_stop_gradient;
+            break;
+        case SkShaderBase::GradientType::kRadial:
+            op = SkRasterPipelineOp::radial_2_stop_gradient;
+            break;
+        default:
+            return false;
     }
 
-    alloc->make<SkColorSpaceXformSteps>(
-                 intermediateColorSpace, intermediateAlphaType, dstColorSpace, dstAlphaType)
-            ->apply(p);
+    SkColorSpaceXformSteps steps =
+            intermediate_to_dst_steps(shader->interpolateInPremul(),
+                                      shader->colorsAreOpaque(),
+                                      xformedColors.fIntermediateColorSpace.get(),
+                                      rec.fDstCS);
+    if (steps.fFlags.unpremul || steps.fFlags.linearize || steps.fFlags.src_ootf ||
+        steps.fFlags.gamut_transform || steps.fFlags.dst_ootf || steps.fFlags.encode) {
+        return false;
+    }
+
+    auto ctx = rec.fAlloc->make<SkRasterPipelineContexts::TwoStopGradientCtx>();
+    ctx->matrix[0] = total.getScaleX();
+    ctx->matrix[1] = total.getSkewX();
+    ctx->matrix[2] = total.getTranslateX();
+    ctx->matrix[3] = total.getSkewY();
+    ctx->matrix[4] = total.getScaleY();
+    ctx->matrix[5] = total.getTranslateY();
+
+    const SkPMColor4f c_l = xformedColors.fColors[0], c_r = xformedColors.fColors[1];
+    (skvx::float4::Load(c_r.vec()) - skvx::float4::Load(c_l.vec())).store(ctx->factor);
+    (skvx::float4::Load(c_l.vec())).store(ctx->bias);
+    ctx->premul = steps.fFlags.premul;
+
+    rec.fPipeline->append(op, ctx);
+    return true;
+}
+
+// Gradients that convert every pixel out of a CSS color space, or that search many arbitrarily
+// placed stops, are cheaper to sample from a table of their final colors. The table has
+// kGradientLUTSize evenly spaced samples, which keeps the lerp between neighbors well within an
+// 8-bit step for smooth gradients.
+static constexpr int kGradientLUTSize = 1024;
+static constexpr int kGradientLUTMinStopCount = 8;
+
+static bool should_use_gradient_lut(const SkColor4fXformer& xformedColors,
+                                    const SkGradientShader::Interpolation& interpolation) {
+    const int count = xformedColors.fColors.size();
+    const float* positions = xformedColors.fPositions;
+    if (count > kGradientLUTSize / 4) {
+        // Too many stops to be resolved by the table.
+        return false;
+    }
+    if (positions) {
+        // Stops that are closer together than the table's step, including hard stops, would be
+        // smeared across an entry; those gradients keep the exact path.
+        constexpr float kStep = 1.0f / (kGradientLUTSize - 1);
+        for (int i = 1; i < count; ++i) {
+            if (!(positions[i] - positions[i - 1] >= kStep)) {
+                return false;
+            }
+        }
+    }
+    return is_css_color_space(interpolation.fColorSpace) ||
+           (positions && count >= kGradientLUTMinStopCount);
+}
+
+static void push_color_space_hash(TArray<uint32_t>* descriptor, const SkColorSpace* cs) {
+    descriptor->push_back(cs ? cs->toXYZD50Hash() : 0);
+    descriptor->push_back(cs ? cs->transferFnHash() : 0);
+}
+
+// Renders the gradient at evenly spaced t with the regular fill and conversion stages.
+static sk_sp<SkData> make_gradient_lut(const SkColor4fXformer& xformedColors,
+                                       bool colorsAreOpaque,
+                                       const SkGradientShader::Interpolation& interpolation,
+                                       const SkColorSpace* dstColorSpace) {
+    using SkRasterPipelineContexts::kRGBAChannels;
+    sk_sp<SkData> lut =
+            SkData::MakeUninitialized((kGradientLUTSize + 1) * kRGBAChannels * sizeof(float));
+    float* rgba = static_cast<float*>(lut->writable_data());
+
+    SkSTArenaAlloc<1024> alloc;
+    SkRasterPipeline p(&alloc);
+    p.append(SkRasterPipelineOp::seed_shader);
+    // Map the pixel centers 0.5, 1.5, ... to t = 0, 1/(size-1), ..., 1.
+    p.appendMatrix(&alloc, SkMatrix::Scale(1.0f / (kGradientLUTSize - 1), 1)
+                                   .preTranslate(-0.5f, -0.5f));
+    p.append(SkRasterPipelineOp::clamp_x_1);
+    SkGradientBaseShader::AppendGradientFillStages(&p, &alloc,
+                                                   xformedColors.fColors.begin(),
+                                                   xformedColors.fPositions,
+                                                   xformedColors.fColors.size());
+    SkGradientBaseShader::AppendInterpolatedToDstStages(
+            &p, &alloc, colorsAreOpaque, interpolation,
+            xformedColors.fIntermediateColorSpace.get(), dstColorSpace);
+    SkRasterPipelineContexts::MemoryCtx dst = {rgba, 0};
+    p.append(SkRasterPipelineOp::store_f32, &dst);
+    p.run(0, 0, kGradientLUTSize, 1);
+
+    // Lookups at t == 1 lerp towards the entry after the last sample.
+    memcpy(rgba + kGradientLUTSize * kRGBAChannels,
+           rgba + (kGradientLUTSize - 1) * kRGBAChannels,
+           kRGBAChannels * sizeof(float));
+    return lut;
+}
+
+static void append_gradient_lut(SkRasterPipeline* p,
+                                SkArenaAlloc* alloc,
+                                const SkColor4fXformer& xformedColors,
+                                bool colorsAreOpaque,
+                                const SkGradientShader::Interpolation& interpolation,
+                                const SkColorSpace* dstColorSpace) {
+    // Everything the table depends on. The colors are already in the intermediate space of the
+    // destination, but the conversion after interpolation also depends on the color spaces.
+    const int count = xformedColors.fColors.size();
+    STArray<64, uint32_t> descriptor;
+    descriptor.push_back(count);
+    descriptor.push_back((colorsAreOpaque                                 ? 1 : 0) |
+                         (xformedColors.fPositions                        ? 2 : 0) |
+                         (static_cast<uint32_t>(interpolation.fInPremul)   << 8)   |
+                         (static_cast<uint32_t>(interpolation.fColorSpace) << 16)  |
+                         (static_cast<uint32_t>(interpolation.fHueMethod)  << 24));
+    push_color_space_hash(&descriptor, xformedColors.fIntermediateColorSpace.get());
+    push_color_space_hash(&descriptor,
+                          dstColorSpace ? dstColorSpace : sk_srgb_singleton());
+    const size_t colorWords = count * sizeof(SkPMColor4f) / sizeof(uint32_t);
+    memcpy(descriptor.push_back_n(SkToInt(colorWords)), xformedColors.fColors.begin(),
+           count * sizeof(SkPMColor4f));
+    if (xformedColors.fPositions) {
+        memcpy(descriptor.push_back_n(count), xformedColors.fPositions, count * sizeof(float));
+    }
+
+    sk_sp<SkData> lut = SkGradientLUTCache::Find(descriptor);
+    if (!lut) {
+        lut = make_gradient_lut(xformedColors, colorsAreOpaque, interpolation, dstColorSpace);
+        SkGradientLUTCache::Add(descriptor, lut);
+    }
+
+    auto ctx = alloc->make<SkRasterPipelineContexts::GradientLUTCtx>();
+    ctx->rgba = static_cast<const float*>(lut->data());
+    ctx->scale = kGradientLUTSize - 1;
+    // The cache may purge the table while the pipeline still needs it.
+    alloc->make<sk_sp<SkData>>(std::move(lut));
+    p->append(SkRasterPipelineOp::gradient_lut, ctx);
 }
 
 bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
@@ -564,11 +754,20 @@ bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
     SkArenaAlloc* alloc = rec.fAlloc;
     SkRasterPipelineContexts::DecalTileCtx* decal_ctx = nullptr;
 
-    std::optional<SkShaders::MatrixRec> newMRec = mRec.apply(rec, fPtsToUnit);
+    SkMatrix total;
+    std::optional<SkShaders::MatrixRec> newMRec = mRec.applyDeferred(rec, fPtsToUnit, &total);
     if (!newMRec.has_value()) {
         return false;
     }
 
+    // Transform all of the colors to destination color space, possibly premultiplied
+    SkColor4fXformer xformedColors(this, rec.fDstCS);
+    if (append_two_stop_gradient(this, rec, total, xformedColors)) {
+        return true;
+    }
+    // appendMatrix is a no-op if total worked out to identity.
+    p->appendMatrix(alloc, total);
+
     SkRasterPipeline_<256> postPipeline;
 
     this->appendGradientStages(alloc, p, &postPipeline);
@@ -598,14 +797,16 @@ bool SkGradientBaseShader::appendStages(const SkStageRec& rec,
             break;
     }
 
-    // Transform all of the colors to destination color space, possibly premultiplied
-    SkColor4fXformer xformedColors(this, rec.fDstCS);
-    AppendGradientFillStages(p, alloc,
-                             xformedColors.fColors.begin(),
-                             xformedColors.fPositions,
-                             xformedColors.fColors.size());
-    AppendInterpolatedToDstStages(p, alloc, fColorsAreOpaque, fInterpolation,
-                                  xformedColors.fIntermediateColorSpace.get(), rec.fDstCS);
+    if (should_use_gradient_lut(xformedColors, fInterpolation)) {
+        append_gradient_lut(p, alloc, xformedColors, fColorsAreOpaque, fInterpolation, rec.fDstCS);
+    } else {
+        AppendGradientFillStages(p, alloc,
+                                 xformedColors.fColors.begin(),
+                                 xformedColors.fPositions,
+                                 xformedColors.fColors.size());
+        AppendInterpolatedToDstStages(p, alloc, fColorsAreOpaque, fInterpolation,
+                                      xformedColors.fIntermediateColorSpace.get(), rec.fDstCS);
+    }
 
     if (decal_ctx) {
         p->append(SkRasterPipelineOp::check_decal_mask, decal_ctx);
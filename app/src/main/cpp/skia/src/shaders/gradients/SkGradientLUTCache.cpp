@@ -0,0 +1,88 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/shaders/gradients/SkGradientLUTCache.h"
+
+#include "include/core/SkData.h"
+#include "include/private/base/SkTArray.h"
+#include "include/private/base/SkTo.h"
+#include "src/core/SkChecksum.h"
+#include "src/core/SkResourceCache.h"
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+namespace {
+static unsigned gGradientLUTKeyNamespaceLabel;
+
+struct GradientLUTKey : public SkResourceCache::Key {
+public:
+    explicit GradientLUTKey(SkSpan<const uint32_t> descriptor)
+            : fCount(SkToU32(descriptor.size())) {
+        uint64_t hash = SkChecksum::Hash64(descriptor.data(), descriptor.size_bytes());
+        fHash_lo = (uint32_t)hash;
+        fHash_hi = (uint32_t)(hash >> 32);
+        this->init(&gGradientLUTKeyNamespaceLabel, 0,
+                   sizeof(fCount) + sizeof(fHash_lo) + sizeof(fHash_hi));
+    }
+
+    uint32_t fCount;
+    // Split so the key stays tightly packed on 32-bit machines.
+    uint32_t fHash_lo;
+    uint32_t fHash_hi;
+};
+
+struct GradientLUTRec : public SkResourceCache::Rec {
+    GradientLUTRec(const GradientLUTKey& key, SkSpan<const uint32_t> descriptor, sk_sp<SkData> lut)
+            : fKey(key)
+            , fDescriptor(descriptor.data(), SkToInt(descriptor.size()))
+            , fLUT(std::move(lut)) {}
+
+    GradientLUTKey                 fKey;
+    skia_private::TArray<uint32_t> fDescriptor;
+    sk_sp<SkData>                  fLUT;
+
+    const Key& getKey() const override { return fKey; }
+    size_t bytesUsed() const override {
+        return sizeof(*this) + fDescriptor.size_bytes() + fLUT->size();
+    }
+    const char* getCategory() const override { return "gradient-lut"; }
+
+    struct Query {
+        SkSpan<const uint32_t> fDescriptor;
+        sk_sp<SkData>          fResult;
+    };
+
+    static bool Visitor(const SkResourceCache::Rec& baseRec, void* contextData) {
+        const GradientLUTRec& rec = static_cast<const GradientLUTRec&>(baseRec);
+        Query* query = static_cast<Query*>(contextData);
+
+        // A hash collision; the stale entry is dropped and replaced by the caller's table.
+        if ((size_t)rec.fDescriptor.size() != query->fDescriptor.size() ||
+            memcmp(rec.fDescriptor.data(), query->fDescriptor.data(),
+                   query->fDescriptor.size_bytes()) != 0) {
+            return false;
+        }
+        query->fResult = rec.fLUT;
+        return true;
+    }
+};
+}  // namespace
+
+sk_sp<SkData> SkGradientLUTCache::Find(SkSpan<const uint32_t> descriptor) {
+    GradientLUTRec::Query query{descriptor, nullptr};
+    if (!SkResourceCache::Find(GradientLUTKey(descriptor), GradientLUTRec::Visitor, &query)) {
+        return nullptr;
+    }
+    return query.fResult;
+}
+
+void SkGradientLUTCache::Add(SkSpan<const uint32_t> descriptor, sk_sp<SkData> lut) {
+    GradientLUTKey key(descriptor);
+    SkResourceCache::Add(new GradientLUTRec(key, descriptor, std::move(lut)));
+}
@@ -0,0 +1,35 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SkGradientLUTCache_DEFINED
+#define SkGradientLUTCache_DEFINED
+
+#include "include/core/SkRefCnt.h"
+#include "include/core/SkSpan.h"
+
+#include <cstdint>
+
+class SkData;
+
+/**
+ * Gradient color lookup tables, stored in the global SkResourceCache.
+ *
+ * A table is identified by a descriptor: a flat array of words that captures everything its
+ * contents depend on (stop colors and positions, interpolation, and the intermediate and
+ * destination color spaces). The cache key is a hash of the descriptor, and the full descriptor
+ * is compared on lookup, so distinct gradients never share a table.
+ */
+class SkGradientLUTCache {
+public:
+    /** Returns the table for the descriptor, or nullptr if it is not in the cache. */
+    static sk_sp<SkData> Find(SkSpan<const uint32_t> descriptor);
+
+    /** Adds a table for the descriptor to the cache. */
+    static void Add(SkSpan<const uint32_t> descriptor, sk_sp<SkData> lut);
+};
+
+#endif
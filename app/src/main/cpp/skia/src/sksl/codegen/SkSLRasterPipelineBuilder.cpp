@@ -9,11 +9,14 @@
 #include <cstdint>
 #include <optional>
 
+#include "include/core/SkFourByteTag.h"
+#include "include/core/SkMilestone.h"
 #include "include/core/SkStream.h"
 #include "include/private/base/SkMalloc.h"
 #include "include/private/base/SkTFitsIn.h"
 #include "include/private/base/SkTo.h"
 #include "src/base/SkArenaAlloc.h"
+#include "src/base/SkBuffer.h"
 #include "src/base/SkSafeMath.h"
 #include "src/core/SkOpts.h"
 #include "src/core/SkRasterPipelineContextUtils.h"
@@ -34,6 +37,7 @@
 #include <cstddef>
 #include <cstring>
 #include <iterator>
+#include <limits>
 #include <string>
 #include <string_view>
 #include <tuple>
@@ -1263,6 +1267,567 @@ void Builder::matrix_multiply(int leftColumns, int leftRows, int rightColumns, i
     this->appendInstruction(op, {}, leftColumns, leftRows, rightColumns, rightRows);
 }
 
+namespace {
+
+// Describes how an instruction touches the value slots. Immutable and uniform slots live in their
+// own address spaces and are never written by the program, so they aren't tracked here.
+struct SlotAccess {
+    // Slots whose current values are observed by the instruction.
+    SlotRange read;
+    // Slots which are overwritten (in every lane, if `unmasked` is set).
+    SlotRange write;
+    bool unmasked = false;
+    // Set when writing `write` is the instruction's only effect.
+    bool removable = false;
+};
+
+// Returns false if the instruction refers to value slots in a way that the optimizer doesn't model.
+bool get_slot_access(const Instruction& inst, SlotAccess* access) {
+    *access = {};
+    switch (inst.fOp) {
+        case BuilderOp::copy_constant:
+        case BuilderOp::copy_immutable_unmasked:
+        case BuilderOp::copy_stack_to_slots_unmasked:
+            access->write = {inst.fSlotA, inst.fImmA};
+            access->unmasked = access->removable = true;
+            return true;
+
+        case BuilderOp::copy_slot_unmasked:
+            access->read = {inst.fSlotB, inst.fImmA};
+            access->write = {inst.fSlotA, inst.fImmA};
+            access->unmasked = access->removable = true;
+            return true;
+
+        case BuilderOp::copy_uniform_to_slots_unmasked:
+            access->write = {inst.fSlotB, inst.fImmA};
+            access->unmasked = access->removable = true;
+            return true;
+
+        case BuilderOp::store_src_rg:
+            access->write = {inst.fSlotA, 2};
+            access->unmasked = access->removable = true;
+            return true;
+
+        case BuilderOp::store_src:
+        case BuilderOp::store_dst:
+        case BuilderOp::store_device_xy01:
+            access->write = {inst.fSlotA, 4};
+            access->unmasked = access->removable = true;
+            return true;
+
+        case BuilderOp::copy_slot_masked:
+            access->read = {inst.fSlotB, inst.fImmA};
+            access->write = {inst.fSlotA, inst.fImmA};
+            access->removable = true;
+            return true;
+
+        case BuilderOp::copy_stack_to_slots:
+            access->write = {inst.fSlotA, inst.fImmA};
+            access->removable = true;
+            return true;
+
+        case BuilderOp::swizzle_copy_stack_to_slots:
+            access->write = {inst.fSlotA, max_packed_nybble(inst.fImmB, inst.fImmA) + 1};
+            access->removable = true;
+            return true;
+
+        case BuilderOp::copy_stack_to_slots_indirect:
+        case BuilderOp::swizzle_copy_stack_to_slots_indirect:
+            access->write = {inst.fSlotA, inst.fSlotB - inst.fSlotA};
+            access->removable = true;
+            return true;
+
+        case ALL_IMMEDIATE_BINARY_OP_CASES:
+            if (inst.fSlotA != NA) {
+                // The op also reads its destination, but that value can't be observed elsewhere.
+                access->write = {inst.fSlotA, inst.fImmA};
+                access->removable = true;
+            }
+            return true;
+
+        case BuilderOp::push_slots:
+            access->read = {inst.fSlotA, inst.fImmA};
+            return true;
+
+        case BuilderOp::push_slots_indirect:
+        case BuilderOp::trace_var_indirect:
+            access->read = {inst.fSlotA, inst.fSlotB - inst.fSlotA};
+            return true;
+
+        case BuilderOp::trace_var:
+            access->read = {inst.fSlotA, inst.fImmB};
+            return true;
+
+        case BuilderOp::load_src:
+        case BuilderOp::load_dst:
+            access->read = {inst.fSlotA, 4};
+            return true;
+
+        case BuilderOp::reenable_loop_mask:
+            access->read = {inst.fSlotA, 1};
+            return true;
+
+        case BuilderOp::push_immutable:
+        case BuilderOp::push_immutable_indirect:
+        case BuilderOp::push_uniform:
+        case BuilderOp::push_uniform_indirect:
+        case BuilderOp::store_immutable_value:
+            return true;
+
+        default:
+            return inst.fSlotA == NA && inst.fSlotB == NA;
+    }
+}
+
+// Forwards copies and constants through the value slots. Within a run of instructions that isn't
+// interrupted by a label, we know when a slot holds a constant or the same value as another slot.
+// Reads of such slots are redirected to the original value, which often leaves the intermediate
+// copy unread (and removable by `eliminate_dead_slot_writes`), and turns pushes of known
+// constants into `push_constant`, which the Builder can fold into immediate-mode ops.
+class SlotValuePropagator {
+public:
+    SlotValuePropagator(const TArray<Instruction>& program, int numValueSlots) {
+        fValues.push_back_n(numValueSlots);
+        fCopyCount.push_back_n(numValueSlots, 0);
+        for (const Instruction& inst : program) {
+            if (inst.fOp == BuilderOp::store_immutable_value) {
+                fImmutableValues.set(inst.fSlotA, inst.fImmA);
+            }
+        }
+        this->reset();
+    }
+
+    bool run(TArray<Instruction>* program) {
+        bool changed = false;
+        TArray<Instruction> result;
+        result.reserve_exact(program->size());
+        for (Instruction inst : *program) {
+            changed |= this->rewriteReads(&inst);
+            int32_t constant = 0;
+            if (inst.fOp == BuilderOp::copy_constant &&
+                this->inRange({inst.fSlotA, inst.fImmA}) &&
+                this->isConstant({inst.fSlotA, inst.fImmA}, &constant) &&
+                constant == inst.fImmB) {
+                // The destination slots already hold this constant.
+                changed = true;
+                continue;
+            }
+            if (inst.fOp == BuilderOp::copy_slot_unmasked && this->isSelfCopy(inst)) {
+                // Every destination slot already holds the value being copied.
+                changed = true;
+                continue;
+            }
+            this->updateWrites(inst);
+            result.push_back(inst);
+        }
+        *program = std::move(result);
+        return changed;
+    }
+
+private:
+    struct Value {
+        enum class Kind : uint8_t { kUnknown, kConstant, kCopy };
+        Kind kind = Kind::kUnknown;
+        int32_t value = 0;  // the constant, or the slot being copied
+    };
+
+    void reset() {
+        for (Value& v : fValues) {
+            v = {};
+        }
+        for (int& count : fCopyCount) {
+            count = 0;
+        }
+    }
+
+    // Returns the known contents of `slot`. A slot with unknown contents is a copy of itself.
+    Value resolve(Slot slot) const {
+        const Value& v = fValues[slot];
+        return v.kind == Value::Kind::kUnknown ? Value{Value::Kind::kCopy, slot} : v;
+    }
+
+    bool inRange(SlotRange range) const {
+        return range.index >= 0 && range.count > 0 && range.index + range.count <= fValues.size();
+    }
+
+    bool isConstant(SlotRange range, int32_t* constant) const {
+        for (int i = 0; i < range.count; ++i) {
+            Value v = fValues[range.index + i];
+            if (v.kind != Value::Kind::kConstant || (i > 0 && v.value != *constant)) {
+                return false;
+            }
+            *constant = v.value;
+        }
+        return true;
+    }
+
+    // Returns true if `range` holds copies of a contiguous range of slots beginning at `root`.
+    bool isCopy(SlotRange range, Slot* root) const {
+        for (int i = 0; i < range.count; ++i) {
+            Value v = this->resolve(range.index + i);
+            if (v.kind != Value::Kind::kCopy || (i > 0 && v.value != *root + i)) {
+                return false;
+            }
+            if (i == 0) {
+                *root = v.value;
+            }
+        }
+        return true;
+    }
+
+    bool isSelfCopy(const Instruction& inst) const {
+        if (!this->inRange({inst.fSlotB, inst.fImmA})) {
+            return false;
+        }
+        for (int i = 0; i < inst.fImmA; ++i) {
+            Value v = this->resolve(inst.fSlotB + i);
+            if (v.kind != Value::Kind::kCopy || v.value != inst.fSlotA + i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool rewriteReads(Instruction* inst) {
+        Slot root;
+        int32_t constant = 0;
+        switch (inst->fOp) {
+            case BuilderOp::push_slots:
+                if (!this->inRange({inst->fSlotA, inst->fImmA})) {
+                    return false;
+                }
+                if (this->isConstant({inst->fSlotA, inst->fImmA}, &constant)) {
+                    *inst = {BuilderOp::push_constant, NA, NA, inst->fImmA, constant,
+                             0, 0, inst->fStackID};
+                    return true;
+                }
+                if (this->isCopy({inst->fSlotA, inst->fImmA}, &root) && root != inst->fSlotA) {
+                    inst->fSlotA = root;
+                    return true;
+                }
+                return false;
+
+            case BuilderOp::push_immutable:
+                // A splat of a single immutable value can be pushed as a constant instead.
+                for (int i = 0; i < inst->fImmA; ++i) {
+                    const int32_t* value = fImmutableValues.find(inst->fSlotA + i);
+                    if (!value || (i > 0 && *value != constant)) {
+                        return false;
+                    }
+                    constant = *value;
+                }
+                if (inst->fImmA > 0) {
+                    *inst = {BuilderOp::push_constant, NA, NA, inst->fImmA, constant,
+                             0, 0, inst->fStackID};
+                    return true;
+                }
+                return false;
+
+            case BuilderOp::load_src:
+            case BuilderOp::load_dst:
+                if (this->inRange({inst->fSlotA, 4}) &&
+                    this->isCopy({inst->fSlotA, 4}, &root) && root != inst->fSlotA) {
+                    inst->fSlotA = root;
+                    return true;
+                }
+                return false;
+
+            case BuilderOp::copy_slot_unmasked:
+            case BuilderOp::copy_slot_masked:
+                if (!this->inRange({inst->fSlotB, inst->fImmA})) {
+                    return false;
+                }
+                if (inst->fOp == BuilderOp::copy_slot_unmasked &&
+                    this->isConstant({inst->fSlotB, inst->fImmA}, &constant)) {
+                    *inst = {BuilderOp::copy_constant, inst->fSlotA, NA, inst->fImmA, constant,
+                             0, 0, inst->fStackID};
+                    return true;
+                }
+                if (this->isCopy({inst->fSlotB, inst->fImmA}, &root) && root != inst->fSlotB &&
+                    !slot_ranges_overlap({inst->fSlotA, inst->fImmA}, {root, inst->fImmA})) {
+                    inst->fSlotB = root;
+                    return true;
+                }
+                return false;
+
+            default:
+                return false;
+        }
+    }
+
+    void forget(Slot slot) {
+        Value& v = fValues[slot];
+        if (v.kind == Value::Kind::kCopy) {
+            --fCopyCount[v.value];
+        }
+        v = {};
+    }
+
+    void set(Slot slot, Value v) {
+        this->forget(slot);
+        fValues[slot] = v;
+        if (v.kind == Value::Kind::kCopy) {
+            ++fCopyCount[v.value];
+        }
+    }
+
+    // Forgets everything known about the slots in `range`, and about slots which copied them.
+    void invalidate(SlotRange range) {
+        int begin = std::max(range.index, 0);
+        int end = std::min(range.index + range.count, fValues.size());
+        for (Slot slot = begin; slot < end; ++slot) {
+            this->forget(slot);
+            for (Slot other = 0; fCopyCount[slot] > 0 && other < fValues.size(); ++other) {
+                if (fValues[other].kind == Value::Kind::kCopy && fValues[other].value == slot) {
+                    this->forget(other);
+                }
+            }
+        }
+    }
+
+    void updateWrites(const Instruction& inst) {
+        if (inst.fOp == BuilderOp::label) {
+            // A label can be reached from elsewhere in the program.
+            this->reset();
+            return;
+        }
+        SlotAccess access;
+        SkAssertResult(get_slot_access(inst, &access));
+        if (access.write.count <= 0) {
+            return;
+        }
+        if (!access.unmasked || !this->inRange(access.write)) {
+            this->invalidate(access.write);
+            return;
+        }
+
+        // Work out the new contents before forgetting the old ones; the source may be a copy.
+        STArray<16, Value> written;
+        written.push_back_n(access.write.count);
+        for (int i = 0; i < access.write.count; ++i) {
+            switch (inst.fOp) {
+                case BuilderOp::copy_constant:
+                    written[i] = {Value::Kind::kConstant, inst.fImmB};
+                    break;
+
+                case BuilderOp::copy_slot_unmasked:
+                    if (this->inRange({inst.fSlotB + i, 1})) {
+                        written[i] = this->resolve(inst.fSlotB + i);
+                    }
+                    break;
+
+                case BuilderOp::copy_immutable_unmasked:
+                    if (const int32_t* value = fImmutableValues.find(inst.fSlotB + i)) {
+                        written[i] = {Value::Kind::kConstant, *value};
+                    }
+                    break;
+
+                default:
+                    break;
+            }
+        }
+        this->invalidate(access.write);
+        for (int i = 0; i < access.write.count; ++i) {
+            const Value& v = written[i];
+            if (v.kind == Value::Kind::kCopy &&
+                slot_ranges_overlap(access.write, {v.value, 1})) {
+                // The source was overwritten by this same instruction.
+                continue;
+            }
+            if (v.kind != Value::Kind::kUnknown) {
+                this->set(access.write.index + i, v);
+            }
+        }
+    }
+
+    TArray<Value> fValues;
+    TArray<int> fCopyCount;  // [slot] = number of slots known to hold a copy of this slot
+    THashMap<Slot, int32_t> fImmutableValues;
+};
+
+// Removes instructions whose only effect is to write value slots that no instruction ever reads,
+// and trims unread slots from the ends of copies.
+bool eliminate_dead_slot_writes(TArray<Instruction>* program, int numValueSlots) {
+    bool changed = false;
+    for (;;) {
+        TArray<bool> isRead;
+        isRead.push_back_n(numValueSlots, false);
+        for (const Instruction& inst : *program) {
+            SlotAccess access;
+            SkAssertResult(get_slot_access(inst, &access));
+            int begin = std::max(access.read.index, 0);
+            int end = std::min(access.read.index + access.read.count, numValueSlots);
+            for (Slot slot = begin; slot < end; ++slot) {
+                isRead[slot] = true;
+            }
+        }
+
+        bool removedAny = false;
+        TArray<Instruction> result;
+        result.reserve_exact(program->size());
+        for (Instruction inst : *program) {
+            SlotAccess access;
+            SkAssertResult(get_slot_access(inst, &access));
+            const SlotRange write = access.write;
+            if (!access.removable || write.index < 0 || write.count <= 0 ||
+                write.index + write.count > numValueSlots) {
+                result.push_back(inst);
+                continue;
+            }
+            int leading = 0;
+            while (leading < write.count && !isRead[write.index + leading]) {
+                ++leading;
+            }
+            if (leading == write.count) {
+                removedAny = true;
+                continue;
+            }
+            int trailing = 0;
+            while (!isRead[write.index + write.count - 1 - trailing]) {
+                ++trailing;
+            }
+            if (leading || trailing) {
+                switch (inst.fOp) {
+                    case BuilderOp::copy_constant:
+                        inst.fSlotA += leading;
+                        inst.fImmA -= leading + trailing;
+                        changed = true;
+                        break;
+
+                    case BuilderOp::copy_slot_unmasked:
+                    case BuilderOp::copy_slot_masked:
+                    case BuilderOp::copy_immutable_unmasked:
+                    case BuilderOp::copy_uniform_to_slots_unmasked:
+                        inst.fSlotA += leading;
+                        inst.fSlotB += leading;
+                        inst.fImmA -= leading + trailing;
+                        changed = true;
+                        break;
+
+                    case BuilderOp::copy_stack_to_slots:
+                    case BuilderOp::copy_stack_to_slots_unmasked:
+                        inst.fSlotA += leading;
+                        inst.fImmA -= leading + trailing;
+                        inst.fImmB -= leading;
+                        changed = true;
+                        break;
+
+                    default:
+                        break;
+                }
+            }
+            result.push_back(inst);
+        }
+        *program = std::move(result);
+        if (!removedAny) {
+            return changed;
+        }
+        changed = true;
+    }
+}
+
+}  // namespace
+
+void Builder::reappendInstruction(const Instruction& inst) {
+    this->set_current_stack(inst.fStackID);
+    switch (inst.fOp) {
+        case BuilderOp::push_slots:
+        case BuilderOp::push_immutable:
+            this->push_slots_or_immutable({inst.fSlotA, inst.fImmA}, inst.fOp);
+            break;
+
+        case BuilderOp::push_constant:
+            this->push_constant_i(inst.fImmB, inst.fImmA);
+            break;
+
+        case BuilderOp::push_uniform:
+            this->push_uniform({inst.fSlotA, inst.fImmA});
+            break;
+
+        case BuilderOp::discard_stack:
+            this->discard_stack(inst.fImmA, inst.fStackID);
+            break;
+
+        case BuilderOp::copy_constant:
+            for (int i = 0; i < inst.fImmA; ++i) {
+                this->copy_constant(inst.fSlotA + i, inst.fImmB);
+            }
+            break;
+
+        case BuilderOp::copy_slot_unmasked:
+            this->copy_slots_unmasked({inst.fSlotA, inst.fImmA}, {inst.fSlotB, inst.fImmA});
+            break;
+
+        case BuilderOp::copy_immutable_unmasked:
+            this->copy_immutable_unmasked({inst.fSlotA, inst.fImmA}, {inst.fSlotB, inst.fImmA});
+            break;
+
+        case BuilderOp::copy_uniform_to_slots_unmasked:
+            this->copy_uniform_to_slots_unmasked({inst.fSlotB, inst.fImmA},
+                                                 {inst.fSlotA, inst.fImmA});
+            break;
+
+        case BuilderOp::copy_stack_to_slots_unmasked:
+            this->copy_stack_to_slots_unmasked({inst.fSlotA, inst.fImmA}, inst.fImmB);
+            break;
+
+        case ALL_N_WAY_BINARY_OP_CASES:
+        case ALL_MULTI_SLOT_BINARY_OP_CASES:
+            this->binary_op(inst.fOp, inst.fImmA);
+            break;
+
+        case BuilderOp::exchange_src:
+            this->exchange_src();
+            break;
+
+        case BuilderOp::pop_src_rgba:
+            this->pop_src_rgba();
+            break;
+
+        case BuilderOp::label:
+            this->label(inst.fImmA);
+            break;
+
+        case BuilderOp::jump:
+            this->jump(inst.fImmA);
+            break;
+
+        default:
+            fInstructions.push_back(inst);
+            break;
+    }
+}
+
+void Builder::optimize(int numValueSlots) {
+    // Bail out if any instruction touches the value slots in a way we can't reason about.
+    for (const Instruction& inst : fInstructions) {
+        SlotAccess access;
+        if (!get_slot_access(inst, &access)) {
+            return;
+        }
+    }
+
+    static constexpr int kMaxPasses = 4;
+    for (int pass = 0; pass < kMaxPasses; ++pass) {
+        SlotValuePropagator propagator(fInstructions, numValueSlots);
+        bool changed = propagator.run(&fInstructions);
+        changed |= eliminate_dead_slot_writes(&fInstructions, numValueSlots);
+        if (!changed) {
+            break;
+        }
+
+        // Feed the rewritten program back through the Builder, so that its peephole optimizations
+        // can fuse the instructions which are now adjacent (e.g. a push of a constant followed by
+        // a binary op becomes an immediate-mode op).
+        TArray<Instruction> program = std::move(fInstructions);
+        fInstructions.clear();
+        for (const Instruction& inst : program) {
+            this->reappendInstruction(inst);
+        }
+    }
+    fCurrentStackID = 0;
+}
+
 std::unique_ptr<Program> Builder::finish(int numValueSlots,
                                          int numUniformSlots,
                                          int numImmutableSlots,
@@ -1270,6 +1835,11 @@ std::unique_ptr<Program> Builder::finish(int numValueSlots,
     // Verify that calls to enableExecutionMaskWrites and disableExecutionMaskWrites are balanced.
     SkASSERT(fExecutionMaskWritesEnabled == 0);
 
+    // Traced programs must keep every variable up to date, so they are left unoptimized.
+    if (!debugTrace) {
+        this->optimize(numValueSlots);
+    }
+
     return std::make_unique<Program>(std::move(fInstructions), numValueSlots, numUniformSlots,
                                      numImmutableSlots, fNumLabels, debugTrace);
 }
@@ -1412,6 +1982,464 @@ Program::Program(TArray<Instruction> instrs,
 
 Program::~Program() = default;
 
+// Bump this whenever BuilderOp, Instruction or the meaning of an instruction's fields changes.
+static constexpr uint32_t kSerializedProgramVersion = 1;
+static constexpr uint32_t kSerializedProgramMagic = SkSetFourByteTag('S', 'K', 'R', 'P');
+static constexpr int kBuilderOpCount = (int)BuilderOp::unsupported + 1;
+
+// The deepest a temp stack may get in a deserialized program, in slots. The code generator
+// stays far below this; it keeps a corrupt program from asking for an enormous stack.
+static constexpr int64_t kMaxDeserializedStackDepth = 1 << 20;
+
+// The most value, uniform or immutable slots, or labels, a deserialized program may have. Like
+// the stack limit, this keeps a corrupt program from asking for an enormous allocation.
+static constexpr int64_t kMaxDeserializedCount = 1 << 20;
+
+static bool in_deserialized_range(int32_t count) {
+    return count >= 0 && count <= kMaxDeserializedCount;
+}
+
+// How many value and immutable slots a program's instructions refer to: one past the highest slot
+// that any instruction reads or writes.
+struct SlotUsage {
+    int64_t fValueSlots = 0;
+    int64_t fImmutableSlots = 0;
+};
+
+// Checks that every operand of every instruction refers to slots, labels, stacks and children
+// that exist, and that each stack is balanced and never popped past its bottom, so that
+// makeStages() cannot read or write out of bounds. This mirrors the cases of makeStages().
+// Records the slots the instructions refer to in 'usage'.
+static bool validate_instructions(SkSpan<const Instruction> instructions,
+                                  int numValueSlots,
+                                  int numUniformSlots,
+                                  int numImmutableSlots,
+                                  int numLabels,
+                                  int numChildren,
+                                  SlotUsage* usage) {
+    *usage = {};
+    int numStacks = 1;
+    for (const Instruction& inst : instructions) {
+        if (inst.fStackID < 0 || inst.fStackID >= SkToInt(instructions.size())) {
+            return false;
+        }
+        numStacks = std::max(numStacks, inst.fStackID + 1);
+    }
+    TArray<int64_t> depths;
+    depths.push_back_n(numStacks, int64_t{0});
+    TArray<bool> labelDefined, labelUsed;
+    labelDefined.push_back_n(numLabels, false);
+    labelUsed.push_back_n(numLabels, false);
+
+    auto inRange = [](int64_t start, int64_t count, int64_t limit) {
+        return start >= 0 && count >= 0 && start + count <= limit;
+    };
+    auto inSlots = [&](int64_t start, int64_t count, int64_t limit, int64_t* used) {
+        if (!inRange(start, count, limit)) {
+            return false;
+        }
+        *used = std::max(*used, start + count);
+        return true;
+    };
+    auto valueSlots = [&](int64_t start, int64_t count) {
+        return inSlots(start, count, numValueSlots, &usage->fValueSlots);
+    };
+    auto uniformSlots = [&](int64_t start, int64_t count) {
+        return inRange(start, count, numUniformSlots);
+    };
+    auto immutableSlots = [&](int64_t start, int64_t count) {
+        return inSlots(start, count, numImmutableSlots, &usage->fImmutableSlots);
+    };
+    auto validStack = [&](int stackID) { return stackID >= 0 && stackID < numStacks; };
+    auto useLabel = [&](int labelID) {
+        if (labelID < 0 || labelID >= numLabels) {
+            return false;
+        }
+        labelUsed[labelID] = true;
+        return true;
+    };
+    // Every nybble of a packed swizzle must pick one of 'limit' slots.
+    auto validNybbles = [](uint32_t components, int numComponents, int limit) {
+        for (int index = 0; index < numComponents; ++index) {
+            if ((int)(components & 0xF) >= limit) {
+                return false;
+            }
+            components >>= 4;
+        }
+        return true;
+    };
+    // An indirect copy between [slotA, slotB) of the space checked by 'slots', and 'count' slots.
+    auto validIndirectRange = [&](const Instruction& inst, int64_t count, auto slots) {
+        return slots(inst.fSlotA, inst.fSlotB - (int64_t)inst.fSlotA) &&
+               inRange(inst.fSlotA, count, inst.fSlotB) && validStack(inst.fImmB) &&
+               depths[inst.fImmB] >= 1;
+    };
+
+    for (const Instruction& inst : instructions) {
+        const int64_t depth = depths[inst.fStackID];
+        bool valid;
+        switch (inst.fOp) {
+            case BuilderOp::label:
+                valid = inst.fImmA >= 0 && inst.fImmA < numLabels && !labelDefined[inst.fImmA];
+                if (valid) {
+                    labelDefined[inst.fImmA] = true;
+                }
+                break;
+
+            case BuilderOp::jump:
+            case BuilderOp::branch_if_any_lanes_active:
+            case BuilderOp::branch_if_no_lanes_active:
+            case BuilderOp::branch_if_all_lanes_active:
+                valid = useLabel(inst.fImmA);
+                break;
+
+            case BuilderOp::branch_if_no_active_lanes_on_stack_top_equal:
+                valid = useLabel(inst.fImmA) && depth >= 1;
+                break;
+
+            case BuilderOp::init_lane_masks:
+            case BuilderOp::mask_off_loop_mask:
+            case BuilderOp::mask_off_return_mask:
+            case BuilderOp::push_condition_mask:
+            case BuilderOp::push_loop_mask:
+            case BuilderOp::push_return_mask:
+            case BuilderOp::push_src_rgba:
+            case BuilderOp::push_dst_rgba:
+            case BuilderOp::push_device_xy01:
+                valid = true;
+                break;
+
+            case BuilderOp::store_src_rg:
+                valid = valueSlots(inst.fSlotA, 2);
+                break;
+
+            case BuilderOp::store_src:
+            case BuilderOp::store_dst:
+            case BuilderOp::store_device_xy01:
+            case BuilderOp::load_src:
+            case BuilderOp::load_dst:
+                valid = valueSlots(inst.fSlotA, 4);
+                break;
+
+            case BuilderOp::store_immutable_value:
+                valid = immutableSlots(inst.fSlotA, 1);
+                break;
+
+            case BuilderOp::reenable_loop_mask:
+                valid = valueSlots(inst.fSlotA, 1);
+                break;
+
+            case ALL_SINGLE_SLOT_UNARY_OP_CASES:
+            case ALL_MULTI_SLOT_UNARY_OP_CASES:
+                valid = inst.fImmA >= 1 && depth >= inst.fImmA;
+                break;
+
+            case ALL_IMMEDIATE_BINARY_OP_CASES:
+                valid = inst.fImmA >= 1 && (inst.fSlotA == NA
+                                                    ? depth >= inst.fImmA
+                                                    : valueSlots(inst.fSlotA, inst.fImmA));
+                break;
+
+            case ALL_N_WAY_BINARY_OP_CASES:
+            case ALL_MULTI_SLOT_BINARY_OP_CASES:
+            case BuilderOp::select:
+                valid = inst.fImmA >= 1 && depth >= 2 * (int64_t)inst.fImmA;
+                break;
+
+            case ALL_N_WAY_TERNARY_OP_CASES:
+            case ALL_MULTI_SLOT_TERNARY_OP_CASES:
+                valid = inst.fImmA >= 1 && depth >= 3 * (int64_t)inst.fImmA;
+                break;
+
+            case BuilderOp::copy_slot_masked:
+            case BuilderOp::copy_slot_unmasked:
+                valid = valueSlots(inst.fSlotA, inst.fImmA) &&
+                        valueSlots(inst.fSlotB, inst.fImmA);
+                break;
+
+            case BuilderOp::copy_immutable_unmasked:
+                valid = valueSlots(inst.fSlotA, inst.fImmA) &&
+                        immutableSlots(inst.fSlotB, inst.fImmA);
+                break;
+
+            case BuilderOp::refract_4_floats:
+                valid = depth >= 9;
+                break;
+
+            case BuilderOp::inverse_mat2:
+            case BuilderOp::inverse_mat3:
+            case BuilderOp::inverse_mat4: {
+                const int n = 2 + (int)inst.fOp - (int)BuilderOp::inverse_mat2;
+                valid = inst.fImmA == n * n && depth >= inst.fImmA;
+                break;
+            }
+            case BuilderOp::dot_2_floats:
+            case BuilderOp::dot_3_floats:
+            case BuilderOp::dot_4_floats: {
+                const int n = 2 + (int)inst.fOp - (int)BuilderOp::dot_2_floats;
+                valid = inst.fImmA == n && depth >= 2 * n;
+                break;
+            }
+            case BuilderOp::swizzle_1:
+                // A single-component swizzle holds a plain offset instead of a packed nybble.
+                valid = inst.fImmA >= 1 && inst.fImmA <= 16 && depth >= inst.fImmA &&
+                        inst.fImmB >= 0 && inst.fImmB < inst.fImmA;
+                break;
+
+            case BuilderOp::swizzle_2:
+            case BuilderOp::swizzle_3:
+            case BuilderOp::swizzle_4: {
+                const int n = 1 + (int)inst.fOp - (int)BuilderOp::swizzle_1;
+                valid = inst.fImmA >= 1 && inst.fImmA <= 16 && depth >= inst.fImmA &&
+                        validNybbles(inst.fImmB, n, inst.fImmA);
+                break;
+            }
+            case BuilderOp::shuffle:
+                valid = inst.fImmA >= 1 && inst.fImmA <= 16 && depth >= inst.fImmA &&
+                        inst.fImmB >= 1 && inst.fImmB <= 16 &&
+                        validNybbles(inst.fImmC, std::min(inst.fImmB, 8), inst.fImmA) &&
+                        validNybbles(inst.fImmD, std::max(inst.fImmB - 8, 0), inst.fImmA);
+                break;
+
+            case BuilderOp::matrix_multiply_2:
+            case BuilderOp::matrix_multiply_3:
+            case BuilderOp::matrix_multiply_4:
+                valid = inst.fImmA >= 1 && inst.fImmA <= 4 && inst.fImmB >= 1 &&
+                        inst.fImmB <= 4 && inst.fImmC >= 1 && inst.fImmC <= 4 &&
+                        inst.fImmD >= 1 && inst.fImmD <= 4 &&
+                        depth >= inst.fImmB * inst.fImmC + inst.fImmA * inst.fImmB +
+                                 inst.fImmC * inst.fImmD;
+                break;
+
+            case BuilderOp::exchange_src:
+            case BuilderOp::pop_src_rgba:
+            case BuilderOp::pop_dst_rgba:
+                valid = depth >= 4;
+                break;
+
+            case BuilderOp::push_slots:
+                valid = valueSlots(inst.fSlotA, inst.fImmA);
+                break;
+
+            case BuilderOp::push_immutable:
+                valid = immutableSlots(inst.fSlotA, inst.fImmA);
+                break;
+
+            case BuilderOp::push_uniform:
+                valid = uniformSlots(inst.fSlotA, inst.fImmA);
+                break;
+
+            case BuilderOp::copy_uniform_to_slots_unmasked:
+                valid = uniformSlots(inst.fSlotA, inst.fImmA) &&
+                        valueSlots(inst.fSlotB, inst.fImmA);
+                break;
+
+            case BuilderOp::push_slots_indirect:
+                valid = validIndirectRange(inst, inst.fImmA, valueSlots);
+                break;
+
+            case BuilderOp::push_immutable_indirect:
+                valid = validIndirectRange(inst, inst.fImmA, immutableSlots);
+                break;
+
+            case BuilderOp::push_uniform_indirect:
+                valid = validIndirectRange(inst, inst.fImmA, uniformSlots);
+                break;
+
+            case BuilderOp::copy_stack_to_slots_indirect:
+                valid = validIndirectRange(inst, inst.fImmA, valueSlots) &&
+                        depth >= inst.fImmA;
+                break;
+
+            case BuilderOp::pop_condition_mask:
+            case BuilderOp::pop_loop_mask:
+            case BuilderOp::pop_and_reenable_loop_mask:
+            case BuilderOp::pop_return_mask:
+            case BuilderOp::merge_loop_mask:
+                valid = depth >= 1;
+                break;
+
+            case BuilderOp::merge_condition_mask:
+            case BuilderOp::merge_inv_condition_mask:
+            case BuilderOp::case_op:
+                valid = depth >= 2;
+                break;
+
+            case BuilderOp::copy_constant:
+                valid = valueSlots(inst.fSlotA, inst.fImmA);
+                break;
+
+            case BuilderOp::push_constant:
+            case BuilderOp::pad_stack:
+                valid = inst.fImmA >= 0 && inst.fImmA <= kMaxDeserializedStackDepth;
+                break;
+
+            case BuilderOp::discard_stack:
+                valid = inst.fImmA >= 0 && depth >= inst.fImmA;
+                break;
+
+            case BuilderOp::copy_stack_to_slots:
+            case BuilderOp::copy_stack_to_slots_unmasked:
+                valid = valueSlots(inst.fSlotA, inst.fImmA) &&
+                        inst.fImmB >= inst.fImmA && depth >= inst.fImmB;
+                break;
+
+            case BuilderOp::swizzle_copy_stack_to_slots:
+                valid = inst.fImmA >= 1 && inst.fImmA <= 4 &&
+                        inst.fImmC >= inst.fImmA && depth >= inst.fImmC &&
+                        valueSlots(inst.fSlotA, max_packed_nybble(inst.fImmB, inst.fImmA) + 1);
+                break;
+
+            case BuilderOp::swizzle_copy_stack_to_slots_indirect:
+                valid = inst.fImmA >= 1 && inst.fImmA <= 4 &&
+                        inst.fImmC >= inst.fImmA && depth >= inst.fImmC &&
+                        valueSlots(inst.fSlotA, inst.fSlotB - (int64_t)inst.fSlotA) &&
+                        inRange(inst.fSlotA, max_packed_nybble(inst.fImmB, inst.fImmA) + 1,
+                                inst.fSlotB) &&
+                        validStack(inst.fImmD) && depths[inst.fImmD] >= 1;
+                break;
+
+            case BuilderOp::push_clone:
+                valid = inst.fImmA >= 0 && inst.fImmB >= inst.fImmA && depth >= inst.fImmB;
+                break;
+
+            case BuilderOp::push_clone_from_stack:
+                valid = inst.fImmA >= 0 && validStack(inst.fImmB) && inst.fImmC >= inst.fImmA &&
+                        depths[inst.fImmB] >= inst.fImmC;
+                break;
+
+            case BuilderOp::push_clone_indirect_from_stack:
+                valid = inst.fImmA >= 0 && validStack(inst.fImmB) && inst.fImmC >= inst.fImmA &&
+                        depths[inst.fImmB] >= inst.fImmC && validStack(inst.fImmD) &&
+                        depths[inst.fImmD] >= 1;
+                break;
+
+            case BuilderOp::continue_op:
+                valid = validStack(inst.fImmA) && depths[inst.fImmA] >= 1;
+                break;
+
+            case BuilderOp::invoke_shader:
+            case BuilderOp::invoke_color_filter:
+            case BuilderOp::invoke_blender:
+                valid = inst.fImmA >= 0 && inst.fImmA < numChildren;
+                break;
+
+            case BuilderOp::invoke_to_linear_srgb:
+            case BuilderOp::invoke_from_linear_srgb:
+                valid = validStack(inst.fImmA) && depths[inst.fImmA] >= 4;
+                break;
+
+            default:
+                // Trace ops need a debug trace, which is never serialized, and anything else is
+                // not an op that the code generator emits.
+                valid = false;
+                break;
+        }
+        if (!valid) {
+            return false;
+        }
+
+        int64_t& newDepth = depths[inst.fStackID];
+        newDepth += stack_usage(inst);
+        if (newDepth < 0 || newDepth > kMaxDeserializedStackDepth) {
+            return false;
+        }
+    }
+
+    for (int64_t depth : depths) {
+        if (depth != 0) {
+            return false;
+        }
+    }
+    for (int labelID = 0; labelID < numLabels; ++labelID) {
+        if (labelUsed[labelID] && !labelDefined[labelID]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Program::serialize(SkWStream* out) const {
+    // Deserialize() insists that the value and immutable slot counts match the slots the
+    // instructions refer to, so slots past those are dropped (nothing reads or writes them).
+    SlotUsage usage;
+    if (fDebugTrace ||
+        !validate_instructions(fInstructions, fNumValueSlots, fNumUniformSlots,
+                               fNumImmutableSlots, fNumLabels,
+                               std::numeric_limits<int>::max(), &usage)) {
+        return false;
+    }
+    bool ok = out->write32(kSerializedProgramMagic) &&
+              out->write32(kSerializedProgramVersion) &&
+              out->write32(SK_MILESTONE) &&
+              out->write32(kBuilderOpCount) &&
+              out->write32(SkToS32(usage.fValueSlots)) &&
+              out->write32(fNumUniformSlots) &&
+              out->write32(SkToS32(usage.fImmutableSlots)) &&
+              out->write32(fNumLabels) &&
+              out->write32(fInstructions.size());
+    for (const Instruction& inst : fInstructions) {
+        ok = ok && out->write32((uint32_t)inst.fOp) &&
+                   out->write32(inst.fSlotA) &&
+                   out->write32(inst.fSlotB) &&
+                   out->write32(inst.fImmA) &&
+                   out->write32(inst.fImmB) &&
+                   out->write32(inst.fImmC) &&
+                   out->write32(inst.fImmD) &&
+                   out->write32(inst.fStackID);
+    }
+    return ok;
+}
+
+std::unique_ptr<Program> Program::Deserialize(const void* data, size_t length,
+                                                  int numChildren) {
+    SkRBuffer buffer(data, length);
+    uint32_t magic, version, milestone, opCount, instructionCount;
+    int32_t numValueSlots, numUniformSlots, numImmutableSlots, numLabels;
+    if (!buffer.readU32(&magic) || magic != kSerializedProgramMagic ||
+        !buffer.readU32(&version) || version != kSerializedProgramVersion ||
+        !buffer.readU32(&milestone) || milestone != SK_MILESTONE ||
+        !buffer.readU32(&opCount) || opCount != (uint32_t)kBuilderOpCount ||
+        !buffer.readS32(&numValueSlots) || !in_deserialized_range(numValueSlots) ||
+        !buffer.readS32(&numUniformSlots) || !in_deserialized_range(numUniformSlots) ||
+        !buffer.readS32(&numImmutableSlots) || !in_deserialized_range(numImmutableSlots) ||
+        !buffer.readS32(&numLabels) || !in_deserialized_range(numLabels) ||
+        !buffer.readU32(&instructionCount) ||
+        buffer.available() != (uint64_t)instructionCount * 8 * sizeof(int32_t)) {
+        return nullptr;
+    }
+
+    TArray<Instruction> instructions;
+    instructions.reserve_exact(instructionCount);
+    for (uint32_t i = 0; i < instructionCount; ++i) {
+        uint32_t op;
+        Instruction inst;
+        buffer.readU32(&op);
+        if (op >= (uint32_t)kBuilderOpCount) {
+            return nullptr;
+        }
+        inst.fOp = (BuilderOp)op;
+        buffer.readS32(&inst.fSlotA);
+        buffer.readS32(&inst.fSlotB);
+        buffer.readS32(&inst.fImmA);
+        buffer.readS32(&inst.fImmB);
+        buffer.readS32(&inst.fImmC);
+        buffer.readS32(&inst.fImmD);
+        buffer.readS32(&inst.fStackID);
+        instructions.push_back(inst);
+    }
+    SkASSERT(buffer.isValid() && buffer.available() == 0);
+    // Uniform slots may go unused; the caller checks their count against the effect's uniforms.
+    SlotUsage usage;
+    if (!validate_instructions(instructions, numValueSlots, numUniformSlots, numImmutableSlots,
+                               numLabels, numChildren, &usage) ||
+        usage.fValueSlots != numValueSlots || usage.fImmutableSlots != numImmutableSlots) {
+        return nullptr;
+    }
+    return std::make_unique<Program>(std::move(instructions), numValueSlots, numUniformSlots,
+                                     numImmutableSlots, numLabels, /*debugTrace=*/nullptr);
+}
+
 static bool immutable_data_is_splattable(int32_t* immutablePtr, int numSlots) {
     // If every value between `immutablePtr[0]` and `immutablePtr[numSlots]` is bit-identical, we
     // can use a splat.
@@ -1698,6 +2726,11 @@ bool Program::appendStages(SkRasterPipeline* pipeline,
         return false;
     }
     this->makeStages(&stages, alloc, uniforms, *slotData);
+#if defined(SKSL_RP_JIT)
+    if (!fDebugTrace) {
+        this->fuseNativeCode(&stages, alloc, uniforms, *slotData);
+    }
+#endif
 
     // Allocate buffers for branch targets and labels; these are needed to convert labels into
     // actual offsets into the pipeline and fix up branches.
@@ -1808,6 +2841,47 @@ bool Program::appendStages(SkRasterPipeline* pipeline,
 #endif
 }
 
+#if defined(SKSL_RP_JIT)
+void Program::fuseNativeCode(TArray<Stage>* pipeline,
+                             SkArenaAlloc* alloc,
+                             SkSpan<const float> uniforms,
+                             const SlotData& slots) const {
+    // makeStages produces the same stages for every call, apart from the slot and uniform
+    // pointers; the native code only depends on offsets from those, so it is compiled once.
+    fNativeCodeOnce([&] {
+        NativeCodeBuilder builder((const std::byte*)slots.values.data(),
+                                  uniforms.data(),
+                                  SkOpts::raster_pipeline_highp_stride);
+        for (const Stage& stage : *pipeline) {
+            builder.appendStage(stage.op, stage.ctx);
+        }
+        fNativeCode = builder.finish();
+    });
+    if (!fNativeCode) {
+        return;
+    }
+    SkASSERT(fNativeCode->numStages() == pipeline->size());
+
+    TArray<Stage> fused;
+    fused.reserve_exact(pipeline->size());
+    int index = 0;
+    for (const NativeCode::Run& run : fNativeCode->runs()) {
+        for (; index < run.fFirstStage; ++index) {
+            fused.push_back((*pipeline)[index]);
+        }
+        auto* ctx = alloc->make<SkRasterPipelineContexts::NativeCodeCtx>();
+        ctx->fn = run.fFn;
+        ctx->uniforms = uniforms.data();
+        fused.push_back({ProgramOp::native_code, ctx});
+        index += run.fNumStages;
+    }
+    for (; index < pipeline->size(); ++index) {
+        fused.push_back((*pipeline)[index]);
+    }
+    *pipeline = std::move(fused);
+}
+#endif
+
 void Program::makeStages(TArray<Stage>* pipeline,
                          SkArenaAlloc* alloc,
                          SkSpan<const float> uniforms,
@@ -12,9 +12,11 @@
 
 #include "include/core/SkSpan.h"
 #include "include/core/SkTypes.h"
+#include "include/private/base/SkOnce.h"
 #include "include/private/base/SkTArray.h"
 #include "src/base/SkUtils.h"
 #include "src/core/SkRasterPipelineOpList.h"
+#include "src/sksl/codegen/SkSLRasterPipelineJIT.h"
 
 #include <cstddef>
 #include <cstdint>
@@ -167,6 +169,19 @@ public:
 
     void dump(SkWStream* out, bool writeInstructionCount = false) const;
 
+    /**
+     * Writes the program's instructions so that Deserialize() can recreate it without running
+     * the code generator again. Programs that carry a debug trace cannot be serialized. The
+     * format is tagged with a version and the Skia milestone, and Deserialize() rejects data
+     * from any other version. Deserialize() also checks every instruction's slots, labels, stacks
+     * and child indices (against 'numChildren') and rejects the whole program if any is out of
+     * range, or if its value or immutable slot counts differ from the slots its instructions
+     * refer to, so corrupt data never reaches makeStages().
+     */
+    bool serialize(SkWStream* out) const;
+    static std::unique_ptr<Program> Deserialize(const void* data, size_t length,
+                                                int numChildren);
+
     int numUniforms() const { return fNumUniformSlots; }
 
 private:
@@ -280,6 +295,15 @@ private:
     // Appends a stack_rewind op unilaterally.
     void appendStackRewind(skia_private::TArray<Stage>* pipeline) const;
 
+#if defined(SKSL_RP_JIT)
+    // Replaces runs of stages that NativeCodeBuilder can compile with `native_code` stages. The
+    // machine code is generated by the first call and shared by every pipeline built afterwards.
+    void fuseNativeCode(skia_private::TArray<Stage>* pipeline,
+                        SkArenaAlloc* alloc,
+                        SkSpan<const float> uniforms,
+                        const SlotData& slots) const;
+#endif
+
     class Dumper;
     friend class Dumper;
 
@@ -292,6 +316,10 @@ private:
     StackDepths fTempStackMaxDepths;
     DebugTracePriv* fDebugTrace = nullptr;
     std::unique_ptr<SkSL::TraceHook> fTraceHook;
+#if defined(SKSL_RP_JIT)
+    mutable SkOnce fNativeCodeOnce;
+    mutable std::unique_ptr<NativeCode> fNativeCode;
+#endif
 };
 
 class Builder {
@@ -724,6 +752,12 @@ private:
     void simplifyPopSlotsUnmasked(SlotRange* dst);
     bool simplifyImmediateUnmaskedOp();
 
+    // Whole-program optimizations which run once the program is complete: value-slot copy and
+    // constant propagation and dead-write elimination, followed by re-running the peephole
+    // simplifications above over the result.
+    void optimize(int numValueSlots);
+    void reappendInstruction(const Instruction& inst);
+
     skia_private::TArray<Instruction> fInstructions;
     int fNumLabels = 0;
     int fExecutionMaskWritesEnabled = 0;
@@ -0,0 +1,473 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#include "src/sksl/codegen/SkSLRasterPipelineJIT.h"
+
+#if defined(SKSL_RP_JIT)
+
+#include "src/core/SkRasterPipelineContextUtils.h"
+#include "src/core/SkRasterPipelineOpContexts.h"
+#include "src/sksl/codegen/SkSLRasterPipelineBuilder.h"
+
+#if defined(SK_BUILD_FOR_WIN)
+#include "src/base/SkLeanWindows.h"
+#else
+#include <sys/mman.h>
+#endif
+
+#include <cstring>
+
+using namespace skia_private;
+
+namespace SkSL {
+namespace RP {
+
+namespace {
+
+// The generated code only uses registers that are volatile in both x86-64 calling conventions.
+constexpr int kXmm0 = 0;
+constexpr int kXmm1 = 1;
+constexpr int kXmm2 = 2;
+constexpr int kRax = 0;
+#if defined(SK_BUILD_FOR_WIN)
+constexpr int kBaseReg = 1;     // rcx
+constexpr int kUniformReg = 2;  // rdx
+#else
+constexpr int kBaseReg = 7;     // rdi
+constexpr int kUniformReg = 6;  // rsi
+#endif
+
+// Every slot is `stride` lanes wide, and the stride is a multiple of four, so slots are processed
+// in 16-byte chunks.
+constexpr int kChunkSize = 16;
+
+// Offsets beyond this are left to the interpreter, which keeps every displacement (including the
+// chunks within a multi-slot op) comfortably inside a signed 32-bit immediate.
+constexpr int64_t kMaxOffset = 1 << 28;
+
+// Binary ops compute `xmm0 = xmm0 <op> xmm1`. xmm1 is left intact and xmm2 may be clobbered.
+enum class Kernel {
+    kAddFloat, kSubFloat, kMulFloat, kDivFloat, kMinFloat, kMaxFloat,
+    kCmpLtFloat, kCmpLeFloat, kCmpEqFloat, kCmpNeFloat,
+    kAddInt, kSubInt, kBitwiseAnd, kBitwiseOr, kBitwiseXor,
+    kCmpLtInt, kCmpLeInt, kCmpEqInt, kCmpNeInt,
+};
+
+enum class Form {
+    kImmediate,        // ConstantCtx: `numSlots` slots at `dst`, combined with a constant
+    kAdjacent,         // F* dst: `numSlots` slots at `dst`, combined with the slots that follow
+    kAdjacentPacked,   // BinaryOpCtx: the slots in [dst, src), combined with the slots at src
+};
+
+struct BinaryOpInfo {
+    Kernel kernel;
+    Form   form;
+    int    numSlots;
+};
+
+// Only ops that SSE2 implements with exactly the interpreter's semantics are listed here. Notably,
+// minps and maxps match the highp min() and max() on x86, including their handling of NaN.
+bool binary_op_info(ProgramOp op, BinaryOpInfo* info) {
+    #define ADJACENT_FLOAT_OPS(name, kernel)                                                      \
+        case ProgramOp::name##_float:    *info = {kernel, Form::kAdjacent, 1};       return true; \
+        case ProgramOp::name##_2_floats: *info = {kernel, Form::kAdjacent, 2};       return true; \
+        case ProgramOp::name##_3_floats: *info = {kernel, Form::kAdjacent, 3};       return true; \
+        case ProgramOp::name##_4_floats: *info = {kernel, Form::kAdjacent, 4};       return true; \
+        case ProgramOp::name##_n_floats: *info = {kernel, Form::kAdjacentPacked, 0}; return true;
+
+    #define ADJACENT_INT_OPS(name, kernel)                                                        \
+        case ProgramOp::name##_int:      *info = {kernel, Form::kAdjacent, 1};       return true; \
+        case ProgramOp::name##_2_ints:   *info = {kernel, Form::kAdjacent, 2};       return true; \
+        case ProgramOp::name##_3_ints:   *info = {kernel, Form::kAdjacent, 3};       return true; \
+        case ProgramOp::name##_4_ints:   *info = {kernel, Form::kAdjacent, 4};       return true; \
+        case ProgramOp::name##_n_ints:   *info = {kernel, Form::kAdjacentPacked, 0}; return true;
+
+    #define IMMEDIATE_OP(name, kernel, slots) \
+        case ProgramOp::name: *info = {kernel, Form::kImmediate, slots}; return true;
+
+    switch (op) {
+        ADJACENT_FLOAT_OPS(add,   Kernel::kAddFloat)
+        ADJACENT_FLOAT_OPS(sub,   Kernel::kSubFloat)
+        ADJACENT_FLOAT_OPS(mul,   Kernel::kMulFloat)
+        ADJACENT_FLOAT_OPS(div,   Kernel::kDivFloat)
+        ADJACENT_FLOAT_OPS(min,   Kernel::kMinFloat)
+        ADJACENT_FLOAT_OPS(max,   Kernel::kMaxFloat)
+        ADJACENT_FLOAT_OPS(cmplt, Kernel::kCmpLtFloat)
+        ADJACENT_FLOAT_OPS(cmple, Kernel::kCmpLeFloat)
+        ADJACENT_FLOAT_OPS(cmpeq, Kernel::kCmpEqFloat)
+        ADJACENT_FLOAT_OPS(cmpne, Kernel::kCmpNeFloat)
+
+        ADJACENT_INT_OPS(add,         Kernel::kAddInt)
+        ADJACENT_INT_OPS(sub,         Kernel::kSubInt)
+        ADJACENT_INT_OPS(bitwise_and, Kernel::kBitwiseAnd)
+        ADJACENT_INT_OPS(bitwise_or,  Kernel::kBitwiseOr)
+        ADJACENT_INT_OPS(bitwise_xor, Kernel::kBitwiseXor)
+        ADJACENT_INT_OPS(cmplt,       Kernel::kCmpLtInt)
+        ADJACENT_INT_OPS(cmple,       Kernel::kCmpLeInt)
+        ADJACENT_INT_OPS(cmpeq,       Kernel::kCmpEqInt)
+        ADJACENT_INT_OPS(cmpne,       Kernel::kCmpNeInt)
+
+        IMMEDIATE_OP(add_imm_float,          Kernel::kAddFloat,   1)
+        IMMEDIATE_OP(mul_imm_float,          Kernel::kMulFloat,   1)
+        IMMEDIATE_OP(min_imm_float,          Kernel::kMinFloat,   1)
+        IMMEDIATE_OP(max_imm_float,          Kernel::kMaxFloat,   1)
+        IMMEDIATE_OP(cmplt_imm_float,        Kernel::kCmpLtFloat, 1)
+        IMMEDIATE_OP(cmple_imm_float,        Kernel::kCmpLeFloat, 1)
+        IMMEDIATE_OP(cmpeq_imm_float,        Kernel::kCmpEqFloat, 1)
+        IMMEDIATE_OP(cmpne_imm_float,        Kernel::kCmpNeFloat, 1)
+        IMMEDIATE_OP(add_imm_int,            Kernel::kAddInt,     1)
+        IMMEDIATE_OP(bitwise_and_imm_int,    Kernel::kBitwiseAnd, 1)
+        IMMEDIATE_OP(bitwise_and_imm_2_ints, Kernel::kBitwiseAnd, 2)
+        IMMEDIATE_OP(bitwise_and_imm_3_ints, Kernel::kBitwiseAnd, 3)
+        IMMEDIATE_OP(bitwise_and_imm_4_ints, Kernel::kBitwiseAnd, 4)
+        IMMEDIATE_OP(bitwise_xor_imm_int,    Kernel::kBitwiseXor, 1)
+        IMMEDIATE_OP(cmplt_imm_int,          Kernel::kCmpLtInt,   1)
+        IMMEDIATE_OP(cmple_imm_int,          Kernel::kCmpLeInt,   1)
+        IMMEDIATE_OP(cmpeq_imm_int,          Kernel::kCmpEqInt,   1)
+        IMMEDIATE_OP(cmpne_imm_int,          Kernel::kCmpNeInt,   1)
+
+        default:
+            return false;
+    }
+
+    #undef ADJACENT_FLOAT_OPS
+    #undef ADJACENT_INT_OPS
+    #undef IMMEDIATE_OP
+}
+
+}  // namespace
+
+NativeCode::~NativeCode() {
+    if (fMemory) {
+#if defined(SK_BUILD_FOR_WIN)
+        VirtualFree(fMemory, 0, MEM_RELEASE);
+#else
+        munmap(fMemory, fSize);
+#endif
+    }
+}
+
+NativeCodeBuilder::NativeCodeBuilder(const std::byte* base, const float* uniforms, int stride)
+        : fBase(base)
+        , fUniforms(uniforms)
+        , fStride(stride)
+        , fSlotSize(stride * sizeof(float)) {}
+
+void NativeCodeBuilder::appendStage(ProgramOp op, const void* ctx) {
+    if (fStride % 4 == 0 && this->emitStage(op, ctx)) {
+        if (fRunLength == 0) {
+            fRunFirstStage = fNumStages;
+        }
+        ++fRunLength;
+    } else {
+        this->endRun();
+    }
+    ++fNumStages;
+}
+
+void NativeCodeBuilder::endRun() {
+    if (fRunLength >= 2) {
+        // Close out the function. A single stage isn't worth a call of its own; those are left
+        // to the interpreter.
+        this->emitByte(0xC3);  // ret
+        fRuns.push_back({fRunFirstStage, fRunLength, nullptr});
+        fRunOffsets.push_back(fRunCodeStart);
+    } else {
+        fCode.resize(fRunCodeStart);
+    }
+    fRunLength = 0;
+    fRunCodeStart = fCode.size();
+}
+
+std::unique_ptr<NativeCode> NativeCodeBuilder::finish() {
+    this->endRun();
+    if (fRuns.empty()) {
+        return nullptr;
+    }
+
+    const size_t size = fCode.size();
+#if defined(SK_BUILD_FOR_WIN)
+    void* memory = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (!memory) {
+        return nullptr;
+    }
+    memcpy(memory, fCode.data(), size);
+    DWORD oldProtection;
+    if (!VirtualProtect(memory, size, PAGE_EXECUTE_READ, &oldProtection)) {
+        VirtualFree(memory, 0, MEM_RELEASE);
+        return nullptr;
+    }
+    FlushInstructionCache(GetCurrentProcess(), memory, size);
+#else
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+    memcpy(memory, fCode.data(), size);
+    // Platforms that enforce W^X for JIT code (e.g. a hardened macOS runtime) will refuse this;
+    // those keep using the interpreter.
+    if (mprotect(memory, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(memory, size);
+        return nullptr;
+    }
+#endif
+
+    std::unique_ptr<NativeCode> code(new NativeCode);
+    code->fMemory = memory;
+    code->fSize = size;
+    code->fNumStages = fNumStages;
+    code->fRuns = std::move(fRuns);
+    for (int index = 0; index < code->fRuns.size(); ++index) {
+        code->fRuns[index].fFn =
+                reinterpret_cast<NativeCode::Fn>(static_cast<uint8_t*>(memory) +
+                                                 fRunOffsets[index]);
+    }
+    return code;
+}
+
+bool NativeCodeBuilder::offsetFromBase(const void* ptr, int32_t* offset) const {
+    int64_t delta = static_cast<const std::byte*>(ptr) - fBase;
+    if (delta < 0 || delta > kMaxOffset) {
+        return false;
+    }
+    *offset = static_cast<int32_t>(delta);
+    return true;
+}
+
+bool NativeCodeBuilder::offsetFromUniforms(const void* ptr, int32_t* offset) const {
+    int64_t delta = static_cast<const float*>(ptr) - fUniforms;
+    if (!fUniforms || delta < 0 || delta > kMaxOffset / (int64_t)sizeof(float)) {
+        return false;
+    }
+    *offset = static_cast<int32_t>(delta * sizeof(float));
+    return true;
+}
+
+void NativeCodeBuilder::emitBytes(std::initializer_list<uint8_t> bytes) {
+    for (uint8_t byte : bytes) {
+        this->emitByte(byte);
+    }
+}
+
+void NativeCodeBuilder::emitInt32(int32_t value) {
+    uint32_t bits = static_cast<uint32_t>(value);
+    for (int shift = 0; shift < 32; shift += 8) {
+        this->emitByte(static_cast<uint8_t>(bits >> shift));
+    }
+}
+
+void NativeCodeBuilder::emitMemoryOp(std::initializer_list<uint8_t> opcode,
+                                     int xmm, int reg, int32_t offset) {
+    // ModRM with a 32-bit displacement. None of our address registers need a SIB byte.
+    this->emitBytes(opcode);
+    this->emitByte(0x80 | (xmm << 3) | reg);
+    this->emitInt32(offset);
+}
+
+void NativeCodeBuilder::emitRegisterOp(std::initializer_list<uint8_t> opcode, int dst, int src) {
+    this->emitBytes(opcode);
+    this->emitByte(0xC0 | (dst << 3) | src);
+}
+
+void NativeCodeBuilder::emitLoad(int xmm, int32_t offset) {
+    this->emitMemoryOp({0x0F, 0x10}, xmm, kBaseReg, offset);  // movups xmm, [base + offset]
+}
+
+void NativeCodeBuilder::emitStore(int xmm, int32_t offset) {
+    this->emitMemoryOp({0x0F, 0x11}, xmm, kBaseReg, offset);  // movups [base + offset], xmm
+}
+
+void NativeCodeBuilder::emitBroadcastConstant(int xmm, int32_t value) {
+    if (value == 0) {
+        this->emitRegisterOp({0x66, 0x0F, 0xEF}, xmm, xmm);   // pxor xmm, xmm
+        return;
+    }
+    this->emitByte(0xB8 + kRax);                              // mov eax, value
+    this->emitInt32(value);
+    this->emitRegisterOp({0x66, 0x0F, 0x6E}, xmm, kRax);      // movd xmm, eax
+    this->emitRegisterOp({0x66, 0x0F, 0x70}, xmm, xmm);       // pshufd xmm, xmm, 0
+    this->emitByte(0x00);
+}
+
+void NativeCodeBuilder::emitBroadcastScalar(int xmm, int reg, int32_t offset) {
+    this->emitMemoryOp({0x66, 0x0F, 0x6E}, xmm, reg, offset); // movd xmm, [reg + offset]
+    this->emitRegisterOp({0x66, 0x0F, 0x70}, xmm, xmm);       // pshufd xmm, xmm, 0
+    this->emitByte(0x00);
+}
+
+bool NativeCodeBuilder::emitStage(ProgramOp op, const void* ctx) {
+    using namespace SkRasterPipelineContexts;
+
+    const int bytesPerSlot = fSlotSize;
+    auto storeChunks = [&](int xmm, int32_t dst, int numSlots) {
+        for (int chunk = 0; chunk < numSlots * bytesPerSlot; chunk += kChunkSize) {
+            this->emitStore(xmm, dst + chunk);
+        }
+    };
+
+    switch (op) {
+        case ProgramOp::copy_constant:
+        case ProgramOp::splat_2_constants:
+        case ProgramOp::splat_3_constants:
+        case ProgramOp::splat_4_constants: {
+            auto packed = SkRPCtxUtils::Unpack(static_cast<const ConstantCtx*>(ctx));
+            if (packed.dst > kMaxOffset) {
+                return false;
+            }
+            int numSlots = (int)op - (int)ProgramOp::copy_constant + 1;
+            this->emitBroadcastConstant(kXmm0, packed.value);
+            storeChunks(kXmm0, packed.dst, numSlots);
+            return true;
+        }
+        case ProgramOp::copy_slot_unmasked:
+        case ProgramOp::copy_2_slots_unmasked:
+        case ProgramOp::copy_3_slots_unmasked:
+        case ProgramOp::copy_4_slots_unmasked: {
+            auto packed = SkRPCtxUtils::Unpack(static_cast<const BinaryOpCtx*>(ctx));
+            if (packed.dst > kMaxOffset || packed.src > kMaxOffset) {
+                return false;
+            }
+            int numSlots = (int)op - (int)ProgramOp::copy_slot_unmasked + 1;
+            for (int chunk = 0; chunk < numSlots * bytesPerSlot; chunk += kChunkSize) {
+                this->emitLoad(kXmm0, packed.src + chunk);
+                this->emitStore(kXmm0, packed.dst + chunk);
+            }
+            return true;
+        }
+        case ProgramOp::copy_immutable_unmasked:
+        case ProgramOp::copy_2_immutables_unmasked:
+        case ProgramOp::copy_3_immutables_unmasked:
+        case ProgramOp::copy_4_immutables_unmasked: {
+            // Immutables are stored as scalars, and broadcast into every lane of the destination.
+            auto packed = SkRPCtxUtils::Unpack(static_cast<const BinaryOpCtx*>(ctx));
+            if (packed.dst > kMaxOffset || packed.src > kMaxOffset) {
+                return false;
+            }
+            int numSlots = (int)op - (int)ProgramOp::copy_immutable_unmasked + 1;
+            for (int slot = 0; slot < numSlots; ++slot) {
+                this->emitBroadcastScalar(kXmm0, kBaseReg, packed.src + slot * sizeof(float));
+                storeChunks(kXmm0, packed.dst + slot * bytesPerSlot, 1);
+            }
+            return true;
+        }
+        case ProgramOp::copy_uniform:
+        case ProgramOp::copy_2_uniforms:
+        case ProgramOp::copy_3_uniforms:
+        case ProgramOp::copy_4_uniforms: {
+            auto uniformCtx = static_cast<const UniformCtx*>(ctx);
+            int32_t dst, src;
+            if (!this->offsetFromBase(uniformCtx->dst, &dst) ||
+                !this->offsetFromUniforms(uniformCtx->src, &src)) {
+                return false;
+            }
+            int numSlots = (int)op - (int)ProgramOp::copy_uniform + 1;
+            for (int slot = 0; slot < numSlots; ++slot) {
+                this->emitBroadcastScalar(kXmm0, kUniformReg, src + slot * sizeof(float));
+                storeChunks(kXmm0, dst + slot * bytesPerSlot, 1);
+            }
+            return true;
+        }
+        default:
+            break;
+    }
+
+    BinaryOpInfo info;
+    if (!binary_op_info(op, &info)) {
+        return false;
+    }
+
+    int32_t dst = 0, src = 0;
+    int numSlots = info.numSlots;
+    switch (info.form) {
+        case Form::kImmediate: {
+            auto packed = SkRPCtxUtils::Unpack(static_cast<const ConstantCtx*>(ctx));
+            if (packed.dst > kMaxOffset) {
+                return false;
+            }
+            dst = packed.dst;
+            this->emitBroadcastConstant(kXmm1, packed.value);
+            break;
+        }
+        case Form::kAdjacent:
+            if (!this->offsetFromBase(ctx, &dst)) {
+                return false;
+            }
+            src = dst + numSlots * bytesPerSlot;
+            break;
+
+        case Form::kAdjacentPacked: {
+            auto packed = SkRPCtxUtils::Unpack(static_cast<const BinaryOpCtx*>(ctx));
+            if (packed.dst > kMaxOffset || packed.src > kMaxOffset || packed.src <= packed.dst) {
+                return false;
+            }
+            dst = packed.dst;
+            src = packed.src;
+            numSlots = (src - dst) / bytesPerSlot;
+            break;
+        }
+    }
+
+    for (int chunk = 0; chunk < numSlots * bytesPerSlot; chunk += kChunkSize) {
+        this->emitLoad(kXmm0, dst + chunk);
+        if (info.form != Form::kImmediate) {
+            this->emitLoad(kXmm1, src + chunk);
+        }
+        switch (info.kernel) {
+            case Kernel::kAddFloat:   this->emitRegisterOp({0x0F, 0x58}, kXmm0, kXmm1); break;
+            case Kernel::kSubFloat:   this->emitRegisterOp({0x0F, 0x5C}, kXmm0, kXmm1); break;
+            case Kernel::kMulFloat:   this->emitRegisterOp({0x0F, 0x59}, kXmm0, kXmm1); break;
+            case Kernel::kDivFloat:   this->emitRegisterOp({0x0F, 0x5E}, kXmm0, kXmm1); break;
+            case Kernel::kMinFloat:   this->emitRegisterOp({0x0F, 0x5D}, kXmm0, kXmm1); break;
+            case Kernel::kMaxFloat:   this->emitRegisterOp({0x0F, 0x5F}, kXmm0, kXmm1); break;
+
+            // cmpps takes its predicate as an immediate: 0 = eq, 1 = lt, 2 = le, 4 = neq.
+            case Kernel::kCmpLtFloat: this->emitRegisterOp({0x0F, 0xC2}, kXmm0, kXmm1);
+                                      this->emitByte(0x01);
+                                      break;
+            case Kernel::kCmpLeFloat: this->emitRegisterOp({0x0F, 0xC2}, kXmm0, kXmm1);
+                                      this->emitByte(0x02);
+                                      break;
+            case Kernel::kCmpEqFloat: this->emitRegisterOp({0x0F, 0xC2}, kXmm0, kXmm1);
+                                      this->emitByte(0x00);
+                                      break;
+            case Kernel::kCmpNeFloat: this->emitRegisterOp({0x0F, 0xC2}, kXmm0, kXmm1);
+                                      this->emitByte(0x04);
+                                      break;
+
+            case Kernel::kAddInt:     this->emitRegisterOp({0x66, 0x0F, 0xFE}, kXmm0, kXmm1); break;
+            case Kernel::kSubInt:     this->emitRegisterOp({0x66, 0x0F, 0xFA}, kXmm0, kXmm1); break;
+            case Kernel::kBitwiseAnd: this->emitRegisterOp({0x66, 0x0F, 0xDB}, kXmm0, kXmm1); break;
+            case Kernel::kBitwiseOr:  this->emitRegisterOp({0x66, 0x0F, 0xEB}, kXmm0, kXmm1); break;
+            case Kernel::kBitwiseXor: this->emitRegisterOp({0x66, 0x0F, 0xEF}, kXmm0, kXmm1); break;
+            case Kernel::kCmpEqInt:   this->emitRegisterOp({0x66, 0x0F, 0x76}, kXmm0, kXmm1); break;
+
+            // SSE2 only has pcmpgtd, so the other comparisons are built from it and pcmpeqd.
+            case Kernel::kCmpLtInt:   // xmm0 = xmm1 > xmm0
+                this->emitRegisterOp({0x0F, 0x28}, kXmm2, kXmm1);        // movaps xmm2, xmm1
+                this->emitRegisterOp({0x66, 0x0F, 0x66}, kXmm2, kXmm0);  // pcmpgtd xmm2, xmm0
+                this->emitRegisterOp({0x0F, 0x28}, kXmm0, kXmm2);        // movaps xmm0, xmm2
+                break;
+            case Kernel::kCmpLeInt:   // xmm0 = ~(xmm0 > xmm1)
+                this->emitRegisterOp({0x66, 0x0F, 0x66}, kXmm0, kXmm1);  // pcmpgtd xmm0, xmm1
+                this->emitRegisterOp({0x66, 0x0F, 0x76}, kXmm2, kXmm2);  // pcmpeqd xmm2, xmm2
+                this->emitRegisterOp({0x66, 0x0F, 0xEF}, kXmm0, kXmm2);  // pxor xmm0, xmm2
+                break;
+            case Kernel::kCmpNeInt:   // xmm0 = ~(xmm0 == xmm1)
+                this->emitRegisterOp({0x66, 0x0F, 0x76}, kXmm0, kXmm1);  // pcmpeqd xmm0, xmm1
+                this->emitRegisterOp({0x66, 0x0F, 0x76}, kXmm2, kXmm2);  // pcmpeqd xmm2, xmm2
+                this->emitRegisterOp({0x66, 0x0F, 0xEF}, kXmm0, kXmm2);  // pxor xmm0, xmm2
+                break;
+        }
+        this->emitStore(kXmm0, dst + chunk);
+    }
+    return true;
+}
+
+}  // namespace RP
+}  // namespace SkSL
+
+#endif  // SKSL_RP_JIT
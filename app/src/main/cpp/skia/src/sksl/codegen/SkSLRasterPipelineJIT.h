@@ -0,0 +1,133 @@
+/*
+ * Copyright 2026 Google LLC
+ *
+ * Use of this source code is governed by a BSD-style license that can be
+ * found in the LICENSE file.
+ */
+
+#ifndef SKSL_RASTERPIPELINEJIT
+#define SKSL_RASTERPIPELINEJIT
+
+#include "include/core/SkSpan.h"
+#include "include/core/SkTypes.h"
+#include "include/private/base/SkTArray.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+
+// The JIT emits SSE2 code for x86-64 and maps it into executable memory at runtime, which not
+// every embedder permits. It is off unless the build defines SK_ENABLE_SKSL_RP_JIT; elsewhere,
+// SkSL always runs through the interpreter.
+#if defined(SK_ENABLE_SKSL_RP_JIT) && !defined(SKSL_STANDALONE) &&   \
+    (defined(__x86_64__) || defined(_M_X64)) &&                       \
+    (defined(SK_BUILD_FOR_UNIX) || defined(SK_BUILD_FOR_ANDROID) ||   \
+     defined(SK_BUILD_FOR_MAC) || defined(SK_BUILD_FOR_WIN))
+    #define SKSL_RP_JIT 1
+#endif
+
+#if defined(SKSL_RP_JIT)
+
+namespace SkSL {
+namespace RP {
+
+enum class ProgramOp;
+
+/**
+ * Machine code for the parts of an RP::Program that only shuffle and combine slot values. Each
+ * run of consecutive stages that NativeCodeBuilder could compile becomes a single function, which
+ * is invoked by one `native_code` stage in place of the original stages. This removes the stage
+ * dispatch and context unpacking between the ops, which dominates the cost of these small ops.
+ */
+class NativeCode {
+public:
+    using Fn = void (*)(std::byte* base, const float* uniforms);
+
+    struct Run {
+        int fFirstStage;
+        int fNumStages;
+        Fn  fFn;
+    };
+
+    ~NativeCode();
+
+    // Runs are sorted by their first stage and never overlap.
+    SkSpan<const Run> runs() const { return fRuns; }
+
+    // The number of stages in the program that this code was compiled from.
+    int numStages() const { return fNumStages; }
+
+private:
+    friend class NativeCodeBuilder;
+    NativeCode() = default;
+
+    void* fMemory = nullptr;
+    size_t fSize = 0;
+    int fNumStages = 0;
+    skia_private::TArray<Run> fRuns;
+};
+
+class NativeCodeBuilder {
+public:
+    /**
+     * `base` and `uniforms` are the slot and uniform pointers that the stage contexts were built
+     * with. The generated code only depends on offsets from them, so it can be invoked with any
+     * other slot or uniform data of the same layout. `stride` is the number of lanes per slot.
+     */
+    NativeCodeBuilder(const std::byte* base, const float* uniforms, int stride);
+
+    /**
+     * Offers the next stage of the program. Stages that can be compiled are fused with their
+     * compilable neighbors; any other stage ends the current run and is left to the interpreter.
+     */
+    void appendStage(ProgramOp op, const void* ctx);
+
+    /**
+     * Maps the generated code into executable memory. Returns null if no stages could be fused,
+     * or if the platform refuses to give us executable memory.
+     */
+    std::unique_ptr<NativeCode> finish();
+
+private:
+    bool emitStage(ProgramOp op, const void* ctx);
+    void endRun();
+
+    // Slot values are addressed as a 32-bit displacement from a base register.
+    bool offsetFromBase(const void* ptr, int32_t* offset) const;
+    bool offsetFromUniforms(const void* ptr, int32_t* offset) const;
+
+    void emitByte(uint8_t byte) { fCode.push_back(byte); }
+    void emitBytes(std::initializer_list<uint8_t> bytes);
+    void emitInt32(int32_t value);
+
+    // Emits `op xmm, [reg + offset]` (or the reverse, for stores).
+    void emitMemoryOp(std::initializer_list<uint8_t> opcode, int xmm, int reg, int32_t offset);
+    // Emits `op dst, src` for two xmm registers.
+    void emitRegisterOp(std::initializer_list<uint8_t> opcode, int dst, int src);
+
+    void emitLoad(int xmm, int32_t offset);
+    void emitStore(int xmm, int32_t offset);
+    void emitBroadcastConstant(int xmm, int32_t value);
+    void emitBroadcastScalar(int xmm, int reg, int32_t offset);
+
+    const std::byte* fBase;
+    const float* fUniforms;
+    int fStride;
+    int fSlotSize;
+
+    skia_private::TArray<uint8_t> fCode;
+    skia_private::TArray<NativeCode::Run> fRuns;
+    skia_private::TArray<int> fRunOffsets;  // [run index] = code offset of the run's entry point
+    int fNumStages = 0;
+    int fRunFirstStage = 0;
+    int fRunLength = 0;
+    int fRunCodeStart = 0;
+};
+
+}  // namespace RP
+}  // namespace SkSL
+
+#endif  // SKSL_RP_JIT
+
+#endif  // SKSL_RASTERPIPELINEJIT